@@ -0,0 +1,149 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+// Roughly simulates many tiles being parsed at once: a large number of actors,
+// each receiving a stream of small messages that have to be processed in order.
+constexpr std::size_t actorCount = 128;
+constexpr std::size_t messageCount = 256;
+
+struct Worker {
+    Worker(ActorRef<Worker>, std::atomic<std::size_t>& remaining_)
+        : remaining(remaining_) {
+    }
+
+    void receive(std::size_t value) {
+        // A little bit of work so that we don't measure queue operations only.
+        for (std::size_t i = 0; i < 64; ++i) {
+            sum += value * i;
+        }
+        benchmark::DoNotOptimize(sum);
+        --remaining;
+    }
+
+    std::atomic<std::size_t>& remaining;
+    std::size_t sum = 0;
+};
+
+} // namespace
+
+static void Actor_Throughput(benchmark::State& state) {
+    ThreadPool pool(state.range(0));
+
+    std::atomic<std::size_t> remaining { 0 };
+    std::vector<std::unique_ptr<Actor<Worker>>> actors;
+    for (std::size_t i = 0; i < actorCount; ++i) {
+        actors.emplace_back(std::make_unique<Actor<Worker>>(pool, std::ref(remaining)));
+    }
+
+    while (state.KeepRunning()) {
+        remaining = actorCount * messageCount;
+        for (std::size_t message = 0; message < messageCount; ++message) {
+            for (auto& actor : actors) {
+                actor->self().invoke(&Worker::receive, message);
+            }
+        }
+
+        while (remaining > 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * actorCount * messageCount);
+}
+
+static void Actor_ThroughputChained(benchmark::State& state) {
+    // Every message is forwarded from one worker actor to the next, which
+    // exercises scheduling from within the pool's own threads.
+    struct Relay {
+        Relay(ActorRef<Relay>, std::atomic<std::size_t>& remaining_)
+            : remaining(remaining_) {
+        }
+
+        void receive(std::size_t hops, ActorRef<Relay> next) {
+            --remaining;
+            if (hops > 0) {
+                next.invoke(&Relay::receive, hops - 1, next);
+            }
+        }
+
+        std::atomic<std::size_t>& remaining;
+    };
+
+    constexpr std::size_t hops = 16;
+
+    ThreadPool pool(state.range(0));
+
+    std::atomic<std::size_t> remaining { 0 };
+    std::vector<std::unique_ptr<Actor<Relay>>> actors;
+    for (std::size_t i = 0; i < actorCount; ++i) {
+        actors.emplace_back(std::make_unique<Actor<Relay>>(pool, std::ref(remaining)));
+    }
+
+    while (state.KeepRunning()) {
+        remaining = actorCount * messageCount * (hops + 1);
+        for (std::size_t message = 0; message < messageCount; ++message) {
+            for (std::size_t i = 0; i < actorCount; ++i) {
+                actors[i]->self().invoke(&Relay::receive, hops, actors[(i + 1) % actorCount]->self());
+            }
+        }
+
+        while (remaining > 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * actorCount * messageCount * (hops + 1));
+}
+
+static void Actor_InvokeRoundTrip(benchmark::State& state) {
+    // Two actors bouncing a message back and forth through ActorRef::invoke, similar to the
+    // glyph and image dependency traffic between GeometryTile and GeometryTileWorker.
+    struct Player {
+        Player(ActorRef<Player>, std::atomic<bool>& done_)
+            : done(done_) {
+        }
+
+        void receive(std::size_t remaining, ActorRef<Player> other, ActorRef<Player> self) {
+            if (remaining == 0) {
+                done = true;
+            } else {
+                other.invoke(&Player::receive, remaining - 1, self, other);
+            }
+        }
+
+        std::atomic<bool>& done;
+    };
+
+    constexpr std::size_t roundTrips = 10000;
+
+    ThreadPool pool(state.range(0));
+
+    std::atomic<bool> done { false };
+    Actor<Player> ping(pool, std::ref(done));
+    Actor<Player> pong(pool, std::ref(done));
+
+    while (state.KeepRunning()) {
+        done = false;
+        ping.self().invoke(&Player::receive, roundTrips * 2, pong.self(), ping.self());
+        while (!done) {
+            std::this_thread::yield();
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * roundTrips);
+}
+
+BENCHMARK(Actor_Throughput)->RangeMultiplier(2)->Range(1, 32)->UseRealTime();
+BENCHMARK(Actor_ThroughputChained)->RangeMultiplier(2)->Range(1, 32)->UseRealTime();
+BENCHMARK(Actor_InvokeRoundTrip)->Arg(1)->Arg(2)->UseRealTime();
@@ -59,10 +59,65 @@ static void Evaluate_CompositeFunction(benchmark::State& state) {
     state.SetLabel(std::to_string(stopCount).c_str());
 }
 
+static std::vector<StubGeometryTileFeature> createFeatures(size_t count) {
+    std::vector<StubGeometryTileFeature> features;
+    features.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        features.emplace_back(PropertyMap { { "x", static_cast<int64_t>(rand() % 100) } });
+    }
+    return features;
+}
+
+// Evaluates the function for the features of a layer at both ends of a tile's zoom range, one
+// feature at a time.
+static void Evaluate_CompositeFunction_Features(benchmark::State& state) {
+    auto doc = createFunctionJSON(8);
+    conversion::Error error;
+    optional<CompositeFunction<float>> function = conversion::convertJSON<CompositeFunction<float>>(doc, error);
+    if (!function) {
+        state.SkipWithError(error.message.c_str());
+    }
+    const std::vector<StubGeometryTileFeature> features = createFeatures(state.range(0));
+
+    while (state.KeepRunning()) {
+        for (const auto& feature : features) {
+            benchmark::DoNotOptimize(function->evaluate({ 12.0f, 13.0f }, feature, -1.0f));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * features.size());
+}
+
+// Evaluates the function for the features of a layer at both ends of a tile's zoom range, all at
+// once.
+static void Evaluate_CompositeFunction_Batch(benchmark::State& state) {
+    auto doc = createFunctionJSON(8);
+    conversion::Error error;
+    optional<CompositeFunction<float>> function = conversion::convertJSON<CompositeFunction<float>>(doc, error);
+    if (!function) {
+        state.SkipWithError(error.message.c_str());
+    }
+    const std::vector<StubGeometryTileFeature> features = createFeatures(state.range(0));
+    std::vector<const GeometryTileFeature*> featurePointers;
+    for (const auto& feature : features) {
+        featurePointers.push_back(&feature);
+    }
+
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(function->evaluate({ 12.0f, 13.0f }, featurePointers, -1.0f));
+    }
+
+    state.SetItemsProcessed(state.iterations() * features.size());
+}
+
 BENCHMARK(Parse_CompositeFunction)
     ->Arg(1)->Arg(2)->Arg(4)->Arg(6)->Arg(8)->Arg(10)->Arg(12);
 
 BENCHMARK(Evaluate_CompositeFunction)
     ->Arg(1)->Arg(2)->Arg(4)->Arg(6)->Arg(8)->Arg(10)->Arg(12);
 
+BENCHMARK(Evaluate_CompositeFunction_Features)
+    ->Arg(100)->Arg(1000)->Arg(10000);
 
+BENCHMARK(Evaluate_CompositeFunction_Batch)
+    ->Arg(100)->Arg(1000)->Arg(10000);
@@ -5,6 +5,8 @@
 #include <mbgl/style/conversion/json.hpp>
 #include <mbgl/style/conversion/filter.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/util/io.hpp>
 #include <mbgl/benchmark/stub_geometry_tile_feature.hpp>
 
 using namespace mbgl;
@@ -30,5 +32,29 @@ static void Parse_EvaluateFilter(benchmark::State& state) {
     }
 }
 
+// Filters every feature of a vector tile, as parsing a tile does, with a filter that looks up
+// several properties of each feature.
+static void Parse_EvaluateFilter_VectorTile(benchmark::State& state) {
+    const style::Filter filter = parse(R"FILTER(["any", ["==", "class", "wood"], ["has", "name_en"], ["<", "scalerank", 3]])FILTER");
+    const VectorTileData tile(std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf")));
+    const std::vector<std::string> names = tile.layerNames();
+
+    while (state.KeepRunning()) {
+        std::size_t matches = 0;
+        for (const auto& name : names) {
+            auto layer = tile.getLayer(name);
+            const std::size_t count = layer->featureCount();
+            for (std::size_t i = 0; i < count; i++) {
+                auto feature = layer->getFeature(i);
+                if (filter(style::expression::EvaluationContext { 16, feature.get() })) {
+                    matches++;
+                }
+            }
+        }
+        benchmark::DoNotOptimize(matches);
+    }
+}
+
 BENCHMARK(Parse_Filter);
 BENCHMARK(Parse_EvaluateFilter);
+BENCHMARK(Parse_EvaluateFilter_VectorTile);
@@ -0,0 +1,85 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/storage/offline_database.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/io.hpp>
+
+#include <memory>
+#include <string>
+
+using namespace mbgl;
+
+namespace {
+
+constexpr const char* filename = "offline_database.benchmark.db";
+
+// Large enough that eviction never kicks in, so that we measure the cost of the statements and
+// transactions involved in get() and put() only.
+constexpr uint64_t maximumCacheSize = 1024 * 1024 * 1024;
+
+constexpr uint32_t tileCount = 1024;
+
+// Modes compared: the default rollback journal, the write-ahead log, and the write-ahead log
+// with puts batched into transactions of 64.
+std::unique_ptr<OfflineDatabase> openDatabase(const benchmark::State& state) {
+    try {
+        util::deleteFile(filename);
+    } catch (...) {
+    }
+
+    const bool writeAheadLog = state.range(0) > 0;
+    auto db = std::make_unique<OfflineDatabase>(filename, maximumCacheSize, writeAheadLog);
+    db->setAmbientBatchSize(state.range(0) > 1 ? 64 : 1);
+    return db;
+}
+
+Resource tileResource(uint32_t i) {
+    return Resource::tile("mapbox://tiles/{z}/{x}/{y}.vector.pbf", 1.0, i % 64, i / 64, 6,
+                          Tileset::Scheme::XYZ);
+}
+
+Response tileResponse() {
+    Response response;
+    response.data = std::make_shared<std::string>(16 * 1024, '\0');
+    return response;
+}
+
+} // namespace
+
+static void OfflineDatabase_Put(benchmark::State& state) {
+    auto db = openDatabase(state);
+    const Response response = tileResponse();
+
+    uint32_t i = 0;
+    while (state.KeepRunning()) {
+        db->put(tileResource(i++ % tileCount), response);
+    }
+    db->flush();
+
+    state.SetItemsProcessed(state.iterations());
+    db.reset();
+    util::deleteFile(filename);
+}
+
+static void OfflineDatabase_Get(benchmark::State& state) {
+    auto db = openDatabase(state);
+    const Response response = tileResponse();
+    for (uint32_t i = 0; i < tileCount; ++i) {
+        db->put(tileResource(i), response);
+    }
+    db->flush();
+
+    uint32_t i = 0;
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(db->get(tileResource(i++ % tileCount)));
+    }
+    db->flush();
+
+    state.SetItemsProcessed(state.iterations());
+    db.reset();
+    util::deleteFile(filename);
+}
+
+BENCHMARK(OfflineDatabase_Put)->Arg(0)->Arg(1)->Arg(2);
+BENCHMARK(OfflineDatabase_Get)->Arg(0)->Arg(1)->Arg(2);
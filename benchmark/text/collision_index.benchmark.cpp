@@ -0,0 +1,130 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/text/collision_index.hpp>
+#include <mbgl/layout/symbol_projection.hpp>
+#include <mbgl/map/transform.hpp>
+#include <mbgl/renderer/buckets/symbol_bucket.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/math.hpp>
+#include <mbgl/util/tile_cover.hpp>
+
+#include <cmath>
+#include <random>
+
+using namespace mbgl;
+
+namespace {
+
+StringTable strings;
+
+// A line label, as the symbol layout creates it for a street name.
+struct LineLabel {
+    LineLabel(GeometryCoordinates line_, int segment)
+        : line(std::move(line_)),
+          anchor(line[segment].x, line[segment].y, 0, 0.5f, segment),
+          feature(line, anchor, -12, 12, -60, 60, 1, 2, style::SymbolPlacementType::Line,
+                  IndexedSubfeature(0, strings.intern(""), strings.intern(""), 0), 1),
+          symbol(anchor.point, segment, 16, 16, {{ 0, 0 }}, WritingModeType::Horizontal, line, tileDistances()) {
+        for (float offset = -55; offset <= 55; offset += 10) {
+            symbol.glyphOffsets.push_back(offset);
+        }
+    }
+
+    std::vector<float> tileDistances() const {
+        std::vector<float> distances(line.size());
+        float sum = 0;
+        for (int i = anchor.segment; i >= 0; i--) {
+            sum += util::dist<float>(i == anchor.segment ? anchor.point : convertPoint<float>(line[i + 1]), line[i]);
+            distances[i] = sum;
+        }
+        sum = 0;
+        for (std::size_t i = anchor.segment + 1; i < line.size(); i++) {
+            sum += util::dist<float>(i == std::size_t(anchor.segment + 1) ? anchor.point : convertPoint<float>(line[i - 1]), line[i]);
+            distances[i] = sum;
+        }
+        return distances;
+    }
+
+    GeometryCoordinates line;
+    Anchor anchor;
+    CollisionFeature feature;
+    PlacedSymbol symbol;
+};
+
+// The tiles that cover a 1024x768 viewport at z14 with the given pitch, each with the same
+// number of random line labels.
+struct Scene {
+    Scene(double pitch, std::size_t labelsPerTile) {
+        Transform transform;
+        transform.resize({ 1024, 768 });
+        transform.setLatLngZoom({ 0, 0 }, 14);
+        transform.setPitch(pitch * util::DEG2RAD);
+        state = transform.getState();
+
+        mat4 projMatrix;
+        state.getProjMatrix(projMatrix);
+
+        std::mt19937 generator(0);
+        std::uniform_int_distribution<int16_t> position(0, util::EXTENT);
+        std::uniform_real_distribution<double> direction(0, 2 * M_PI);
+        std::uniform_real_distribution<double> turn(-0.3, 0.3);
+
+        for (const auto& id : util::tileCover(state, 14)) {
+            Tile tile;
+            state.matrixFor(tile.posMatrix, id);
+            matrix::multiply(tile.posMatrix, projMatrix, tile.posMatrix);
+            tile.pixelsToTileUnits = id.pixelsToTileUnits(1, state.getZoom());
+            tile.labelPlaneMatrix = getLabelPlaneMatrix(tile.posMatrix, false, true, state, tile.pixelsToTileUnits);
+            tile.scale = std::pow(2, state.getZoom() - id.canonical.z);
+
+            for (std::size_t i = 0; i < labelsPerTile; ++i) {
+                GeometryCoordinates line;
+                GeometryCoordinate point { position(generator), position(generator) };
+                double angle = direction(generator);
+                for (int j = 0; j < 16; ++j) {
+                    line.push_back(point);
+                    angle += turn(generator);
+                    point.x += static_cast<int16_t>(std::round(std::cos(angle) * 128));
+                    point.y += static_cast<int16_t>(std::round(std::sin(angle) * 128));
+                }
+                tile.labels.emplace_back(std::move(line), 8);
+            }
+            tiles.push_back(std::move(tile));
+        }
+    }
+
+    struct Tile {
+        mat4 posMatrix;
+        mat4 labelPlaneMatrix;
+        float pixelsToTileUnits;
+        float scale;
+        std::vector<LineLabel> labels;
+    };
+
+    TransformState state;
+    std::vector<Tile> tiles;
+};
+
+} // namespace
+
+static void CollisionIndex_LineLabels(benchmark::State& state) {
+    Scene scene(state.range(0), 500);
+    const float textPixelRatio = util::tileSize / util::EXTENT;
+
+    while (state.KeepRunning()) {
+        CollisionIndex collisionIndex(scene.state);
+        std::size_t placed = 0;
+        for (auto& tile : scene.tiles) {
+            for (auto& label : tile.labels) {
+                if (collisionIndex.placeFeature(label.feature, tile.posMatrix, tile.labelPlaneMatrix, textPixelRatio,
+                                                label.symbol, tile.scale, 16, false, false, false).first) {
+                    collisionIndex.insertFeature(label.feature, false, 0);
+                    placed++;
+                }
+            }
+        }
+        benchmark::DoNotOptimize(placed);
+    }
+}
+
+BENCHMARK(CollisionIndex_LineLabels)->Arg(0)->Arg(45)->Arg(60);
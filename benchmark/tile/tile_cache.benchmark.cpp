@@ -0,0 +1,94 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/tile/tile_cache.hpp>
+#include <mbgl/tile/tile.hpp>
+#include <mbgl/map/transform.hpp>
+#include <mbgl/util/tile_cover.hpp>
+
+#include <cmath>
+#include <map>
+#include <memory>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+class StubTile : public Tile {
+public:
+    StubTile(const OverscaledTileID& id_) : Tile(id_) {
+        renderable = true;
+    }
+
+    void upload(gl::Context&) override {}
+    Bucket* getBucket(const style::Layer::Impl&) const override { return nullptr; }
+};
+
+using Frame = std::vector<OverscaledTileID>;
+
+// Ideal tiles of a high resolution viewport that pans across a city while zooming in and out,
+// similar to what TilePyramid::update sees during interaction.
+std::vector<Frame> panZoomTrace() {
+    Transform transform;
+    transform.resize({ 2560, 1600 });
+
+    std::vector<Frame> frames;
+    for (std::size_t i = 0; i < 600; ++i) {
+        transform.setLatLng({ 37.7 + 0.0005 * i, -122.5 + 0.001 * i });
+        transform.setZoom(14 + 2 * std::sin(i / 40.0));
+
+        const int32_t z = std::floor(transform.getZoom());
+        Frame frame;
+        for (const auto& id : util::tileCover(transform.getState(), z)) {
+            frame.emplace_back(id.overscaleTo(z));
+        }
+        frames.push_back(std::move(frame));
+    }
+    return frames;
+}
+
+} // namespace
+
+static void TileCache_PanZoomTrace(benchmark::State& state) {
+    static const std::vector<Frame> frames = panZoomTrace();
+
+    std::size_t hits = 0;
+    std::size_t lookups = 0;
+
+    while (state.KeepRunning()) {
+        TileCache cache(state.range(0));
+        std::map<OverscaledTileID, std::unique_ptr<Tile>> tiles;
+
+        for (const auto& frame : frames) {
+            std::map<OverscaledTileID, std::unique_ptr<Tile>> retained;
+            for (const auto& id : frame) {
+                auto it = tiles.find(id);
+                if (it != tiles.end()) {
+                    retained.emplace(id, std::move(it->second));
+                    tiles.erase(it);
+                    continue;
+                }
+
+                ++lookups;
+                std::unique_ptr<Tile> tile = cache.pop(id);
+                if (tile) {
+                    ++hits;
+                } else {
+                    tile = std::make_unique<StubTile>(id);
+                }
+                retained.emplace(id, std::move(tile));
+            }
+
+            // Everything that is no longer in view goes to the cache.
+            for (auto& entry : tiles) {
+                cache.add(entry.first, std::move(entry.second));
+            }
+            tiles = std::move(retained);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * frames.size());
+    state.SetLabel(std::to_string(lookups ? 100 * hits / lookups : 0) + "% hits");
+}
+
+BENCHMARK(TileCache_PanZoomTrace)->RangeMultiplier(4)->Range(64, 4096);
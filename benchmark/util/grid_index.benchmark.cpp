@@ -0,0 +1,106 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/util/grid_index.hpp>
+#include <mbgl/geometry/feature_index.hpp>
+
+#include <cmath>
+#include <random>
+
+using namespace mbgl;
+
+using Grid = GridIndex<IndexedSubfeature>;
+
+namespace {
+
+// A collision grid the size of a 1024x768 viewport with the padding and cell size of CollisionIndex.
+const float gridWidth = 1024 + 2 * 100;
+const float gridHeight = 768 + 2 * 100;
+const int16_t gridCellSize = 25;
+
+// Label sized boxes, and chains of small circles along a line, like line labels.
+struct Labels {
+    explicit Labels(std::size_t count) {
+        std::mt19937 generator(0);
+        std::uniform_real_distribution<float> x(0, gridWidth);
+        std::uniform_real_distribution<float> y(0, gridHeight);
+        std::uniform_real_distribution<float> labelWidth(20, 120);
+        std::uniform_real_distribution<float> labelHeight(12, 24);
+        std::uniform_real_distribution<float> angle(0, 2 * M_PI);
+
+        for (std::size_t i = 0; i < count; ++i) {
+            const float x1 = x(generator);
+            const float y1 = y(generator);
+            boxes.push_back({ { x1, y1 }, { x1 + labelWidth(generator), y1 + labelHeight(generator) } });
+
+            const float cx = x(generator);
+            const float cy = y(generator);
+            const float a = angle(generator);
+            std::vector<Grid::BCircle> line;
+            for (int j = 0; j < 8; ++j) {
+                line.push_back({ { cx + std::cos(a) * j * 10, cy + std::sin(a) * j * 10 }, 6 });
+            }
+            circles.push_back(std::move(line));
+        }
+    }
+
+    std::vector<Grid::BBox> boxes;
+    std::vector<std::vector<Grid::BCircle>> circles;
+};
+
+IndexedSubfeature feature(std::size_t index) {
+    static StringTable strings;
+    static const InternedString sourceLayerName = strings.intern("source-layer");
+    static const InternedString bucketLeaderID = strings.intern("bucket");
+    return { index, sourceLayerName, bucketLeaderID, index };
+}
+
+} // namespace
+
+// Places labels the way Placement does: each label is only inserted if it doesn't hit any of
+// the labels placed before it.
+static void GridIndex_Placement(benchmark::State& state) {
+    const Labels labels(state.range(0));
+
+    while (state.KeepRunning()) {
+        Grid grid(gridWidth, gridHeight, gridCellSize);
+        for (std::size_t i = 0; i < labels.boxes.size(); ++i) {
+            if (!grid.hitTest(labels.boxes[i])) {
+                grid.insert(feature(i), Grid::BBox(labels.boxes[i]));
+            }
+
+            bool hit = false;
+            for (const auto& circle : labels.circles[i]) {
+                hit = hit || grid.hitTest(circle);
+            }
+            if (!hit) {
+                for (const auto& circle : labels.circles[i]) {
+                    grid.insert(feature(i), Grid::BCircle(circle));
+                }
+            }
+        }
+    }
+}
+
+// Queries a fully built grid, like FeatureIndex and queryRenderedSymbols do.
+static void GridIndex_Query(benchmark::State& state) {
+    const Labels labels(state.range(0));
+
+    Grid grid(gridWidth, gridHeight, gridCellSize);
+    for (std::size_t i = 0; i < labels.boxes.size(); ++i) {
+        grid.insert(feature(i), Grid::BBox(labels.boxes[i]));
+        for (const auto& circle : labels.circles[i]) {
+            grid.insert(feature(i), Grid::BCircle(circle));
+        }
+    }
+
+    std::size_t results = 0;
+    while (state.KeepRunning()) {
+        for (const auto& box : labels.boxes) {
+            results += grid.query(box).size();
+        }
+    }
+    benchmark::DoNotOptimize(results);
+}
+
+BENCHMARK(GridIndex_Placement)->Arg(1000)->Arg(10000);
+BENCHMARK(GridIndex_Query)->Arg(1000)->Arg(10000);
@@ -357,6 +357,7 @@ set(MBGL_CORE_FILES
     src/mbgl/storage/resource.cpp
     src/mbgl/storage/resource_transform.cpp
     src/mbgl/storage/response.cpp
+    src/mbgl/storage/tile_archive_file_source.hpp
 
     # style
     include/mbgl/style/color_ramp_property_value.hpp
@@ -613,12 +614,18 @@ set(MBGL_CORE_FILES
     src/mbgl/text/language_tag.cpp
     src/mbgl/text/language_tag.hpp
     src/mbgl/text/local_glyph_rasterizer.hpp
+    src/mbgl/text/pauseable_placement.cpp
+    src/mbgl/text/pauseable_placement.hpp
     src/mbgl/text/placement.cpp
     src/mbgl/text/placement.hpp
     src/mbgl/text/quads.cpp
     src/mbgl/text/quads.hpp
     src/mbgl/text/shaping.cpp
     src/mbgl/text/shaping.hpp
+    src/mbgl/text/shaping_cache.cpp
+    src/mbgl/text/shaping_cache.hpp
+    src/mbgl/text/shared_glyph_atlas.cpp
+    src/mbgl/text/shared_glyph_atlas.hpp
 
     # tile
     include/mbgl/tile/tile_id.hpp
@@ -651,6 +658,7 @@ set(MBGL_CORE_FILES
     src/mbgl/tile/tile_loader.hpp
     src/mbgl/tile/tile_loader_impl.hpp
     src/mbgl/tile/tile_observer.hpp
+    src/mbgl/tile/tile_priority.hpp
     src/mbgl/tile/vector_tile.cpp
     src/mbgl/tile/vector_tile.hpp
     src/mbgl/tile/vector_tile_data.cpp
@@ -659,6 +667,7 @@ set(MBGL_CORE_FILES
     # util
     include/mbgl/util/async_request.hpp
     include/mbgl/util/async_task.hpp
+    include/mbgl/util/blob.hpp
     include/mbgl/util/char_array_buffer.hpp
     include/mbgl/util/chrono.hpp
     include/mbgl/util/color.hpp
@@ -701,6 +710,8 @@ set(MBGL_CORE_FILES
     include/mbgl/util/work_request.hpp
     include/mbgl/util/work_task.hpp
     include/mbgl/util/work_task_impl.hpp
+    src/mbgl/util/blob.cpp
+    src/mbgl/util/cancellation_token.hpp
     src/mbgl/util/chrono.cpp
     src/mbgl/util/clip_id.cpp
     src/mbgl/util/clip_id.hpp
@@ -722,6 +733,8 @@ set(MBGL_CORE_FILES
     src/mbgl/util/http_timeout.hpp
     src/mbgl/util/i18n.cpp
     src/mbgl/util/i18n.hpp
+    src/mbgl/util/interned_string.cpp
+    src/mbgl/util/interned_string.hpp
     src/mbgl/util/interpolate.cpp
     src/mbgl/util/intersection_tests.cpp
     src/mbgl/util/intersection_tests.hpp
@@ -731,6 +744,7 @@ set(MBGL_CORE_FILES
     src/mbgl/util/longest_common_subsequence.hpp
     src/mbgl/util/mapbox.cpp
     src/mbgl/util/mapbox.hpp
+    src/mbgl/util/mapped_file.hpp
     src/mbgl/util/mat2.cpp
     src/mbgl/util/mat2.hpp
     src/mbgl/util/mat3.cpp
@@ -738,8 +752,11 @@ set(MBGL_CORE_FILES
     src/mbgl/util/mat4.cpp
     src/mbgl/util/mat4.hpp
     src/mbgl/util/math.hpp
+    src/mbgl/util/memory_usage.hpp
     src/mbgl/util/offscreen_texture.cpp
     src/mbgl/util/offscreen_texture.hpp
+    src/mbgl/util/parallel_for.cpp
+    src/mbgl/util/parallel_for.hpp
     src/mbgl/util/premultiply.cpp
     src/mbgl/util/rapidjson.hpp
     src/mbgl/util/rect.hpp
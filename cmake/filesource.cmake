@@ -11,6 +11,8 @@ add_library(mbgl-filesource STATIC
     platform/default/asset_file_source.cpp
     src/mbgl/storage/local_file_source.hpp
     platform/default/local_file_source.cpp
+    src/mbgl/storage/tile_archive_file_source.hpp
+    platform/default/tile_archive_file_source.cpp
 
     # Offline
     include/mbgl/storage/offline.hpp
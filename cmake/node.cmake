@@ -46,6 +46,12 @@ target_sources(mbgl-node INTERFACE
     ${CMAKE_CURRENT_SOURCE_DIR}/platform/node/src/node_expression.hpp
     ${CMAKE_CURRENT_SOURCE_DIR}/platform/node/src/node_expression.cpp
     ${CMAKE_CURRENT_SOURCE_DIR}/platform/node/src/util/async_queue.hpp
+
+    # Local tile archives are read natively instead of through the request callback.
+    ${CMAKE_CURRENT_SOURCE_DIR}/platform/default/file_source_request.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/platform/default/mapped_file.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/platform/default/sqlite3.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/platform/default/tile_archive_file_source.cpp
 )
 
 target_include_directories(mbgl-node INTERFACE
@@ -58,6 +64,7 @@ target_link_libraries(mbgl-node INTERFACE
 )
 
 target_add_mason_package(mbgl-node INTERFACE geojson)
+target_add_mason_package(mbgl-node INTERFACE rapidjson)
 
 add_custom_target(mbgl-node.active DEPENDS mbgl-node.abi-${NodeJS_ABI})
 
@@ -4,6 +4,7 @@ set(MBGL_TEST_FILES
     # actor
     test/actor/actor.test.cpp
     test/actor/actor_ref.test.cpp
+    test/actor/mailbox.test.cpp
 
     # algorithm
     test/algorithm/covered_by_children.test.cpp
@@ -64,6 +65,7 @@ set(MBGL_TEST_FILES
     test/storage/online_file_source.test.cpp
     test/storage/resource.test.cpp
     test/storage/sqlite.test.cpp
+    test/storage/tile_archive_file_source.test.cpp
 
     # style
     test/style/filter.test.cpp
@@ -117,7 +119,10 @@ set(MBGL_TEST_FILES
     test/text/glyph_pbf.test.cpp
     test/text/language_tag.test.cpp
     test/text/local_glyph_rasterizer.test.cpp
+    test/text/placement.test.cpp
     test/text/quads.test.cpp
+    test/text/shaping_cache.test.cpp
+    test/text/shared_glyph_atlas.test.cpp
 
     # tile
     test/tile/custom_geometry_tile.test.cpp
@@ -125,22 +130,28 @@ set(MBGL_TEST_FILES
     test/tile/geometry_tile_data.test.cpp
     test/tile/raster_dem_tile.test.cpp
     test/tile/raster_tile.test.cpp
+    test/tile/tile_cache.test.cpp
     test/tile/tile_coordinate.test.cpp
     test/tile/tile_id.test.cpp
     test/tile/vector_tile.test.cpp
 
     # util
     test/util/async_task.test.cpp
+    test/util/blob.test.cpp
+    test/util/cancellation_token.test.cpp
+    test/util/compression.test.cpp
     test/util/dtoa.test.cpp
     test/util/geo.test.cpp
     test/util/grid_index.test.cpp
     test/util/http_timeout.test.cpp
     test/util/image.test.cpp
+    test/util/interned_string.test.cpp
     test/util/mapbox.test.cpp
     test/util/memory.test.cpp
     test/util/merge_lines.test.cpp
     test/util/number_conversions.test.cpp
     test/util/offscreen_texture.test.cpp
+    test/util/parallel_for.test.cpp
     test/util/position.test.cpp
     test/util/projection.test.cpp
     test/util/run_loop.test.cpp
@@ -61,6 +61,11 @@ public:
         return parent.self();
     }
 
+    // See Mailbox::setPriority().
+    void setPriority(Mailbox::Priority priority) {
+        parent.mailbox->setPriority(priority);
+    }
+
 private:
     AspiringActor<Object> parent;
     EstablishedActor<Object> target;
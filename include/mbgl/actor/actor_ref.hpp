@@ -31,7 +31,7 @@ public:
     template <typename Fn, class... Args>
     void invoke(Fn fn, Args&&... args) {
         if (auto mailbox = weakMailbox.lock()) {
-            mailbox->push(actor::makeMessage(*object, fn, std::forward<Args>(args)...));
+            mailbox->push(actor::makeMessage(*mailbox, *object, fn, std::forward<Args>(args)...));
         }
     }
 
@@ -46,7 +46,7 @@ public:
         if (auto mailbox = weakMailbox.lock()) {
             mailbox->push(
                     actor::makeMessage(
-                            std::move(promise), *object, fn, std::forward<Args>(args)...
+                            *mailbox, std::move(promise), *object, fn, std::forward<Args>(args)...
                     )
             );
         } else {
@@ -1,10 +1,9 @@
 #pragma once
 
-#include <mbgl/util/optional.hpp>
-
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <mutex>
-#include <queue>
 
 namespace mbgl {
 
@@ -13,15 +12,17 @@ class Message;
 
 class Mailbox : public std::enable_shared_from_this<Mailbox> {
 public:
-   
+
     // Create a "holding" mailbox, messages to which will remain queued,
     // unconsumed, until the mailbox is associated with a Scheduler using
     // start(). This allows a Mailbox object to be created on one thread and
     // later transferred to a different target thread that may not yet exist.
     Mailbox();
-    
+
     Mailbox(Scheduler&);
 
+    ~Mailbox();
+
     // Attach the given scheduler to this mailbox and begin processing messages
     // sent to it. The mailbox must be a "holding" mailbox, as created by the
     // default constructor Mailbox().
@@ -30,21 +31,59 @@ public:
 
     bool isOpen() const;
 
+    // Schedulers that support it (e.g. ThreadPool) receive mailboxes with a
+    // lower priority value first. Defaults to 0, the most urgent priority. The
+    // priority is sampled whenever the mailbox is scheduled, so changes apply
+    // from the next message onwards; it never reorders messages within a mailbox.
+    using Priority = uint32_t;
+    void setPriority(Priority);
+    Priority getPriority() const;
+
     void push(std::unique_ptr<Message>);
     void receive();
 
     static void maybeReceive(std::weak_ptr<Mailbox>);
 
 private:
-    optional<Scheduler*> scheduler;
+    friend class Message;
+
+    void enqueue(Message*);
+    Message* dequeue();
+
+    // Take a node from, or return one to, the pool of message nodes. Both fail instead of
+    // waiting while another thread is using the pool.
+    void* takeNode();
+    bool recycleNode(void*);
+
+    std::atomic<Scheduler*> scheduler { nullptr };
 
     std::recursive_mutex receivingMutex;
-    std::mutex pushingMutex;
 
-    bool closed { false };
+    // Number of push() calls in progress. close() waits for them to finish.
+    std::atomic<std::size_t> pushing { 0 };
+    std::atomic<bool> closed { false };
+
+    // Intrusive multi-producer/single-consumer queue of messages (after Dmitry Vyukov). Producers
+    // only swap `head`; `tail` is owned by whichever thread holds the receiving mutex.
+    std::unique_ptr<Message> stub;
+    std::atomic<Message*> head;
+    Message* tail;
+
+    // Number of messages pushed but not yet received. Its transition from zero to one is what
+    // triggers scheduling, so the queue itself never needs to be locked to check for emptiness.
+    std::atomic<std::size_t> queued { 0 };
+
+    std::atomic<Priority> priority { 0 };
 
-    std::mutex queueMutex;
-    std::queue<std::unique_ptr<Message>> queue;
+    // Nodes of received messages, kept for the messages pushed later. Producers take nodes and
+    // the receiving thread returns them, so the pool is guarded by a flag that is only ever
+    // tried; whoever finds it taken uses the heap instead.
+    struct PooledNode {
+        PooledNode* next;
+    };
+    std::atomic_flag poolLock = ATOMIC_FLAG_INIT;
+    PooledNode* pool = nullptr;
+    std::size_t poolSize = 0;
 };
 
 } // namespace mbgl
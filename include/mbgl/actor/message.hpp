@@ -2,11 +2,16 @@
 
 #include <mbgl/util/optional.hpp>
 
+#include <atomic>
+#include <cstddef>
 #include <future>
+#include <memory>
 #include <utility>
 
 namespace mbgl {
 
+class Mailbox;
+
 // A movable type-erasing function wrapper. This allows to store arbitrary invokable
 // things (like std::function<>, or the result of a movable-only std::bind()) in the queue.
 // Source: http://stackoverflow.com/a/29642072/331379
@@ -14,6 +19,19 @@ class Message {
 public:
     virtual ~Message() = default;
     virtual void operator()() = 0;
+
+    // Messages allocated for a mailbox reuse the nodes of earlier messages that mailbox has
+    // received, if they fit. Deleting a message returns its node to the mailbox it was allocated
+    // for, which must still exist, or to the heap.
+    static void* operator new(std::size_t);
+    static void* operator new(std::size_t, Mailbox&);
+    static void operator delete(void*);
+    static void operator delete(void*, Mailbox&);
+
+private:
+    // Messages are the nodes of their Mailbox's intrusive queue.
+    std::atomic<Message*> next { nullptr };
+    friend class Mailbox;
 };
 
 template <class Object, class MemberFn, class ArgsTuple>
@@ -92,16 +110,17 @@ public:
 
 namespace actor {
 
+// The message must be pushed to the given mailbox, which it's allocated for.
 template <class Object, class MemberFn, class... Args>
-std::unique_ptr<Message> makeMessage(Object& object, MemberFn memberFn, Args&&... args) {
+std::unique_ptr<Message> makeMessage(Mailbox& mailbox, Object& object, MemberFn memberFn, Args&&... args) {
     auto tuple = std::make_tuple(std::forward<Args>(args)...);
-    return std::make_unique<MessageImpl<Object, MemberFn, decltype(tuple)>>(object, memberFn, std::move(tuple));
+    return std::unique_ptr<Message>(new (mailbox) MessageImpl<Object, MemberFn, decltype(tuple)>(object, memberFn, std::move(tuple)));
 }
 
 template <class ResultType, class Object, class MemberFn, class... Args>
-std::unique_ptr<Message> makeMessage(std::promise<ResultType>&& promise, Object& object, MemberFn memberFn, Args&&... args) {
+std::unique_ptr<Message> makeMessage(Mailbox& mailbox, std::promise<ResultType>&& promise, Object& object, MemberFn memberFn, Args&&... args) {
     auto tuple = std::make_tuple(std::forward<Args>(args)...);
-    return std::make_unique<AskMessageImpl<ResultType, Object, MemberFn, decltype(tuple)>>(std::move(promise), object, memberFn, std::move(tuple));
+    return std::unique_ptr<Message>(new (mailbox) AskMessageImpl<ResultType, Object, MemberFn, decltype(tuple)>(std::move(promise), object, memberFn, std::move(tuple)));
 }
 
 } // namespace actor
@@ -19,7 +19,9 @@ class Mailbox;
         concurrency within a mailbox
 
       Subject to these constraints, processing can happen on whatever thread in the
-      pool is available.
+      pool is available. Each worker thread has its own queue; idle workers steal
+      mailboxes from the queues of busy ones. Mailboxes with a lower
+      `Mailbox::getPriority()` value are received first.
 
     * `Scheduler::GetCurrent()` is typically used to create a mailbox and `ActorRef`
       for an object that lives on the main thread and is not itself wrapped an
@@ -161,6 +161,15 @@ public:
     void setPrefetchZoomDelta(uint8_t delta);
     uint8_t getPrefetchZoomDelta() const;
 
+    // Tile cache
+    //
+    // Tiles that go out of view are kept in a cache for a while in case they're needed again.
+    // This limits the number of bytes that cached tiles may occupy in client and GPU memory
+    // combined, shared evenly between all sources. By default, the cache is only bounded by
+    // the number of tiles it holds, which depends on the viewport size.
+    void setMaximumTileCacheSize(uint64_t bytes);
+    uint64_t getMaximumTileCacheSize() const;
+
     // Debug
     void setDebug(MapDebugOptions);
     void cycleDebugOptions();
@@ -3,8 +3,10 @@
 #include <mbgl/renderer/query.hpp>
 #include <mbgl/renderer/mode.hpp>
 #include <mbgl/annotation/annotation.hpp>
+#include <mbgl/util/chrono.hpp>
 #include <mbgl/util/geo.hpp>
 #include <mbgl/util/geo.hpp>
+#include <mbgl/util/optional.hpp>
 
 #include <functional>
 #include <memory>
@@ -50,6 +52,12 @@ public:
     // Memory
     void reduceMemoryUse();
 
+    // Placement
+    // Limits the time spent placing symbols in each frame of a continuous map. Placing all symbols
+    // may then take several frames, during which the previous placement is shown. By default,
+    // all symbols are placed within a single frame.
+    void setPlacementBudget(optional<Duration>);
+
 private:
     class Impl;
     std::unique_ptr<Impl> impl;
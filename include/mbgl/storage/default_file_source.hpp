@@ -25,13 +25,18 @@ public:
      * There is no size limit for offline resources. If a user never creates any offline
      * regions, we want the database to remain fairly small (order tens or low hundreds
      * of megabytes).
+     *
+     * With writeAheadLog, the database uses SQLite's WAL journal, which makes
+     * commits cheaper at the cost of possibly losing the most recent ones in a crash.
      */
     DefaultFileSource(const std::string& cachePath,
                       const std::string& assetRoot,
-                      uint64_t maximumCacheSize = util::DEFAULT_MAX_CACHE_SIZE);
+                      uint64_t maximumCacheSize = util::DEFAULT_MAX_CACHE_SIZE,
+                      bool writeAheadLog = false);
     DefaultFileSource(const std::string& cachePath,
                       std::unique_ptr<FileSource>&& assetFileSource,
-                      uint64_t maximumCacheSize = util::DEFAULT_MAX_CACHE_SIZE);
+                      uint64_t maximumCacheSize = util::DEFAULT_MAX_CACHE_SIZE,
+                      bool writeAheadLog = false);
     ~DefaultFileSource() override;
 
     bool supportsCacheOnlyRequests() const override {
@@ -123,6 +128,13 @@ public:
      */
     void setOfflineMapboxTileCountLimit(uint64_t) const;
 
+    /*
+     * Group up to this many cached responses into a single database transaction.
+     * Defaults to 1, i.e. every response is committed right away. An open batch
+     * is committed at the latest one second after the response that opened it.
+     */
+    void setAmbientBatchSize(std::size_t) const;
+
     /*
      * Pause file request activity.
      *
@@ -94,11 +94,17 @@ public:
                        typename Signature::Args args_) :
         CompoundExpressionBase(name_, signature_),
         signature(signature_),
-        args(std::move(args_))
+        args(std::move(args_)),
+        constants(signature.bindConstants(args))
     {}
     
     EvaluationResult evaluate(const EvaluationContext& evaluationParams) const override {
-        return signature.apply(evaluationParams, args);
+        return signature.apply(evaluationParams, args, constants);
+    }
+
+    std::vector<EvaluationResult> evaluateBatch(const EvaluationContext& evaluationParams,
+                                                const std::vector<const GeometryTileFeature*>& features) const override {
+        return signature.applyBatch(evaluationParams, features, args, constants);
     }
     
     void eachChild(const std::function<void(const Expression&)>& visit) const override {
@@ -121,6 +127,8 @@ public:
 private:
     Signature signature;
     typename Signature::Args args;
+    // The arguments that are literals, already converted to their parameter types.
+    typename Signature::Constants constants;
 };
 
 /*
@@ -129,6 +129,15 @@ public:
     
     EvaluationResult evaluate(optional<float> zoom, const Feature& feature, optional<double> heatmapDensity) const;
 
+    /**
+     * Evaluate the expression for each of the given features, with the zoom and heatmap density
+     * of `params`. Expressions override this to evaluate their children for all of the features
+     * at once, so that the expression tree is walked once per batch rather than once per feature.
+     * The default implementation evaluates the features one at a time.
+     */
+    virtual std::vector<EvaluationResult> evaluateBatch(const EvaluationContext& params,
+                                                        const std::vector<const GeometryTileFeature*>& features) const;
+
     /**
      * Statically analyze the expression, attempting to enumerate possible outputs. Returns
      * an array of values plus the sentinel null optional value, used to indicate that the
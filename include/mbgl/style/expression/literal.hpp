@@ -25,6 +25,11 @@ public:
     EvaluationResult evaluate(const EvaluationContext&) const override {
         return value;
     }
+
+    std::vector<EvaluationResult> evaluateBatch(const EvaluationContext&,
+                                                const std::vector<const GeometryTileFeature*>& features) const override {
+        return std::vector<EvaluationResult>(features.size(), EvaluationResult(value));
+    }
     
     static ParseResult parse(const mbgl::style::conversion::Convertible&, ParsingContext&);
 
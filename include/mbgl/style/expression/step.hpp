@@ -20,6 +20,8 @@ public:
          std::map<double, std::unique_ptr<Expression>> stops_);
 
     EvaluationResult evaluate(const EvaluationContext& params) const override;
+    std::vector<EvaluationResult> evaluateBatch(const EvaluationContext& params,
+                                                const std::vector<const GeometryTileFeature*>& features) const override;
     void eachChild(const std::function<void(const Expression&)>& visit) const override;
     void eachStop(const std::function<void(double, const Expression&)>& visit) const;
 
@@ -36,6 +38,8 @@ public:
     std::string getOperator() const override { return "step"; }
 
 private:
+    EvaluationResult evaluateStops(const EvaluationContext& params, const EvaluationResult& evaluatedInput) const;
+
     const std::unique_ptr<Expression> input;
     const std::map<double, std::unique_ptr<Expression>> stops;
 };
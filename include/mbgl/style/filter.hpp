@@ -11,6 +11,27 @@
 
 namespace mbgl {
 namespace style {
+
+/*
+    A condition that all features passing a filter meet, taken from the filter's
+    comparisons of the geometry type or of a property with literal values. Tile
+    layers use it to skip the features that can't pass the filter without
+    reading them.
+*/
+class FilterPredicate {
+public:
+    // The geometry types that may pass, if the filter restricts them.
+    optional<std::vector<FeatureType>> types;
+
+    // A property that passing features have, and the values of it that may pass, if the
+    // filter restricts them.
+    optional<std::string> key;
+    optional<std::vector<expression::Value>> values;
+
+    bool empty() const {
+        return !types && !key;
+    }
+};
     
 class Filter {
 public:
@@ -18,12 +39,14 @@ public:
     
     Filter() : expression() {}
     
-    Filter(expression::ParseResult _expression) : expression(std::move(*_expression)) {
-        assert(!expression || *expression != nullptr);
-    }
+    Filter(expression::ParseResult _expression);
     
     bool operator()(const expression::EvaluationContext& context) const;
 
+    const FilterPredicate& getPredicate() const {
+        return predicate;
+    }
+
     friend bool operator==(const Filter& lhs, const Filter& rhs) {
         if (!lhs.expression || !rhs.expression) {
             return lhs.expression == rhs.expression;
@@ -35,6 +58,11 @@ public:
     friend bool operator!=(const Filter& lhs, const Filter& rhs) {
         return !(lhs == rhs);
     }
+
+private:
+    // Both are derived from the expression when the filter is created.
+    optional<bool> constant;
+    FilterPredicate predicate;
 };
 
 } // namespace style
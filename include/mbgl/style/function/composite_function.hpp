@@ -33,14 +33,28 @@ public:
         };
     }
 
+    // Evaluates the function for all of the given features at once, at each of the zoom levels in zoomRange
+    std::vector<Range<T>> evaluate(const Range<float>& zoomRange,
+                                   const std::vector<const GeometryTileFeature*>& features,
+                                   T finalDefaultValue) const {
+        const std::vector<expression::EvaluationResult> min =
+            expression->evaluateBatch(expression::EvaluationContext(zoomRange.min, nullptr), features);
+        const std::vector<expression::EvaluationResult> max =
+            expression->evaluateBatch(expression::EvaluationContext(zoomRange.max, nullptr), features);
+        std::vector<Range<T>> ranges;
+        ranges.reserve(features.size());
+        for (std::size_t i = 0; i < features.size(); ++i) {
+            ranges.push_back(Range<T> {
+                typedResult(min[i], finalDefaultValue),
+                typedResult(max[i], finalDefaultValue)
+            });
+        }
+        return ranges;
+    }
+
     template <class Feature>
     T evaluate(float zoom, const Feature& feature, T finalDefaultValue) const {
-        const expression::EvaluationResult result = expression->evaluate(expression::EvaluationContext({zoom}, &feature));
-        if (result) {
-            const optional<T> typed = expression::fromExpressionValue<T>(*result);
-            return typed ? *typed : defaultValue ? *defaultValue : finalDefaultValue;
-        }
-        return defaultValue ? *defaultValue : finalDefaultValue;
+        return typedResult(expression->evaluate(expression::EvaluationContext({zoom}, &feature)), finalDefaultValue);
     }
     
     float interpolationFactor(const Range<float>& inputLevels, const float inputValue) const {
@@ -73,6 +87,14 @@ public:
     bool isExpression;
     
 private:
+    T typedResult(const expression::EvaluationResult& result, const T& finalDefaultValue) const {
+        if (result) {
+            const optional<T> typed = expression::fromExpressionValue<T>(*result);
+            return typed ? *typed : defaultValue ? *defaultValue : finalDefaultValue;
+        }
+        return defaultValue ? *defaultValue : finalDefaultValue;
+    }
+
     std::shared_ptr<const expression::Expression> expression;
     optional<T> defaultValue;
     const variant<const expression::Interpolate*, const expression::Step*> zoomCurve;
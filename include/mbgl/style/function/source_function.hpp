@@ -21,12 +21,19 @@ public:
     
     template <class Feature>
     T evaluate(const Feature& feature, T finalDefaultValue) const {
-        const expression::EvaluationResult result = expression->evaluate(expression::EvaluationContext(&feature));
-        if (result) {
-            const optional<T> typed = expression::fromExpressionValue<T>(*result);
-            return typed ? *typed : defaultValue ? *defaultValue : finalDefaultValue;
+        return typedResult(expression->evaluate(expression::EvaluationContext(&feature)), finalDefaultValue);
+    }
+
+    // Evaluates the function for all of the given features at once.
+    std::vector<T> evaluate(const std::vector<const GeometryTileFeature*>& features, T finalDefaultValue) const {
+        const std::vector<expression::EvaluationResult> results =
+            expression->evaluateBatch(expression::EvaluationContext(nullptr), features);
+        std::vector<T> values;
+        values.reserve(results.size());
+        for (const auto& result : results) {
+            values.push_back(typedResult(result, finalDefaultValue));
         }
-        return defaultValue ? *defaultValue : finalDefaultValue;
+        return values;
     }
 
     std::vector<optional<T>> possibleOutputs() const {
@@ -44,6 +51,14 @@ public:
     const expression::Expression& getExpression() const { return *expression; }
 
 private:
+    T typedResult(const expression::EvaluationResult& result, const T& finalDefaultValue) const {
+        if (result) {
+            const optional<T> typed = expression::fromExpressionValue<T>(*result);
+            return typed ? *typed : defaultValue ? *defaultValue : finalDefaultValue;
+        }
+        return defaultValue ? *defaultValue : finalDefaultValue;
+    }
+
     std::shared_ptr<const expression::Expression> expression;
     optional<T> defaultValue;
 };
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace mbgl {
+
+/**
+ * `Blob` is a nullable shared reference to an immutable sequence of bytes, such as the payload of a
+ * `Response`. The bytes are either owned by a `std::string`, or by an arbitrary owner object, e.g.
+ * a memory mapped file or an arena, which stays alive for as long as a `Blob` refers to it. Copies
+ * share the bytes, so a `Blob` can be freely passed between threads without copying the payload.
+ *
+ * For compatibility with code written against the `std::shared_ptr<const std::string>` it replaces,
+ * a `Blob` can be constructed from one and dereferenced like one. Dereferencing a `Blob` that
+ * doesn't wrap a string creates a string copy of its bytes the first time, so consumers on hot
+ * paths, like the vector tile parser, should use `data()` and `size()` instead.
+ */
+class Blob {
+public:
+    Blob() = default;
+    Blob(std::nullptr_t) {}
+    Blob(std::shared_ptr<const std::string>);
+    Blob(std::shared_ptr<std::string>);
+
+    // Refers to `size` bytes at `data`, which must stay valid and unchanged for as long as
+    // `owner` is alive.
+    Blob(const char* data, std::size_t size, std::shared_ptr<const void> owner);
+
+    const char* data() const;
+    std::size_t size() const;
+
+    explicit operator bool() const { return bool(storage); }
+
+    // Returns the bytes as a string, sharing it if the Blob wraps one and copying the bytes
+    // otherwise. Returns nullptr for a null Blob.
+    std::shared_ptr<const std::string> string() const;
+
+    const std::string& operator*() const { return *string(); }
+    const std::string* operator->() const { return string().get(); }
+    const std::string* get() const { return storage ? string().get() : nullptr; }
+
+    // Blobs compare equal if they refer to the same bytes, like pointers.
+    friend bool operator==(const Blob& lhs, const Blob& rhs) { return lhs.storage == rhs.storage; }
+    friend bool operator!=(const Blob& lhs, const Blob& rhs) { return lhs.storage != rhs.storage; }
+    friend bool operator==(const Blob& lhs, std::nullptr_t) { return !lhs.storage; }
+    friend bool operator!=(const Blob& lhs, std::nullptr_t) { return bool(lhs.storage); }
+    friend bool operator==(std::nullptr_t, const Blob& rhs) { return !rhs.storage; }
+    friend bool operator!=(std::nullptr_t, const Blob& rhs) { return bool(rhs.storage); }
+
+private:
+    class Storage;
+    std::shared_ptr<Storage> storage;
+};
+
+} // namespace mbgl
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <mbgl/util/blob.hpp>
+
+#include <cstddef>
+#include <memory>
 #include <string>
 
 namespace mbgl {
@@ -8,5 +12,28 @@ namespace util {
 std::string compress(const std::string& raw);
 std::string decompress(const std::string& raw);
 
+// Inflates zlib or gzip compressed data. Unlike decompress(), it keeps its zlib stream between
+// calls, so that inflating many payloads, e.g. tiles, doesn't set up a new one for each of
+// them. Data is inflated straight into the storage of the returned Blob, which is sized up
+// front from the gzip trailer when there is one, and is never copied. Not thread safe: use
+// one per thread.
+class Decompressor {
+public:
+    Decompressor();
+    ~Decompressor();
+
+    Decompressor(const Decompressor&) = delete;
+    Decompressor& operator=(const Decompressor&) = delete;
+
+    Blob decompress(const char* data, std::size_t size);
+    Blob decompress(const std::string& raw) {
+        return decompress(raw.data(), raw.size());
+    }
+
+private:
+    class Stream;
+    std::unique_ptr<Stream> stream;
+};
+
 } // namespace util
 } // namespace mbgl
@@ -4,6 +4,7 @@
 #include <mbgl/util/unitbezier.hpp>
 
 #include <cmath>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -44,6 +45,9 @@ constexpr uint8_t DEFAULT_PREFETCH_ZOOM_DELTA = 4;
 
 constexpr uint64_t DEFAULT_MAX_CACHE_SIZE = 50 * 1024 * 1024;
 
+// Tile caches are only bounded by their tile count unless a byte limit is set.
+constexpr uint64_t DEFAULT_MAX_TILE_CACHE_SIZE = std::numeric_limits<uint64_t>::max();
+
 constexpr Duration DEFAULT_TRANSITION_DURATION = Milliseconds(300);
 constexpr Seconds CLOCK_SKEW_RETRY_TIMEOUT { 30 };
 
@@ -106,6 +106,7 @@ macro(mbgl_filesource)
         PRIVATE platform/android/src/asset_manager.hpp
         PRIVATE platform/android/src/asset_manager_file_source.cpp
         PRIVATE platform/android/src/asset_manager_file_source.hpp
+        PRIVATE platform/default/mapped_file.cpp
 
         # Database
         PRIVATE platform/default/sqlite3.cpp
@@ -6,10 +6,12 @@
 #include <mbgl/storage/offline_database.hpp>
 #include <mbgl/storage/offline_download.hpp>
 #include <mbgl/storage/resource_transform.hpp>
+#include <mbgl/storage/tile_archive_file_source.hpp>
 
 #include <mbgl/util/platform.hpp>
 #include <mbgl/util/url.hpp>
 #include <mbgl/util/thread.hpp>
+#include <mbgl/util/timer.hpp>
 #include <mbgl/util/work_request.hpp>
 #include <mbgl/util/stopwatch.hpp>
 
@@ -19,10 +21,12 @@ namespace mbgl {
 
 class DefaultFileSource::Impl {
 public:
-    Impl(std::shared_ptr<FileSource> assetFileSource_, std::string cachePath, uint64_t maximumCacheSize)
-            : assetFileSource(assetFileSource_)
+    Impl(ActorRef<Impl> self_, std::shared_ptr<FileSource> assetFileSource_, std::string cachePath, uint64_t maximumCacheSize, bool writeAheadLog)
+            : self(std::move(self_))
+            , assetFileSource(assetFileSource_)
             , localFileSource(std::make_unique<LocalFileSource>())
-            , offlineDatabase(std::make_unique<OfflineDatabase>(cachePath, maximumCacheSize)) {
+            , tileArchiveFileSource(std::make_unique<TileArchiveFileSource>())
+            , offlineDatabase(std::make_unique<OfflineDatabase>(cachePath, maximumCacheSize, writeAheadLog)) {
     }
 
     void setAPIBaseURL(const std::string& url) {
@@ -110,6 +114,9 @@ public:
         } else if (LocalFileSource::acceptsURL(resource.url)) {
             //Local file request
             tasks[req] = localFileSource->request(resource, callback);
+        } else if (TileArchiveFileSource::acceptsURL(resource.url)) {
+            //Tile archive request
+            tasks[req] = tileArchiveFileSource->request(resource, callback);
         } else {
             // Try the offline database
             if (resource.hasLoadingMethod(Resource::LoadingMethod::Cache)) {
@@ -150,6 +157,8 @@ public:
                 MBGL_TIMING_START(watch);
                 tasks[req] = onlineFileSource.request(resource, [=] (Response onlineResponse) mutable {
                     this->offlineDatabase->put(resource, onlineResponse);
+                    this->scheduleEviction();
+                    this->scheduleFlush();
                     if (resource.kind == Resource::Kind::Tile) {
                         // onlineResponse.data will be null if data not modified
                         MBGL_TIMING_FINISH(watch,
@@ -172,15 +181,54 @@ public:
         offlineDatabase->setOfflineMapboxTileCountLimit(limit);
     }
 
+    void setAmbientBatchSize(std::size_t size) {
+        ambientBatchSize = size;
+        offlineDatabase->setAmbientBatchSize(size);
+        if (ambientBatchSize <= 1) {
+            flushScheduled = false;
+            flushTimer.stop();
+        }
+    }
+
     void setOnlineStatus(const bool status) {
         onlineFileSource.setOnlineStatus(status);
     }
 
     void put(const Resource& resource, const Response& response) {
         offlineDatabase->put(resource, response);
+        scheduleEviction();
+        scheduleFlush();
+    }
+
+    void evict() {
+        evictionScheduled = false;
+        if (offlineDatabase->evictChunk()) {
+            scheduleEviction();
+        }
     }
 
 private:
+    // Evicts whatever put() left over one chunk at a time, with requests being
+    // served in between.
+    void scheduleEviction() {
+        if (!evictionScheduled && offlineDatabase->needsEviction()) {
+            evictionScheduled = true;
+            self.invoke(&Impl::evict);
+        }
+    }
+
+    // Commits the put() batch opened since the last flush even if it never
+    // fills up, so that a crash or an idle period doesn't leave it pending.
+    void scheduleFlush() {
+        if (ambientBatchSize > 1 && !flushScheduled) {
+            flushScheduled = true;
+            flushTimer.start(std::chrono::seconds(1), Duration::zero(), [this] {
+                flushScheduled = false;
+                offlineDatabase->flush();
+            });
+        }
+    }
+
     OfflineDownload& getDownload(int64_t regionID) {
         auto it = downloads.find(regionID);
         if (it != downloads.end()) {
@@ -190,9 +238,16 @@ private:
             std::make_unique<OfflineDownload>(regionID, offlineDatabase->getRegionDefinition(regionID), *offlineDatabase, onlineFileSource)).first->second;
     }
 
+    ActorRef<Impl> self;
+    bool evictionScheduled = false;
+    std::size_t ambientBatchSize = 1;
+    bool flushScheduled = false;
+    util::Timer flushTimer;
+
     // shared so that destruction is done on the creating thread
     const std::shared_ptr<FileSource> assetFileSource;
     const std::unique_ptr<FileSource> localFileSource;
+    const std::unique_ptr<FileSource> tileArchiveFileSource;
     std::unique_ptr<OfflineDatabase> offlineDatabase;
     OnlineFileSource onlineFileSource;
     std::unordered_map<AsyncRequest*, std::unique_ptr<AsyncRequest>> tasks;
@@ -201,15 +256,17 @@ private:
 
 DefaultFileSource::DefaultFileSource(const std::string& cachePath,
                                      const std::string& assetRoot,
-                                     uint64_t maximumCacheSize)
-    : DefaultFileSource(cachePath, std::make_unique<AssetFileSource>(assetRoot), maximumCacheSize) {
+                                     uint64_t maximumCacheSize,
+                                     bool writeAheadLog)
+    : DefaultFileSource(cachePath, std::make_unique<AssetFileSource>(assetRoot), maximumCacheSize, writeAheadLog) {
 }
 
 DefaultFileSource::DefaultFileSource(const std::string& cachePath,
                                      std::unique_ptr<FileSource>&& assetFileSource_,
-                                     uint64_t maximumCacheSize)
+                                     uint64_t maximumCacheSize,
+                                     bool writeAheadLog)
         : assetFileSource(std::move(assetFileSource_))
-        , impl(std::make_unique<util::Thread<Impl>>("DefaultFileSource", assetFileSource, cachePath, maximumCacheSize)) {
+        , impl(std::make_unique<util::Thread<Impl>>("DefaultFileSource", assetFileSource, cachePath, maximumCacheSize, writeAheadLog)) {
 }
 
 DefaultFileSource::~DefaultFileSource() = default;
@@ -292,6 +349,10 @@ void DefaultFileSource::setOfflineMapboxTileCountLimit(uint64_t limit) const {
     impl->actor().invoke(&Impl::setOfflineMapboxTileCountLimit, limit);
 }
 
+void DefaultFileSource::setAmbientBatchSize(std::size_t size) const {
+    impl->actor().invoke(&Impl::setAmbientBatchSize, size);
+}
+
 void DefaultFileSource::pause() {
     impl->pause();
 }
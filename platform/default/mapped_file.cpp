@@ -0,0 +1,69 @@
+#include <mbgl/util/mapped_file.hpp>
+#include <mbgl/util/io.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+
+namespace mbgl {
+namespace util {
+
+class MappedFile::Impl {
+public:
+    Impl(const std::string& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd == -1) {
+            throw IOException(errno, "failed to open file");
+        }
+
+        struct stat buf;
+        if (fstat(fd, &buf) == -1) {
+            const int err = errno;
+            ::close(fd);
+            throw IOException(err, "failed to stat file");
+        }
+
+        size = buf.st_size;
+        if (size > 0) {
+            void* address = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+            if (address == MAP_FAILED) {
+                const int err = errno;
+                ::close(fd);
+                throw IOException(err, "failed to map file");
+            }
+            data = static_cast<const char*>(address);
+        }
+
+        // The mapping stays valid after closing the descriptor.
+        ::close(fd);
+    }
+
+    ~Impl() {
+        if (data) {
+            munmap(const_cast<char*>(data), size);
+        }
+    }
+
+    const char* data = nullptr;
+    std::size_t size = 0;
+};
+
+MappedFile::MappedFile(const std::string& path)
+    : impl(std::make_unique<Impl>(path)) {
+}
+
+MappedFile::~MappedFile() = default;
+
+const char* MappedFile::data() const {
+    return impl->data;
+}
+
+std::size_t MappedFile::size() const {
+    return impl->size;
+}
+
+} // namespace util
+} // namespace mbgl
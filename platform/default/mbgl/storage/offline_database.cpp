@@ -10,9 +10,28 @@
 
 namespace mbgl {
 
-OfflineDatabase::OfflineDatabase(std::string path_, uint64_t maximumCacheSize_)
+namespace {
+
+// Number of deferred access times that triggers writing them out.
+constexpr std::size_t accessedBatchSize = 128;
+
+// Estimated storage per resource or tile on top of its data: the URL or tile
+// coordinates, the remaining columns, index entries and page fragmentation.
+constexpr uint64_t entryOverhead = 256;
+
+// Eviction deletes at most this many of the least-recently used resources, and
+// as many tiles, at a time.
+constexpr int64_t evictionChunkSize = 50;
+
+// Number of chunks put() evicts before leaving the rest to evictChunk().
+constexpr std::size_t evictionChunksPerPut = 4;
+
+} // namespace
+
+OfflineDatabase::OfflineDatabase(std::string path_, uint64_t maximumCacheSize_, bool writeAheadLog_)
     : path(std::move(path_)),
-      maximumCacheSize(maximumCacheSize_) {
+      maximumCacheSize(maximumCacheSize_),
+      writeAheadLog(writeAheadLog_) {
     ensureSchema();
 }
 
@@ -20,6 +39,13 @@ OfflineDatabase::~OfflineDatabase() {
     // Deleting these SQLite objects may result in exceptions, but we're in a destructor, so we
     // can't throw anything.
     try {
+        flush();
+    } catch (mapbox::sqlite::Exception& ex) {
+        Log::Error(Event::Database, (int)ex.code, ex.what());
+    }
+
+    try {
+        batch.reset();
         statements.clear();
         db.reset();
     } catch (mapbox::sqlite::Exception& ex) {
@@ -64,7 +90,11 @@ void OfflineDatabase::ensureSchema() {
             migrateToVersion6();
             // fall through
         case 6:
+            migrateToVersion7();
+            // fall through
+        case 7:
             // happy path; we're done
+            setJournalMode();
             return;
         default:
             // downgrade, delete the database
@@ -93,16 +123,27 @@ void OfflineDatabase::ensureSchema() {
         }
 
         db->exec("PRAGMA auto_vacuum = INCREMENTAL");
-        db->exec("PRAGMA journal_mode = DELETE");
-        db->exec("PRAGMA synchronous = FULL");
+        setJournalMode();
         db->exec(schema);
-        db->exec("PRAGMA user_version = 6");
+        db->exec("PRAGMA user_version = 7");
     } catch (...) {
         Log::Error(Event::Database, "Unexpected error creating database schema: %s", util::toString(std::current_exception()).c_str());
         throw;
     }
 }
 
+void OfflineDatabase::setJournalMode() {
+    // The journal mode is stored in the database file, so this also switches back from WAL when
+    // a database that used it is opened without. The synchronous setting is per connection.
+    if (writeAheadLog) {
+        db->exec("PRAGMA journal_mode = WAL");
+        db->exec("PRAGMA synchronous = NORMAL");
+    } else {
+        db->exec("PRAGMA journal_mode = DELETE");
+        db->exec("PRAGMA synchronous = FULL");
+    }
+}
+
 int OfflineDatabase::userVersion() {
     return static_cast<int>(getPragma<int64_t>("PRAGMA user_version"));
 }
@@ -151,6 +192,44 @@ void OfflineDatabase::migrateToVersion6() {
     transaction.commit();
 }
 
+void OfflineDatabase::migrateToVersion7() {
+    mapbox::sqlite::Transaction transaction(*db);
+
+    // clang-format off
+    db->exec(
+        "CREATE TABLE cache_usage ( "
+        "  id INTEGER NOT NULL PRIMARY KEY CHECK (id = 0), "
+        "  size INTEGER NOT NULL, "
+        "  count INTEGER NOT NULL "
+        "); "
+        "INSERT INTO cache_usage (id, size, count) "
+        "SELECT 0, "
+        "  (SELECT IFNULL(SUM(length(data)), 0) FROM resources) + (SELECT IFNULL(SUM(length(data)), 0) FROM tiles), "
+        "  (SELECT COUNT(*) FROM resources) + (SELECT COUNT(*) FROM tiles); "
+        "CREATE TRIGGER resources_insert_usage AFTER INSERT ON resources BEGIN "
+        "  UPDATE cache_usage SET size = size + IFNULL(length(NEW.data), 0), count = count + 1; "
+        "END; "
+        "CREATE TRIGGER resources_update_usage AFTER UPDATE OF data ON resources BEGIN "
+        "  UPDATE cache_usage SET size = size - IFNULL(length(OLD.data), 0) + IFNULL(length(NEW.data), 0); "
+        "END; "
+        "CREATE TRIGGER resources_delete_usage AFTER DELETE ON resources BEGIN "
+        "  UPDATE cache_usage SET size = size - IFNULL(length(OLD.data), 0), count = count - 1; "
+        "END; "
+        "CREATE TRIGGER tiles_insert_usage AFTER INSERT ON tiles BEGIN "
+        "  UPDATE cache_usage SET size = size + IFNULL(length(NEW.data), 0), count = count + 1; "
+        "END; "
+        "CREATE TRIGGER tiles_update_usage AFTER UPDATE OF data ON tiles BEGIN "
+        "  UPDATE cache_usage SET size = size - IFNULL(length(OLD.data), 0) + IFNULL(length(NEW.data), 0); "
+        "END; "
+        "CREATE TRIGGER tiles_delete_usage AFTER DELETE ON tiles BEGIN "
+        "  UPDATE cache_usage SET size = size - IFNULL(length(OLD.data), 0), count = count - 1; "
+        "END; ");
+    // clang-format on
+
+    db->exec("PRAGMA user_version = 7");
+    transaction.commit();
+}
+
 mapbox::sqlite::Statement& OfflineDatabase::getStatement(const char* sql) {
     auto it = statements.find(sql);
     if (it == statements.end()) {
@@ -183,17 +262,130 @@ optional<int64_t> OfflineDatabase::hasInternal(const Resource& resource) {
 }
 
 std::pair<bool, uint64_t> OfflineDatabase::put(const Resource& resource, const Response& response) {
-    mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
-    auto result = putInternal(resource, response, true);
-    transaction.commit();
+    if (ambientBatchSize <= 1) {
+        mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+        auto result = putInternal(resource, response, true);
+        transaction.commit();
+        return result;
+    }
+
+    if (!batch) {
+        batch = std::make_unique<mapbox::sqlite::Transaction>(*db, mapbox::sqlite::Transaction::Immediate);
+    }
+
+    std::pair<bool, uint64_t> result;
+    try {
+        result = putInternal(resource, response, true);
+    } catch (...) {
+        // Rolls back the whole batch; it's only ambient cache data.
+        batch.reset();
+        batchedPuts = 0;
+        throw;
+    }
+
+    if (++batchedPuts >= ambientBatchSize) {
+        commitBatch();
+    }
+
     return result;
 }
 
+void OfflineDatabase::setAmbientBatchSize(std::size_t size) {
+    ambientBatchSize = size;
+    if (batchedPuts >= ambientBatchSize) {
+        commitBatch();
+    }
+}
+
+void OfflineDatabase::commitBatch() {
+    if (batch) {
+        auto transaction = std::move(batch);
+        batchedPuts = 0;
+        transaction->commit();
+    }
+}
+
+void OfflineDatabase::flush() {
+    updateAccessed();
+    commitBatch();
+}
+
+void OfflineDatabase::markAccessed(const Resource& resource) {
+    accessedResources[resource.url] = util::now();
+    if (accessedResources.size() + accessedTiles.size() >= accessedBatchSize) {
+        updateAccessed();
+    }
+}
+
+void OfflineDatabase::markAccessed(const Resource::TileData& tile) {
+    accessedTiles[TileKey { tile.urlTemplate, tile.pixelRatio, tile.x, tile.y, tile.z }] = util::now();
+    if (accessedResources.size() + accessedTiles.size() >= accessedBatchSize) {
+        updateAccessed();
+    }
+}
+
+void OfflineDatabase::updateAccessed() {
+    if (accessedResources.empty() && accessedTiles.empty()) {
+        return;
+    }
+
+    // Joins the open put() batch, if there is one.
+    if (batch) {
+        writeAccessed();
+    } else {
+        mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+        writeAccessed();
+        transaction.commit();
+    }
+}
+
+void OfflineDatabase::writeAccessed() {
+    for (const auto& entry : accessedResources) {
+        mapbox::sqlite::Query accessedQuery{ getStatement("UPDATE resources SET accessed = ?1 WHERE url = ?2") };
+        accessedQuery.bind(1, entry.second);
+        accessedQuery.bind(2, entry.first);
+        accessedQuery.run();
+    }
+
+    for (const auto& entry : accessedTiles) {
+        // clang-format off
+        mapbox::sqlite::Query accessedQuery{ getStatement(
+            "UPDATE tiles "
+            "SET accessed       = ?1 "
+            "WHERE url_template = ?2 "
+            "  AND pixel_ratio  = ?3 "
+            "  AND x            = ?4 "
+            "  AND y            = ?5 "
+            "  AND z            = ?6 ") };
+        // clang-format on
+
+        accessedQuery.bind(1, entry.second);
+        accessedQuery.bind(2, std::get<0>(entry.first));
+        accessedQuery.bind(3, std::get<1>(entry.first));
+        accessedQuery.bind(4, std::get<2>(entry.first));
+        accessedQuery.bind(5, std::get<3>(entry.first));
+        accessedQuery.bind(6, std::get<4>(entry.first));
+        accessedQuery.run();
+    }
+
+    accessedResources.clear();
+    accessedTiles.clear();
+}
+
 std::pair<bool, uint64_t> OfflineDatabase::putInternal(const Resource& resource, const Response& response, bool evict_) {
     if (response.error) {
         return { false, 0 };
     }
 
+    // The write below sets a newer access time than any deferred one.
+    if (resource.kind == Resource::Kind::Tile) {
+        assert(resource.tileData);
+        const Resource::TileData& tile = *resource.tileData;
+        accessedTiles.erase(TileKey { tile.urlTemplate, tile.pixelRatio, tile.x, tile.y, tile.z });
+    } else {
+        accessedResources.erase(resource.url);
+    }
+
     std::string compressedData;
     bool compressed = false;
     uint64_t size = 0;
@@ -204,7 +396,7 @@ std::pair<bool, uint64_t> OfflineDatabase::putInternal(const Resource& resource,
         size = compressed ? compressedData.size() : response.data->size();
     }
 
-    if (evict_ && !evict(size)) {
+    if (evict_ && !evict(size, evictionChunksPerPut)) {
         Log::Info(Event::Database, "Unable to make space for entry");
         return { false, 0 };
     }
@@ -226,14 +418,6 @@ std::pair<bool, uint64_t> OfflineDatabase::putInternal(const Resource& resource,
 }
 
 optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resource& resource) {
-    // Update accessed timestamp used for LRU eviction.
-    {
-        mapbox::sqlite::Query accessedQuery{ getStatement("UPDATE resources SET accessed = ?1 WHERE url = ?2") };
-        accessedQuery.bind(1, util::now());
-        accessedQuery.bind(2, resource.url);
-        accessedQuery.run();
-    }
-
     // clang-format off
     mapbox::sqlite::Query query{ getStatement(
         //        0      1            2            3       4      5
@@ -248,6 +432,9 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resou
         return {};
     }
 
+    // Update accessed timestamp used for LRU eviction.
+    markAccessed(resource);
+
     Response response;
     uint64_t size = 0;
 
@@ -260,11 +447,11 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resou
     if (!data) {
         response.noContent = true;
     } else if (query.get<bool>(5)) {
-        response.data = std::make_shared<std::string>(util::decompress(*data));
+        response.data = decompressor.decompress(*data);
         size = data->length();
     } else {
-        response.data = std::make_shared<std::string>(*data);
         size = data->length();
+        response.data = std::make_shared<std::string>(std::move(*data));
     }
 
     return std::make_pair(response, size);
@@ -366,27 +553,6 @@ bool OfflineDatabase::putResource(const Resource& resource,
 }
 
 optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource::TileData& tile) {
-    {
-        // clang-format off
-        mapbox::sqlite::Query accessedQuery{ getStatement(
-            "UPDATE tiles "
-            "SET accessed       = ?1 "
-            "WHERE url_template = ?2 "
-            "  AND pixel_ratio  = ?3 "
-            "  AND x            = ?4 "
-            "  AND y            = ?5 "
-            "  AND z            = ?6 ") };
-        // clang-format on
-
-        accessedQuery.bind(1, util::now());
-        accessedQuery.bind(2, tile.urlTemplate);
-        accessedQuery.bind(3, tile.pixelRatio);
-        accessedQuery.bind(4, tile.x);
-        accessedQuery.bind(5, tile.y);
-        accessedQuery.bind(6, tile.z);
-        accessedQuery.run();
-    }
-
     // clang-format off
     mapbox::sqlite::Query query{ getStatement(
         //        0      1           2,            3,      4,      5
@@ -409,6 +575,9 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource:
         return {};
     }
 
+    // Update accessed timestamp used for LRU eviction.
+    markAccessed(tile);
+
     Response response;
     uint64_t size = 0;
 
@@ -421,11 +590,11 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource:
     if (!data) {
         response.noContent = true;
     } else if (query.get<bool>(5)) {
-        response.data = std::make_shared<std::string>(util::decompress(*data));
+        response.data = decompressor.decompress(*data);
         size = data->length();
     } else {
-        response.data = std::make_shared<std::string>(*data);
         size = data->length();
+        response.data = std::make_shared<std::string>(std::move(*data));
     }
 
     return std::make_pair(response, size);
@@ -576,6 +745,8 @@ std::vector<OfflineRegion> OfflineDatabase::listRegions() {
 
 OfflineRegion OfflineDatabase::createRegion(const OfflineRegionDefinition& definition,
                                             const OfflineRegionMetadata& metadata) {
+    commitBatch();
+
     // clang-format off
     mapbox::sqlite::Query query{ getStatement(
         "INSERT INTO regions (definition, description) "
@@ -590,6 +761,8 @@ OfflineRegion OfflineDatabase::createRegion(const OfflineRegionDefinition& defin
 }
 
 OfflineRegionMetadata OfflineDatabase::updateMetadata(const int64_t regionID, const OfflineRegionMetadata& metadata) {
+    commitBatch();
+
     // clang-format off
     mapbox::sqlite::Query query{ getStatement(
                                   "UPDATE regions SET description = ?1 "
@@ -603,6 +776,8 @@ OfflineRegionMetadata OfflineDatabase::updateMetadata(const int64_t regionID, co
 }
 
 void OfflineDatabase::deleteRegion(OfflineRegion&& region) {
+    commitBatch();
+
     {
         mapbox::sqlite::Query query{ getStatement("DELETE FROM regions WHERE id = ?") };
         query.bind(1, region.getID());
@@ -617,6 +792,8 @@ void OfflineDatabase::deleteRegion(OfflineRegion&& region) {
 }
 
 optional<std::pair<Response, uint64_t>> OfflineDatabase::getRegionResource(int64_t regionID, const Resource& resource) {
+    commitBatch();
+
     auto response = getInternal(resource);
 
     if (response) {
@@ -627,6 +804,8 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getRegionResource(int64
 }
 
 optional<int64_t> OfflineDatabase::hasRegionResource(int64_t regionID, const Resource& resource) {
+    commitBatch();
+
     auto response = hasInternal(resource);
 
     if (response) {
@@ -637,6 +816,7 @@ optional<int64_t> OfflineDatabase::hasRegionResource(int64_t regionID, const Res
 }
 
 uint64_t OfflineDatabase::putRegionResource(int64_t regionID, const Resource& resource, const Response& response) {
+    commitBatch();
     mapbox::sqlite::Transaction transaction(*db);
     auto size = putRegionResourceInternal(regionID, resource, response);
     transaction.commit();
@@ -644,6 +824,7 @@ uint64_t OfflineDatabase::putRegionResource(int64_t regionID, const Resource& re
 }
 
 void OfflineDatabase::putRegionResources(int64_t regionID, const std::list<std::tuple<Resource, Response>>& resources, OfflineRegionStatus& status) {
+    commitBatch();
     mapbox::sqlite::Transaction transaction(*db);
 
     for (const auto& elem : resources) {
@@ -821,27 +1002,36 @@ T OfflineDatabase::getPragma(const char* sql) {
     return query.get<T>(0);
 }
 
-// Remove least-recently used resources and tiles until the used database size,
-// as calculated by multiplying the number of in-use pages by the page size, is
-// less than the maximum cache size. Returns false if this condition cannot be
-// satisfied.
-//
-// SQLite database never shrinks in size unless we call VACCUM. We here
-// are monitoring the soft limit (i.e. number of free pages in the file)
-// and as it approaches to the hard limit (i.e. the actual file size) we
-// delete an arbitrary number of old cache entries. The free pages approach saves
-// us from calling VACCUM or keeping a running total, which can be costly.
-bool OfflineDatabase::evict(uint64_t neededFreeSize) {
-    uint64_t pageSize = getPragma<int64_t>("PRAGMA page_size");
-    uint64_t pageCount = getPragma<int64_t>("PRAGMA page_count");
-
-    auto usedSize = [&] {
-        return pageSize * (pageCount - getPragma<int64_t>("PRAGMA freelist_count"));
-    };
-
-    // The addition of pageSize is a fudge factor to account for non `data` column
-    // size, and because pages can get fragmented on the database.
-    while (usedSize() + neededFreeSize + pageSize > maximumCacheSize) {
+// Estimated size of the database: the running totals kept in cache_usage, plus
+// an allowance for everything that isn't resource or tile data. Unlike the page
+// count, this doesn't lag behind deletions until the free pages are reused.
+uint64_t OfflineDatabase::usedSize() {
+    mapbox::sqlite::Query query{ getStatement("SELECT size, count FROM cache_usage") };
+    query.run();
+    return query.get<int64_t>(0) + query.get<int64_t>(1) * entryOverhead;
+}
+
+// Remove least-recently used resources and tiles, one chunk at a time, until the
+// used size plus neededFreeSize, the overhead of a new entry and a page is within
+// the maximum cache size. Gives up after maxChunks chunks, leaving the remainder to
+// evictChunk(). Returns false if the condition can't be satisfied because nothing
+// evictable is left.
+bool OfflineDatabase::evict(uint64_t neededFreeSize, std::size_t maxChunks) {
+    // Pick eviction candidates by up-to-date access times. This may run inside of put()'s
+    // transaction, so it mustn't open one of its own.
+    writeAccessed();
+
+    evictionPending = false;
+
+    // The page size is a fudge factor for pages that are only partially used.
+    const uint64_t margin = entryOverhead + getPragma<int64_t>("PRAGMA page_size");
+
+    for (std::size_t chunk = 0; usedSize() + neededFreeSize + margin > maximumCacheSize; ++chunk) {
+        if (chunk == maxChunks) {
+            evictionPending = true;
+            return true;
+        }
+
         // clang-format off
         mapbox::sqlite::Query accessedQuery{ getStatement(
             "SELECT max(accessed) "
@@ -860,13 +1050,15 @@ bool OfflineDatabase::evict(uint64_t neededFreeSize) {
             "  ORDER BY accessed ASC LIMIT ?1 "
             ") "
         ) };
-        accessedQuery.bind(1, 50);
+        accessedQuery.bind(1, evictionChunkSize);
         // clang-format on
         if (!accessedQuery.run()) {
             return false;
         }
         Timestamp accessed = accessedQuery.get<Timestamp>(0);
 
+        // Access times have a resolution of one second, so there may be many more entries
+        // with that timestamp; the limits keep the chunk bounded. Ties are broken by age.
         // clang-format off
         mapbox::sqlite::Query resourceQuery{ getStatement(
             "DELETE FROM resources "
@@ -876,9 +1068,12 @@ bool OfflineDatabase::evict(uint64_t neededFreeSize) {
             "  ON resource_id = resources.id "
             "  WHERE resource_id IS NULL "
             "  AND accessed <= ?1 "
+            "  ORDER BY accessed ASC, id ASC "
+            "  LIMIT ?2 "
             ") ") };
         // clang-format on
         resourceQuery.bind(1, accessed);
+        resourceQuery.bind(2, evictionChunkSize);
         resourceQuery.run();
         const uint64_t resourceChanges = resourceQuery.changes();
 
@@ -891,9 +1086,12 @@ bool OfflineDatabase::evict(uint64_t neededFreeSize) {
             "  ON tile_id = tiles.id "
             "  WHERE tile_id IS NULL "
             "  AND accessed <= ?1 "
+            "  ORDER BY accessed ASC, id ASC "
+            "  LIMIT ?2 "
             ") ") };
         // clang-format on
         tileQuery.bind(1, accessed);
+        tileQuery.bind(2, evictionChunkSize);
         tileQuery.run();
         const uint64_t tileChanges = tileQuery.changes();
 
@@ -908,6 +1106,27 @@ bool OfflineDatabase::evict(uint64_t neededFreeSize) {
     return true;
 }
 
+bool OfflineDatabase::needsEviction() const {
+    return evictionPending;
+}
+
+bool OfflineDatabase::evictChunk() {
+    if (!evictionPending) {
+        return false;
+    }
+
+    // Joins the open put() batch, if there is one.
+    if (batch) {
+        evict(0, 1);
+    } else {
+        mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+        evict(0, 1);
+        transaction.commit();
+    }
+
+    return evictionPending;
+}
+
 void OfflineDatabase::setOfflineMapboxTileCountLimit(uint64_t limit) {
     offlineMapboxTileCountLimit = limit;
 }
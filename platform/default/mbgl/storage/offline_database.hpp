@@ -2,6 +2,7 @@
 
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/offline.hpp>
+#include <mbgl/util/compression.hpp>
 #include <mbgl/util/exception.hpp>
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/optional.hpp>
@@ -9,15 +10,19 @@
 #include <mbgl/util/mapbox.hpp>
 
 #include <unordered_map>
+#include <map>
 #include <memory>
 #include <string>
+#include <limits>
 #include <list>
+#include <tuple>
 
 namespace mapbox {
 namespace sqlite {
 class Database;
 class Statement;
 class Query;
+class Transaction;
 } // namespace sqlite
 } // namespace mapbox
 
@@ -34,14 +39,38 @@ class OfflineDatabase : private util::noncopyable {
 public:
     // Limits affect ambient caching (put) only; resources required by offline
     // regions are exempt.
-    OfflineDatabase(std::string path, uint64_t maximumCacheSize = util::DEFAULT_MAX_CACHE_SIZE);
+    //
+    // With writeAheadLog, the database uses SQLite's WAL journal with NORMAL
+    // synchronization instead of a rollback journal with FULL synchronization.
+    // Commits then only append to the log, and fsync at checkpoints rather than
+    // on every transaction. A crash may lose the most recent commits, but never
+    // corrupts the database.
+    OfflineDatabase(std::string path,
+                    uint64_t maximumCacheSize = util::DEFAULT_MAX_CACHE_SIZE,
+                    bool writeAheadLog = false);
     ~OfflineDatabase();
 
+    // Groups up to this many ambient put() calls into a single transaction.
+    // Defaults to 1, i.e. every put() is committed right away. While a batch
+    // is open, other connections to the same file can't write to it, and the
+    // batch is lost if put() fails. Region operations commit it first.
+    void setAmbientBatchSize(std::size_t);
+
+    // Commits the open put() batch, if any, and writes deferred access times.
+    void flush();
+
     optional<Response> get(const Resource&);
 
     // Return value is (inserted, stored size)
     std::pair<bool, uint64_t> put(const Resource&, const Response&);
 
+    // put() evicts a bounded number of least-recently used entries, so that its
+    // latency doesn't grow with the size of the cache. If that didn't make enough
+    // room, the cache temporarily exceeds its maximum size and needsEviction()
+    // returns true; call evictChunk() until it returns false to evict the rest.
+    bool needsEviction() const;
+    bool evictChunk();
+
     std::vector<OfflineRegion> listRegions();
 
     OfflineRegion createRegion(const OfflineRegionDefinition&,
@@ -69,11 +98,13 @@ public:
 private:
     int userVersion();
     void ensureSchema();
+    void setJournalMode();
     void removeExisting();
     void removeOldCacheTable();
     void migrateToVersion3();
     void migrateToVersion5();
     void migrateToVersion6();
+    void migrateToVersion7();
 
     mapbox::sqlite::Statement& getStatement(const char *);
 
@@ -96,6 +127,13 @@ private:
     // Return value is true iff the resource was previously unused by any other regions.
     bool markUsed(int64_t regionID, const Resource&);
 
+    void commitBatch();
+
+    void markAccessed(const Resource&);
+    void markAccessed(const Resource::TileData&);
+    void updateAccessed();
+    void writeAccessed();
+
     std::pair<int64_t, int64_t> getCompletedResourceCountAndSize(int64_t regionID);
     std::pair<int64_t, int64_t> getCompletedTileCountAndSize(int64_t regionID);
 
@@ -107,11 +145,30 @@ private:
     T getPragma(const char *);
 
     uint64_t maximumCacheSize;
+    const bool writeAheadLog;
+
+    std::size_t ambientBatchSize = 1;
+    std::size_t batchedPuts = 0;
+    std::unique_ptr<mapbox::sqlite::Transaction> batch;
+
+    // Access times are only used to choose eviction candidates, so instead of
+    // writing them on every read, they're collected here and written together,
+    // once enough have accumulated or before evicting.
+    using TileKey = std::tuple<std::string, uint8_t, int32_t, int32_t, int8_t>;
+    std::map<std::string, Timestamp> accessedResources;
+    std::map<TileKey, Timestamp> accessedTiles;
+
+    // Reused for every compressed resource read from the database. The database is only used on
+    // the file source thread, so this is the one decompressor of that thread.
+    util::Decompressor decompressor;
 
     uint64_t offlineMapboxTileCountLimit = util::mapbox::DEFAULT_OFFLINE_TILE_COUNT_LIMIT;
     optional<uint64_t> offlineMapboxTileCount;
 
-    bool evict(uint64_t neededFreeSize);
+    uint64_t usedSize();
+    bool evict(uint64_t neededFreeSize,
+               std::size_t maxChunks = std::numeric_limits<std::size_t>::max());
+    bool evictionPending = false;
 };
 
 } // namespace mbgl
@@ -49,6 +49,46 @@ CREATE TABLE region_tiles (
   UNIQUE (region_id, tile_id)
 );
 
+CREATE TABLE cache_usage (       -- Running totals over resources and tiles, maintained by the triggers below.
+  id INTEGER NOT NULL PRIMARY KEY CHECK (id = 0),
+  size INTEGER NOT NULL,          -- Sum of the stored (possibly compressed) data lengths
+  count INTEGER NOT NULL          -- Number of resources and tiles
+);
+
+INSERT INTO cache_usage (id, size, count) VALUES (0, 0, 0);
+
+-- Triggers keeping cache_usage up to date, so that eviction never has to measure the database
+
+CREATE TRIGGER resources_insert_usage AFTER INSERT ON resources
+BEGIN
+  UPDATE cache_usage SET size = size + IFNULL(length(NEW.data), 0), count = count + 1;
+END;
+
+CREATE TRIGGER resources_update_usage AFTER UPDATE OF data ON resources
+BEGIN
+  UPDATE cache_usage SET size = size - IFNULL(length(OLD.data), 0) + IFNULL(length(NEW.data), 0);
+END;
+
+CREATE TRIGGER resources_delete_usage AFTER DELETE ON resources
+BEGIN
+  UPDATE cache_usage SET size = size - IFNULL(length(OLD.data), 0), count = count - 1;
+END;
+
+CREATE TRIGGER tiles_insert_usage AFTER INSERT ON tiles
+BEGIN
+  UPDATE cache_usage SET size = size + IFNULL(length(NEW.data), 0), count = count + 1;
+END;
+
+CREATE TRIGGER tiles_update_usage AFTER UPDATE OF data ON tiles
+BEGIN
+  UPDATE cache_usage SET size = size - IFNULL(length(OLD.data), 0) + IFNULL(length(NEW.data), 0);
+END;
+
+CREATE TRIGGER tiles_delete_usage AFTER DELETE ON tiles
+BEGIN
+  UPDATE cache_usage SET size = size - IFNULL(length(OLD.data), 0), count = count - 1;
+END;
+
 -- Indexes for efficient eviction queries
 
 CREATE INDEX resources_accessed
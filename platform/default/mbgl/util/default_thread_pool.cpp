@@ -2,32 +2,95 @@
 #include <mbgl/actor/mailbox.hpp>
 #include <mbgl/util/platform.hpp>
 #include <mbgl/util/string.hpp>
+#include <mbgl/util/thread_local.hpp>
+
+#include <algorithm>
 
 namespace mbgl {
 
+class ThreadPool::Worker {
+public:
+    Worker(ThreadPool& pool_, std::size_t index_)
+        : pool(pool_), index(index_) {
+    }
+
+    struct Entry {
+        Mailbox::Priority priority;
+        uint64_t sequence;
+        std::weak_ptr<Mailbox> mailbox;
+    };
+
+    // Orders the heap so that its top is the most urgent, oldest entry.
+    struct Later {
+        bool operator()(const Entry& a, const Entry& b) const {
+            return a.priority != b.priority ? a.priority > b.priority : a.sequence > b.sequence;
+        }
+    };
+
+    void push(Mailbox::Priority priority, std::weak_ptr<Mailbox> mailbox) {
+        queue.push_back({ priority, sequence++, std::move(mailbox) });
+        std::push_heap(queue.begin(), queue.end(), Later());
+    }
+
+    std::weak_ptr<Mailbox> pop() {
+        std::pop_heap(queue.begin(), queue.end(), Later());
+        std::weak_ptr<Mailbox> mailbox = std::move(queue.back().mailbox);
+        queue.pop_back();
+        return mailbox;
+    }
+
+    ThreadPool& pool;
+    const std::size_t index;
+
+    std::mutex mutex;
+    std::vector<Entry> queue;
+    uint64_t sequence = 0;
+};
+
+static auto& currentWorker() {
+    static util::ThreadLocal<ThreadPool::Worker> worker;
+    return worker;
+}
+
 ThreadPool::ThreadPool(std::size_t count) {
+    workers.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        workers.emplace_back(std::make_unique<Worker>(*this, i));
+    }
+
     threads.reserve(count);
     for (std::size_t i = 0; i < count; ++i) {
         threads.emplace_back([this, i]() {
             platform::setCurrentThreadName(std::string{ "Worker " } + util::toString(i + 1));
 
-            while (true) {
+            Worker& worker = *workers[i];
+            currentWorker().set(&worker);
+
+            std::weak_ptr<Mailbox> mailbox;
+            while (!terminate) {
+                if (pop(worker, mailbox) || steal(i, mailbox)) {
+                    Mailbox::maybeReceive(std::move(mailbox));
+                    mailbox.reset();
+                    continue;
+                }
+
                 std::unique_lock<std::mutex> lock(mutex);
 
+                // Announce that we're about to sleep before checking for work, so
+                // that a concurrent schedule() either sees us sleeping and
+                // notifies, or we see its pending mailbox and don't wait.
+                ++sleeping;
                 cv.wait(lock, [this] {
-                    return !queue.empty() || terminate;
+                    return pending > 0 || terminate;
                 });
+                --sleeping;
 
                 if (terminate) {
-                    return;
+                    break;
                 }
-
-                auto mailbox = queue.front();
-                queue.pop();
-                lock.unlock();
-
-                Mailbox::maybeReceive(mailbox);
             }
+
+            currentWorker().set(nullptr);
         });
     }
 }
@@ -46,12 +109,63 @@ ThreadPool::~ThreadPool() {
 }
 
 void ThreadPool::schedule(std::weak_ptr<Mailbox> mailbox) {
+    Mailbox::Priority priority;
+    if (auto locked = mailbox.lock()) {
+        priority = locked->getPriority();
+    } else {
+        // The mailbox is gone already; receiving it would be a no-op.
+        return;
+    }
+
+    Worker* worker = currentWorker().get();
+    if (!worker || &worker->pool != this) {
+        worker = workers[next++ % workers.size()].get();
+    }
+
     {
-        std::lock_guard<std::mutex> lock(mutex);
-        queue.push(mailbox);
+        // Count the mailbox before publishing it: pop() and steal() decrement the counter as
+        // soon as they can see the mailbox, which must not take it below zero.
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        ++pending;
+        worker->push(priority, std::move(mailbox));
     }
 
-    cv.notify_one();
+    wake();
+}
+
+bool ThreadPool::pop(Worker& worker, std::weak_ptr<Mailbox>& mailbox) {
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.queue.empty()) {
+        return false;
+    }
+
+    mailbox = worker.pop();
+    --pending;
+    return true;
+}
+
+bool ThreadPool::steal(std::size_t thief, std::weak_ptr<Mailbox>& mailbox) {
+    const std::size_t count = workers.size();
+    for (std::size_t offset = 1; offset < count; ++offset) {
+        Worker& victim = *workers[(thief + offset) % count];
+
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.queue.empty()) {
+            mailbox = victim.pop();
+            --pending;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::wake() {
+    if (sleeping > 0) {
+        // Taking the mutex guarantees that a worker which has incremented
+        // `sleeping` is already blocked in cv.wait(), and can't miss the notify.
+        std::lock_guard<std::mutex> lock(mutex);
+        cv.notify_one();
+    }
 }
 
 } // namespace mbgl
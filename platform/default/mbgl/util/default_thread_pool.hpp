@@ -2,13 +2,25 @@
 
 #include <mbgl/actor/scheduler.hpp>
 
+#include <atomic>
 #include <condition_variable>
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
+#include <vector>
 
 namespace mbgl {
 
+// A work-stealing Scheduler. Every worker thread owns a queue of mailboxes,
+// ordered by Mailbox::getPriority() and then by arrival. Mailboxes scheduled
+// from one of the pool's own workers (e.g. an actor that messages another actor
+// on the same pool) are queued locally, everything else is distributed
+// round-robin. Idle workers steal the most urgent mailbox of a sibling before
+// going to sleep, so contention is limited to pairs of threads instead of every
+// thread competing for one global queue.
+//
+// Per-mailbox ordering is unaffected: a Mailbox only asks to be scheduled again
+// once its previous message has been received, so it is never queued twice.
 class ThreadPool : public Scheduler {
 public:
     ThreadPool(std::size_t count);
@@ -16,12 +28,28 @@ public:
 
     void schedule(std::weak_ptr<Mailbox>) override;
 
+    class Worker;
+
 private:
+    bool pop(Worker&, std::weak_ptr<Mailbox>&);
+    bool steal(std::size_t thief, std::weak_ptr<Mailbox>&);
+    void wake();
+
+    std::vector<std::unique_ptr<Worker>> workers;
     std::vector<std::thread> threads;
-    std::queue<std::weak_ptr<Mailbox>> queue;
+
+    // Round-robin cursor for mailboxes scheduled from outside the pool.
+    std::atomic<std::size_t> next { 0 };
+
+    // Number of mailboxes queued across all workers, and number of workers
+    // currently waiting for one. Together they let schedule() skip taking the
+    // sleep mutex when every worker is busy.
+    std::atomic<std::size_t> pending { 0 };
+    std::atomic<std::size_t> sleeping { 0 };
+
     std::mutex mutex;
     std::condition_variable cv;
-    bool terminate { false };
+    std::atomic<bool> terminate { false };
 };
 
 } // namespace mbgl
@@ -3,6 +3,7 @@
 #include <mbgl/renderer/backend_scope.hpp>
 #include <mbgl/util/logging.hpp>
 #include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
 
 #include <stdexcept>
 #include <cassert>
@@ -60,6 +61,7 @@ void ThreadLocal<T>::set(T* ptr) {
 
 template class ThreadLocal<BackendScope>;
 template class ThreadLocal<Scheduler>;
+template class ThreadLocal<ThreadPool::Worker>;
 template class ThreadLocal<int>; // For unit tests
 
 } // namespace util
@@ -0,0 +1,332 @@
+#include <mbgl/storage/tile_archive_file_source.hpp>
+#include <mbgl/storage/file_source_request.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/blob.hpp>
+#include <mbgl/util/compression.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/mapped_file.hpp>
+#include <mbgl/util/string.hpp>
+#include <mbgl/util/thread.hpp>
+#include <mbgl/util/url.hpp>
+
+#include "sqlite3.hpp"
+
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <tuple>
+#include <unordered_map>
+
+namespace {
+
+const std::string mbtilesProtocol = "mbtiles://";
+const std::string tilepackProtocol = "tilepack://";
+const std::string tileQuery = "?tile=";
+
+bool hasPrefix(const std::string& url, const std::string& prefix) {
+    return url.size() >= prefix.size() && std::equal(prefix.begin(), prefix.end(), url.begin());
+}
+
+} // namespace
+
+namespace mbgl {
+
+namespace {
+
+using JSONDocument = rapidjson::GenericDocument<rapidjson::UTF8<>, rapidjson::CrtAllocator>;
+using JSONValue = rapidjson::GenericValue<rapidjson::UTF8<>, rapidjson::CrtAllocator>;
+
+class Archive {
+public:
+    virtual ~Archive() = default;
+
+    // Adds the TileJSON members describing the archive, except for "tiles", to the object.
+    virtual void metadata(JSONDocument&) = 0;
+
+    // Returns the tile's data as stored, or a null Blob if the archive doesn't contain the tile.
+    virtual Blob tile(uint8_t z, uint32_t x, uint32_t y) = 0;
+};
+
+class MBTilesArchive : public Archive {
+public:
+    MBTilesArchive(const std::string& path)
+        : db(mapbox::sqlite::Database::open(path, mapbox::sqlite::ReadOnly)) {
+        // Have SQLite read pages through a memory map instead of copying them into its own
+        // page cache. This is capped at SQLITE_MAX_MMAP_SIZE, which defaults to just below 2GB.
+        db.exec("PRAGMA mmap_size = 2147418112");
+    }
+
+    void metadata(JSONDocument& doc) override {
+        mapbox::sqlite::Statement stmt{ db, "SELECT name, value FROM metadata" };
+        mapbox::sqlite::Query query{ stmt };
+
+        while (query.run()) {
+            const auto name = query.get<std::string>(0);
+            const auto value = query.get<std::string>(1);
+
+            if (name == "json") {
+                // Holds vector_layers and similar members that don't fit a single value.
+                JSONDocument json;
+                json.Parse<0>(value.c_str());
+                if (!json.HasParseError() && json.IsObject()) {
+                    for (auto& member : json.GetObject()) {
+                        set(doc, member.name.GetString(), JSONValue(member.value, doc.GetAllocator()));
+                    }
+                }
+            } else if (name == "minzoom" || name == "maxzoom") {
+                set(doc, name, JSONValue(std::atof(value.c_str())));
+            } else if (name == "bounds" || name == "center") {
+                // Comma separated lists of numbers.
+                JSONValue numbers(rapidjson::kArrayType);
+                const char* begin = value.c_str();
+                char* end;
+                for (double number = std::strtod(begin, &end); end != begin; number = std::strtod(begin, &end)) {
+                    numbers.PushBack(number, doc.GetAllocator());
+                    begin = *end == ',' ? end + 1 : end;
+                }
+                set(doc, name, std::move(numbers));
+            } else {
+                set(doc, name, JSONValue(value.c_str(), value.size(), doc.GetAllocator()));
+            }
+        }
+    }
+
+    Blob tile(uint8_t z, uint32_t x, uint32_t y) override {
+        mapbox::sqlite::Query query{ tileStatement };
+        query.bind(1, z);
+        query.bind(2, int64_t(x));
+        // MBTiles uses the TMS scheme.
+        query.bind(3, (int64_t(1) << z) - 1 - y);
+
+        if (!query.run()) {
+            return {};
+        }
+
+        return std::make_shared<std::string>(query.get<std::string>(0));
+    }
+
+private:
+    static void set(JSONDocument& doc, const std::string& name, JSONValue&& value) {
+        doc.RemoveMember(name.c_str());
+        doc.AddMember(JSONValue(name.c_str(), name.size(), doc.GetAllocator()), value, doc.GetAllocator());
+    }
+
+    mapbox::sqlite::Database db;
+    // clang-format off
+    mapbox::sqlite::Statement tileStatement{ db,
+        "SELECT tile_data "
+        "FROM tiles "
+        "WHERE zoom_level  = ?1 "
+        "  AND tile_column = ?2 "
+        "  AND tile_row    = ?3 " };
+    // clang-format on
+};
+
+class TilePackArchive : public Archive {
+public:
+    TilePackArchive(const std::string& path)
+        : file(std::make_shared<const util::MappedFile>(path)) {
+        if (file->size() < headerSize || std::memcmp(file->data(), "MBGLPACK", 8) != 0 ||
+            read<uint32_t>(8) != 1) {
+            throw std::runtime_error("Not a version 1 tile pack");
+        }
+
+        count = read<uint32_t>(12);
+        metadataOffset = read<uint64_t>(16);
+        metadataLength = read<uint64_t>(24);
+
+        if (headerSize + uint64_t(count) * entrySize > file->size() ||
+            metadataOffset > file->size() || metadataLength > file->size() - metadataOffset) {
+            throw std::runtime_error("Truncated tile pack");
+        }
+    }
+
+    void metadata(JSONDocument& doc) override {
+        JSONDocument json;
+        json.Parse<0>(file->data() + metadataOffset, metadataLength);
+        if (json.HasParseError() || !json.IsObject()) {
+            throw std::runtime_error("Invalid tile pack metadata");
+        }
+        doc.CopyFrom(json, doc.GetAllocator());
+    }
+
+    Blob tile(uint8_t z, uint32_t x, uint32_t y) override {
+        const auto key = std::make_tuple(z, x, y);
+
+        // Binary search of the directory, which is sorted by (z, x, y).
+        uint32_t first = 0;
+        uint32_t last = count;
+        while (first < last) {
+            const uint32_t middle = first + (last - first) / 2;
+            const uint64_t entry = headerSize + uint64_t(middle) * entrySize;
+            const auto entryKey = std::make_tuple(read<uint8_t>(entry), read<uint32_t>(entry + 4), read<uint32_t>(entry + 8));
+            if (entryKey < key) {
+                first = middle + 1;
+            } else if (key < entryKey) {
+                last = middle;
+            } else {
+                const uint32_t length = read<uint32_t>(entry + 12);
+                const uint64_t offset = read<uint64_t>(entry + 16);
+                if (offset > file->size() || length > file->size() - offset) {
+                    throw std::runtime_error("Truncated tile pack");
+                }
+                // Refers to the mapped file directly. Blobs keep the mapping alive, so this
+                // remains valid even after the file source is destroyed.
+                return Blob(file->data() + offset, length, file);
+            }
+        }
+
+        return {};
+    }
+
+private:
+    static constexpr uint64_t headerSize = 32;
+    static constexpr uint64_t entrySize = 24;
+
+    // Entries aren't necessarily aligned. All supported platforms are little endian.
+    template <typename T>
+    T read(uint64_t offset) const {
+        T value;
+        std::memcpy(&value, file->data() + offset, sizeof(T));
+        return value;
+    }
+
+    std::shared_ptr<const util::MappedFile> file;
+    uint32_t count;
+    uint64_t metadataOffset;
+    uint64_t metadataLength;
+};
+
+bool exists(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return errno != ENOENT;
+    }
+    std::fclose(file);
+    return true;
+}
+
+bool isGzip(const Blob& data) {
+    return data.size() >= 2 && uint8_t(data.data()[0]) == 0x1f && uint8_t(data.data()[1]) == 0x8b;
+}
+
+} // namespace
+
+class TileArchiveFileSource::Impl {
+public:
+    Impl(ActorRef<Impl>) {}
+
+    void request(const std::string& url, ActorRef<FileSourceRequest> req) {
+        Response response;
+
+        try {
+            load(url, response);
+        } catch (...) {
+            response.error = std::make_unique<Response::Error>(
+                Response::Error::Reason::Other,
+                util::toString(std::current_exception()));
+        }
+
+        req.invoke(&FileSourceRequest::setResponse, response);
+    }
+
+private:
+    void load(const std::string& url, Response& response) {
+        const bool mbtiles = hasPrefix(url, mbtilesProtocol);
+        const std::string& protocol = mbtiles ? mbtilesProtocol : tilepackProtocol;
+        const std::size_t query = url.find('?', protocol.size());
+        const std::string archiveURL = url.substr(0, query);
+        const std::string path = util::percentDecode(archiveURL.substr(protocol.size()));
+
+        auto it = archives.find(path);
+        if (it == archives.end()) {
+            if (!exists(path)) {
+                response.error = std::make_unique<Response::Error>(Response::Error::Reason::NotFound);
+                return;
+            }
+
+            // Archives are kept open for the lifetime of the file source.
+            std::unique_ptr<Archive> archive;
+            if (mbtiles) {
+                archive = std::make_unique<MBTilesArchive>(path);
+            } else {
+                archive = std::make_unique<TilePackArchive>(path);
+            }
+            it = archives.emplace(path, std::move(archive)).first;
+        }
+
+        Archive& archive = *it->second;
+
+        if (query == std::string::npos) {
+            JSONDocument doc;
+            doc.SetObject();
+            archive.metadata(doc);
+
+            // Tiles are always served in the XYZ scheme.
+            doc.RemoveMember("scheme");
+            doc.RemoveMember("tiles");
+
+            const std::string tileURL = archiveURL + tileQuery + "{z}/{x}/{y}";
+            JSONValue tiles(rapidjson::kArrayType);
+            tiles.PushBack(JSONValue(tileURL.c_str(), tileURL.size(), doc.GetAllocator()), doc.GetAllocator());
+            doc.AddMember("tiles", tiles, doc.GetAllocator());
+
+            rapidjson::StringBuffer buffer;
+            rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+            doc.Accept(writer);
+
+            response.data = std::make_shared<std::string>(buffer.GetString(), buffer.GetSize());
+            return;
+        }
+
+        unsigned z, x, y;
+        char end;
+        if (url.compare(query, tileQuery.size(), tileQuery) != 0 ||
+            std::sscanf(url.c_str() + query + tileQuery.size(), "%u/%u/%u%c", &z, &x, &y, &end) != 3 ||
+            z > 31 || x >= (1ull << z) || y >= (1ull << z)) {
+            response.error = std::make_unique<Response::Error>(Response::Error::Reason::Other,
+                                                               "Invalid tile URL");
+            return;
+        }
+
+        Blob data = archive.tile(z, x, y);
+        if (!data) {
+            response.noContent = true;
+        } else if (isGzip(data)) {
+            response.data = decompressor.decompress(data.data(), data.size());
+        } else {
+            response.data = std::move(data);
+        }
+    }
+
+    std::unordered_map<std::string, std::unique_ptr<Archive>> archives;
+
+    // The one decompressor of the archive thread, reused for every compressed tile.
+    util::Decompressor decompressor;
+};
+
+TileArchiveFileSource::TileArchiveFileSource()
+    : impl(std::make_unique<util::Thread<Impl>>("TileArchiveFileSource")) {
+}
+
+TileArchiveFileSource::~TileArchiveFileSource() = default;
+
+std::unique_ptr<AsyncRequest> TileArchiveFileSource::request(const Resource& resource, Callback callback) {
+    auto req = std::make_unique<FileSourceRequest>(std::move(callback));
+
+    impl->actor().invoke(&Impl::request, resource.url, req->actor());
+
+    return std::move(req);
+}
+
+bool TileArchiveFileSource::acceptsURL(const std::string& url) {
+    return hasPrefix(url, mbtilesProtocol) || hasPrefix(url, tilepackProtocol);
+}
+
+} // namespace mbgl
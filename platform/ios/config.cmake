@@ -87,6 +87,7 @@ macro(mbgl_filesource)
     target_sources(mbgl-filesource
         # File source
         PRIVATE platform/darwin/src/http_file_source.mm
+        PRIVATE platform/default/mapped_file.cpp
 
         # Database
         PRIVATE platform/default/sqlite3.cpp
@@ -101,6 +101,7 @@ macro(mbgl_filesource)
     target_sources(mbgl-filesource
         # File source
         PRIVATE platform/default/http_file_source.cpp
+        PRIVATE platform/default/mapped_file.cpp
 
         # Database
         PRIVATE platform/default/sqlite3.cpp
@@ -191,4 +192,6 @@ macro(mbgl_platform_node)
     target_link_libraries(mbgl-node INTERFACE
         -Wl,--version-script=${CMAKE_SOURCE_DIR}/platform/node/version-script
     )
+
+    target_add_mason_package(mbgl-node INTERFACE sqlite)
 endmacro()
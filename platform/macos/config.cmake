@@ -70,6 +70,7 @@ macro(mbgl_filesource)
     target_sources(mbgl-filesource
         # File source
         PRIVATE platform/darwin/src/http_file_source.mm
+        PRIVATE platform/default/mapped_file.cpp
 
         # Database
         PRIVATE platform/default/sqlite3.cpp
@@ -152,5 +153,6 @@ macro(mbgl_platform_node)
     target_link_libraries(mbgl-node INTERFACE
         -exported_symbols_list ${CMAKE_SOURCE_DIR}/platform/node/symbol-list
         -dead_strip
+        "-lsqlite3"
     )
 endmacro()
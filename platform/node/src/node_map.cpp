@@ -25,6 +25,7 @@
 #include <mbgl/style/image.hpp>
 #include <mbgl/style/light.hpp>
 #include <mbgl/map/map_observer.hpp>
+#include <mbgl/storage/tile_archive_file_source.hpp>
 #include <mbgl/util/premultiply.hpp>
 
 #include <unistd.h>
@@ -122,7 +123,8 @@ void NodeMap::Init(v8::Local<v8::Object> target) {
  * @name Map
  * @param {Object} options
  * @param {Function} options.request a method used to request resources
- * over the internet
+ * over the internet. Resources with `mbtiles://` and `tilepack://` URLs are
+ * read from local tile archives instead, without calling it.
  * @param {Function} [options.cancel]
  * @param {number} options.ratio pixel ratio
  * @example
@@ -552,6 +554,7 @@ void NodeMap::release() {
     
     map.reset();
     frontend.reset();
+    tileArchiveFileSource.reset();
 }
 
 /**
@@ -1210,6 +1213,13 @@ NodeMap::~NodeMap() {
 }
 
 std::unique_ptr<mbgl::AsyncRequest> NodeMap::request(const mbgl::Resource& resource, mbgl::FileSource::Callback callback_) {
+    if (mbgl::TileArchiveFileSource::acceptsURL(resource.url)) {
+        if (!tileArchiveFileSource) {
+            tileArchiveFileSource = std::make_unique<mbgl::TileArchiveFileSource>();
+        }
+        return tileArchiveFileSource->request(resource, std::move(callback_));
+    }
+
     Nan::HandleScope scope;
     // Because this method may be called while this NodeMap is already eligible for garbage collection,
     // we need to explicitly hold onto our own handle here so that GC during a v8 call doesn't destroy
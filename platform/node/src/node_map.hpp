@@ -17,6 +17,7 @@
 namespace mbgl {
 class Map;
 class HeadlessFrontend;
+class TileArchiveFileSource;
 } // namespace mbgl
 
 namespace node_mbgl {
@@ -84,6 +85,9 @@ public:
     std::unique_ptr<mbgl::HeadlessFrontend> frontend;
     std::unique_ptr<mbgl::Map> map;
 
+    // Serves mbtiles:// and tilepack:// URLs. Created on the first such request.
+    std::unique_ptr<mbgl::TileArchiveFileSource> tileArchiveFileSource;
+
     std::exception_ptr error;
     mbgl::PremultipliedImage image;
     std::unique_ptr<RenderRequest> req;
@@ -1,6 +1,7 @@
 'use strict';
 
 var mockfs = require('../mockfs');
+var path = require('path');
 var mbgl = require('../../index');
 var test = require('tape');
 
@@ -165,3 +166,23 @@ test(`render does not report an error from rendering a previous style`, function
         });
     });
 });
+
+test(`render reads tile archives without calling the request function`, function(t) {
+    var archive = 'tilepack://' + path.resolve('test/fixtures/storage/archives/test.tilepack');
+    var map = new mbgl.Map({
+        request: function(req, callback) {
+            t.fail(`unexpected request for ${req.url}`);
+            callback();
+        }
+    });
+    map.load({
+        version: 8,
+        sources: { archive: { type: 'vector', url: archive } },
+        layers: [{ id: 'background', type: 'background', paint: { 'background-color': 'red' } }]
+    });
+    map.render({ zoom: 0 }, function(err, pixels) {
+        t.error(err);
+        t.assert(pixels);
+        t.end();
+    });
+});
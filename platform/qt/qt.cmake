@@ -51,6 +51,7 @@ set(MBGL_QT_FILESOURCE_FILES
     PRIVATE platform/qt/src/http_file_source.hpp
     PRIVATE platform/qt/src/http_request.cpp
     PRIVATE platform/qt/src/http_request.hpp
+    PRIVATE platform/qt/src/mapped_file.cpp
 
     # Database
     PRIVATE platform/qt/src/sqlite3.cpp
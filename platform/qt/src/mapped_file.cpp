@@ -0,0 +1,52 @@
+#include <mbgl/util/mapped_file.hpp>
+#include <mbgl/util/io.hpp>
+
+#include <QFile>
+
+#include <cerrno>
+
+namespace mbgl {
+namespace util {
+
+class MappedFile::Impl {
+public:
+    Impl(const std::string& path) : file(QString::fromStdString(path)) {
+        if (!file.open(QIODevice::ReadOnly)) {
+            throw IOException(file.exists() ? EIO : ENOENT, "failed to open file");
+        }
+
+        size = static_cast<std::size_t>(file.size());
+        if (size > 0) {
+            const uchar* address = file.map(0, file.size());
+            if (!address) {
+                throw IOException(EIO, "failed to map file");
+            }
+            data = reinterpret_cast<const char*>(address);
+        }
+
+        // Unlike the file handle, the mapping stays valid after closing the file. It is
+        // unmapped when the QFile is destroyed.
+        file.close();
+    }
+
+    QFile file;
+    const char* data = nullptr;
+    std::size_t size = 0;
+};
+
+MappedFile::MappedFile(const std::string& path)
+    : impl(std::make_unique<Impl>(path)) {
+}
+
+MappedFile::~MappedFile() = default;
+
+const char* MappedFile::data() const {
+    return impl->data;
+}
+
+std::size_t MappedFile::size() const {
+    return impl->size;
+}
+
+} // namespace util
+} // namespace mbgl
@@ -2,6 +2,7 @@
 
 #include <mbgl/actor/scheduler.hpp>
 #include <mbgl/renderer/backend_scope.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
 
 #include <array>
 #include <cassert>
@@ -43,6 +44,7 @@ void ThreadLocal<T>::set(T* ptr) {
 
 template class ThreadLocal<Scheduler>;
 template class ThreadLocal<BackendScope>;
+template class ThreadLocal<ThreadPool::Worker>;
 template class ThreadLocal<int>; // For unit tests
 
 } // namespace util
@@ -3,89 +3,175 @@
 #include <mbgl/actor/scheduler.hpp>
 
 #include <cassert>
+#include <cstddef>
+#include <new>
+#include <thread>
 
 namespace mbgl {
 
-Mailbox::Mailbox() {
+namespace {
+
+// Permanent placeholder node of the queue, which is never received.
+class StubMessage : public Message {
+public:
+    void operator()() override {}
+};
+
+// Precedes every message in memory, and names the mailbox whose pool its node belongs to.
+struct alignas(std::max_align_t) MessageHeader {
+    Mailbox* mailbox;
+};
+
+// Pooled nodes have a fixed size, which fits most messages sent through ActorRef::invoke().
+// Larger messages are allocated from the heap.
+constexpr std::size_t pooledNodeSize = 256;
+
+// The number of nodes a mailbox keeps for reuse. Beyond that, nodes go back to the heap.
+constexpr std::size_t maxPoolSize = 16;
+
+} // namespace
+
+void* Message::operator new(std::size_t size) {
+    return new (::operator new(sizeof(MessageHeader) + size)) MessageHeader { nullptr } + 1;
+}
+
+void* Message::operator new(std::size_t size, Mailbox& mailbox) {
+    if (sizeof(MessageHeader) + size > pooledNodeSize) {
+        return operator new(size);
+    }
+
+    void* node = mailbox.takeNode();
+    if (!node) {
+        node = ::operator new(pooledNodeSize);
+    }
+    return new (node) MessageHeader { &mailbox } + 1;
+}
+
+void Message::operator delete(void* message) {
+    MessageHeader* header = static_cast<MessageHeader*>(message) - 1;
+    Mailbox* mailbox = header->mailbox;
+    if (!mailbox || !mailbox->recycleNode(header)) {
+        ::operator delete(header);
+    }
+}
+
+void Message::operator delete(void* message, Mailbox&) {
+    operator delete(message);
+}
+
+Mailbox::Mailbox()
+    : stub(std::make_unique<StubMessage>()),
+      head(stub.get()),
+      tail(stub.get()) {
 }
 
 Mailbox::Mailbox(Scheduler& scheduler_)
-    : scheduler(&scheduler_) {
+    : Mailbox() {
+    scheduler = &scheduler_;
+}
+
+Mailbox::~Mailbox() {
+    while (Message* message = dequeue()) {
+        delete message;
+    }
+
+    while (PooledNode* node = pool) {
+        pool = node->next;
+        ::operator delete(node);
+    }
 }
 
 void Mailbox::open(Scheduler& scheduler_) {
     assert(!scheduler);
 
-    // As with close(), block until neither receive() nor push() are in progress, and acquire the two
-    // mutexes in the same order.
+    // As with close(), block until receive() is not in progress.
     std::lock_guard<std::recursive_mutex> receivingLock(receivingMutex);
-    std::lock_guard<std::mutex> pushingLock(pushingMutex);
-    
+
     scheduler = &scheduler_;
 
     if (closed) {
         return;
     }
-    
-    if (!queue.empty()) {
-        (*scheduler)->schedule(shared_from_this());
+
+    // A push() racing with this may schedule the mailbox as well. receive() tolerates being
+    // called when there is nothing to receive, so this is harmless.
+    if (queued > 0) {
+        scheduler_.schedule(shared_from_this());
     }
 }
 
 void Mailbox::close() {
-    // Block until neither receive() nor push() are in progress. Two mutexes are used because receive()
-    // must not block send(). Of the two, the receiving mutex must be acquired first, because that is
-    // the order that an actor will obtain them when it self-sends a message, and consistent lock
-    // acquisition order prevents deadlocks.
-    // The receiving mutex is recursive to allow a mailbox (and thus the actor) to close itself.
+    // Block until neither receive() nor push() are in progress. The receiving mutex is recursive
+    // to allow a mailbox (and thus the actor) to close itself. Pushes don't lock anything; we
+    // wait for the ones that started before they could observe `closed`.
     std::lock_guard<std::recursive_mutex> receivingLock(receivingMutex);
-    std::lock_guard<std::mutex> pushingLock(pushingMutex);
 
     closed = true;
+
+    while (pushing > 0) {
+        std::this_thread::yield();
+    }
 }
 
-bool Mailbox::isOpen() const { return bool(scheduler); }
+bool Mailbox::isOpen() const { return scheduler != nullptr; }
 
+void Mailbox::setPriority(Priority priority_) {
+    priority = priority_;
+}
+
+Mailbox::Priority Mailbox::getPriority() const {
+    return priority;
+}
 
 void Mailbox::push(std::unique_ptr<Message> message) {
-    std::lock_guard<std::mutex> pushingLock(pushingMutex);
+    ++pushing;
 
     if (closed) {
+        --pushing;
         return;
     }
 
-    std::lock_guard<std::mutex> queueLock(queueMutex);
-    bool wasEmpty = queue.empty();
-    queue.push(std::move(message));
-    if (wasEmpty && scheduler) {
-        (*scheduler)->schedule(shared_from_this());
+    enqueue(message.release());
+
+    if (queued++ == 0) {
+        if (Scheduler* scheduler_ = scheduler) {
+            scheduler_->schedule(shared_from_this());
+        }
     }
+
+    --pushing;
 }
 
 void Mailbox::receive() {
     std::lock_guard<std::recursive_mutex> receivingLock(receivingMutex);
-    
+
     assert(scheduler);
 
     if (closed) {
         return;
     }
 
-    std::unique_ptr<Message> message;
-    bool wasEmpty;
-
-    {
-        std::lock_guard<std::mutex> queueLock(queueMutex);
-        assert(!queue.empty());
-        message = std::move(queue.front());
-        queue.pop();
-        wasEmpty = queue.empty();
+    Message* next;
+    while (!(next = dequeue())) {
+        if (queued == 0) {
+            // Scheduled more than once, e.g. by open() racing with push().
+            return;
+        }
+        // A producer has claimed its spot in the queue, but hasn't linked it yet.
+        std::this_thread::yield();
     }
 
+    std::unique_ptr<Message> message(next);
+
+    // The counter is incremented after the message is linked, so it can briefly be behind the
+    // queue. If it wraps that way, we schedule once more than necessary and the pushing thread
+    // doesn't schedule at all, which balances out.
+    const bool wasEmpty = queued-- == 1;
+
     (*message)();
 
     if (!wasEmpty) {
-        (*scheduler)->schedule(shared_from_this());
+        scheduler.load()->schedule(shared_from_this());
     }
 }
 
@@ -95,4 +181,74 @@ void Mailbox::maybeReceive(std::weak_ptr<Mailbox> mailbox) {
     }
 }
 
+void Mailbox::enqueue(Message* message) {
+    message->next.store(nullptr, std::memory_order_relaxed);
+    Message* previous = head.exchange(message, std::memory_order_acq_rel);
+    previous->next.store(message, std::memory_order_release);
+}
+
+Message* Mailbox::dequeue() {
+    Message* first = tail;
+    Message* next = first->next.load(std::memory_order_acquire);
+
+    if (first == stub.get()) {
+        if (!next) {
+            return nullptr;
+        }
+        tail = first = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next) {
+        tail = next;
+        return first;
+    }
+
+    if (first != head.load(std::memory_order_acquire)) {
+        // A push is in progress.
+        return nullptr;
+    }
+
+    // `first` is the last message; put the stub back behind it so that it can be unlinked.
+    enqueue(stub.get());
+
+    next = first->next.load(std::memory_order_acquire);
+    if (next) {
+        tail = next;
+        return first;
+    }
+
+    return nullptr;
+}
+
+void* Mailbox::takeNode() {
+    if (poolLock.test_and_set(std::memory_order_acquire)) {
+        return nullptr;
+    }
+
+    PooledNode* node = pool;
+    if (node) {
+        pool = node->next;
+        --poolSize;
+    }
+
+    poolLock.clear(std::memory_order_release);
+    return node;
+}
+
+bool Mailbox::recycleNode(void* node) {
+    if (poolLock.test_and_set(std::memory_order_acquire)) {
+        return false;
+    }
+
+    const bool recycled = poolSize < maxPoolSize;
+    if (recycled) {
+        pool = new (node) PooledNode { pool };
+        ++poolSize;
+    }
+
+    poolLock.clear(std::memory_order_release);
+    return recycled;
+}
+
 } // namespace mbgl
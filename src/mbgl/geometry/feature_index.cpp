@@ -23,8 +23,8 @@ FeatureIndex::FeatureIndex(std::unique_ptr<const GeometryTileData> tileData_)
 
 void FeatureIndex::insert(const GeometryCollection& geometries,
                           std::size_t index,
-                          const std::string& sourceLayerName,
-                          const std::string& bucketLeaderID) {
+                          InternedString sourceLayerName,
+                          InternedString bucketLeaderID) {
     for (const auto& ring : geometries) {
         auto envelope = mapbox::geometry::envelope(ring);
         if (envelope.min.x < util::EXTENT &&
@@ -148,7 +148,7 @@ void FeatureIndex::addFeature(
         }
 
         if (!geometryTileFeature) {
-            sourceLayer = tileData->getLayer(indexedFeature.sourceLayerName);
+            sourceLayer = tileData->getLayer(names.get(indexedFeature.sourceLayerName));
             assert(sourceLayer);
 
             geometryTileFeature = sourceLayer->getFeature(indexedFeature.index);
@@ -191,7 +191,7 @@ optional<GeometryCoordinates> FeatureIndex::translateQueryGeometry(
 }
 
 void FeatureIndex::setBucketLayerIDs(const std::string& bucketLeaderID, const std::vector<std::string>& layerIDs) {
-    bucketLayerIDs[bucketLeaderID] = layerIDs;
+    bucketLayerIDs[names.intern(bucketLeaderID)] = layerIDs;
 }
 
 } // namespace mbgl
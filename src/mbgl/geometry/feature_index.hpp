@@ -5,6 +5,7 @@
 #include <mbgl/tile/tile_id.hpp>
 #include <mbgl/util/grid_index.hpp>
 #include <mbgl/util/feature.hpp>
+#include <mbgl/util/interned_string.hpp>
 #include <mbgl/util/mat4.hpp>
 
 #include <vector>
@@ -19,13 +20,15 @@ class TransformState;
 
 class CollisionIndex;
 
+// Indexes are kept for every feature of a tile, and for every placed symbol, so the names
+// they refer to are interned in the tile's FeatureIndex rather than copied into each of them.
 class IndexedSubfeature {
 public:
     IndexedSubfeature() = delete;
-    IndexedSubfeature(std::size_t index_, std::string sourceLayerName_, std::string bucketName_, size_t sortIndex_)
+    IndexedSubfeature(std::size_t index_, InternedString sourceLayerName_, InternedString bucketName_, size_t sortIndex_)
         : index(index_)
-        , sourceLayerName(std::move(sourceLayerName_))
-        , bucketLeaderID(std::move(bucketName_))
+        , sourceLayerName(sourceLayerName_)
+        , bucketLeaderID(bucketName_)
         , sortIndex(sortIndex_)
         , bucketInstanceId(0)
     {}
@@ -39,8 +42,8 @@ public:
         , bucketInstanceId(bucketInstanceId_)
     {}
     size_t index;
-    std::string sourceLayerName;
-    std::string bucketLeaderID;
+    InternedString sourceLayerName;
+    InternedString bucketLeaderID;
     size_t sortIndex;
 
     // Only used for symbol features
@@ -52,8 +55,13 @@ public:
     FeatureIndex(std::unique_ptr<const GeometryTileData> tileData_);
 
     const GeometryTileData* getData() { return tileData.get(); }
+
+    // Interns a source layer name or a bucket leader ID for the features indexed in this tile.
+    InternedString intern(const std::string& name) {
+        return names.intern(name);
+    }
     
-    void insert(const GeometryCollection&, std::size_t index, const std::string& sourceLayerName, const std::string& bucketLeaderID);
+    void insert(const GeometryCollection&, std::size_t index, InternedString sourceLayerName, InternedString bucketLeaderID);
 
     void query(
             std::unordered_map<std::string, std::vector<Feature>>& result,
@@ -98,7 +106,8 @@ private:
     GridIndex<IndexedSubfeature> grid;
     unsigned int sortIndex = 0;
 
-    std::unordered_map<std::string, std::vector<std::string>> bucketLayerIDs;
+    StringTable names;
+    std::unordered_map<InternedString, std::vector<std::string>> bucketLayerIDs;
     std::unique_ptr<const GeometryTileData> tileData;
 };
 } // namespace mbgl
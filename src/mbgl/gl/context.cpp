@@ -255,6 +255,11 @@ void Context::updateVertexBuffer(UniqueBuffer& buffer, const void* data, std::si
     MBGL_CHECK_ERROR(glBufferSubData(GL_ARRAY_BUFFER, 0, size, data));
 }
 
+void Context::updateVertexBuffer(UniqueBuffer& buffer, std::size_t offset, const void* data, std::size_t size) {
+    vertexBuffer = buffer;
+    MBGL_CHECK_ERROR(glBufferSubData(GL_ARRAY_BUFFER, offset, size, data));
+}
+
 UniqueBuffer Context::createIndexBuffer(const void* data, std::size_t size, const BufferUsage usage) {
     BufferID id = 0;
     MBGL_CHECK_ERROR(glGenBuffers(1, &id));
@@ -549,6 +554,16 @@ void Context::updateTexture(
                                   data));
 }
 
+void Context::updateTextureSub(
+    TextureID id, const Point<uint32_t> offset, const Size size, const void* data, TextureFormat format, TextureUnit unit, TextureType type) {
+    activeTextureUnit = unit;
+    texture[unit] = id;
+    // Rows of alpha images aren't padded.
+    pixelStoreUnpack = { 1 };
+    MBGL_CHECK_ERROR(glTexSubImage2D(GL_TEXTURE_2D, 0, offset.x, offset.y, size.width, size.height,
+                                     static_cast<GLenum>(format), static_cast<GLenum>(type), data));
+}
+
 void Context::bindTexture(Texture& obj,
                           TextureUnit unit,
                           TextureFilter filter,
@@ -15,6 +15,7 @@
 #include <mbgl/gl/depth_mode.hpp>
 #include <mbgl/gl/stencil_mode.hpp>
 #include <mbgl/gl/color_mode.hpp>
+#include <mbgl/util/geometry.hpp>
 #include <mbgl/util/noncopyable.hpp>
 
 
@@ -74,6 +75,15 @@ public:
         updateVertexBuffer(buffer.buffer, v.data(), v.byteSize());
     }
 
+    // Uploads only the vertices [first, first + count) of a buffer that was created from `v`.
+    template <class Vertex, class DrawMode>
+    void updateVertexBuffer(VertexBuffer<Vertex, DrawMode>& buffer, const VertexVector<Vertex, DrawMode>& v,
+                            std::size_t first, std::size_t count) {
+        assert(v.vertexSize() == buffer.vertexCount);
+        assert(first + count <= buffer.vertexCount);
+        updateVertexBuffer(buffer.buffer, first * sizeof(Vertex), v.data() + first, count * sizeof(Vertex));
+    }
+
     template <class DrawMode>
     IndexBuffer<DrawMode> createIndexBuffer(IndexVector<DrawMode>&& v, const BufferUsage usage = BufferUsage::StaticDraw) {
         return IndexBuffer<DrawMode> {
@@ -142,6 +152,19 @@ public:
         obj.size = image.size;
     }
 
+    // Replaces the part of the texture at `offset` with the image, which must fit inside it.
+    template <typename Image>
+    void updateTextureSub(Texture& obj,
+                          const Image& image,
+                          const Point<uint32_t>& offset,
+                          TextureUnit unit = 0,
+                          TextureType type = TextureType::UnsignedByte) {
+        assert(offset.x + image.size.width <= obj.size.width);
+        assert(offset.y + image.size.height <= obj.size.height);
+        auto format = image.channels == 4 ? TextureFormat::RGBA : TextureFormat::Alpha;
+        updateTextureSub(obj.texture.get(), offset, image.size, image.data.get(), format, unit, type);
+    }
+
     // Creates an empty texture with the specified dimensions.
     Texture createTexture(const Size size,
                           TextureFormat format = TextureFormat::RGBA,
@@ -267,10 +290,12 @@ private:
 
     UniqueBuffer createVertexBuffer(const void* data, std::size_t size, const BufferUsage usage);
     void updateVertexBuffer(UniqueBuffer& buffer, const void* data, std::size_t size);
+    void updateVertexBuffer(UniqueBuffer& buffer, std::size_t offset, const void* data, std::size_t size);
     UniqueBuffer createIndexBuffer(const void* data, std::size_t size, const BufferUsage usage);
     void updateIndexBuffer(UniqueBuffer& buffer, const void* data, std::size_t size);
     UniqueTexture createTexture(Size size, const void* data, TextureFormat, TextureUnit, TextureType);
     void updateTexture(TextureID, Size size, const void* data, TextureFormat, TextureUnit, TextureType);
+    void updateTextureSub(TextureID, Point<uint32_t> offset, Size size, const void* data, TextureFormat, TextureUnit, TextureType);
     UniqueFramebuffer createFramebuffer();
     UniqueRenderbuffer createRenderbuffer(RenderbufferType, Size size);
     std::unique_ptr<uint8_t[]> readFramebuffer(Size, TextureFormat, bool flip);
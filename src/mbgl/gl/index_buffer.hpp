@@ -35,6 +35,8 @@ private:
 template <class DrawMode>
 class IndexBuffer {
 public:
+    std::size_t byteSize() const { return indexCount * sizeof(uint16_t); }
+
     std::size_t indexCount;
     UniqueBuffer buffer;
 };
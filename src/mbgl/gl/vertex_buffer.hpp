@@ -28,6 +28,8 @@ public:
     bool empty() const { return v.empty(); }
     void clear() { v.clear(); }
     const Vertex* data() const { return v.data(); }
+    Vertex& operator[](std::size_t i) { return v[i]; }
+    const Vertex& operator[](std::size_t i) const { return v[i]; }
     const std::vector<Vertex>& vector() const { return v; }
 
 private:
@@ -40,6 +42,8 @@ public:
     using Vertex = V;
     static constexpr std::size_t vertexSize = sizeof(Vertex);
 
+    std::size_t byteSize() const { return vertexCount * vertexSize; }
+
     std::size_t vertexCount;
     UniqueBuffer buffer;
 };
@@ -7,6 +7,8 @@
 #include <mbgl/text/bidi.hpp>
 #include <mbgl/style/layers/symbol_layer_impl.hpp>
 #include <mbgl/programs/symbol_program.hpp>
+#include <mbgl/util/cancellation_token.hpp>
+#include <mbgl/util/interned_string.hpp>
 
 #include <memory>
 #include <map>
@@ -16,10 +18,12 @@
 namespace mbgl {
 
 class BucketParameters;
+class FeatureIndex;
 class SymbolBucket;
 class Anchor;
 class RenderLayer;
 class PlacedSymbol;
+class ShapingCache;
 
 namespace style {
 class Filter;
@@ -30,12 +34,15 @@ public:
     SymbolLayout(const BucketParameters&,
                  const std::vector<const RenderLayer*>&,
                  std::unique_ptr<GeometryTileLayer>,
+                 FeatureIndex&,
                  ImageDependencies&,
                  GlyphDependencies&);
 
+    // Returns early, leaving the layout unusable, if the tile becomes obsolete in the meantime.
     void prepare(const GlyphMap&, const GlyphPositions&,
-                 const ImageMap&, const ImagePositions&);
+                 const ImageMap&, const ImagePositions&, ShapingCache&);
 
+    // Returns nullptr if the tile became obsolete before the bucket was complete.
     std::unique_ptr<SymbolBucket> place(const bool showCollisionBoxes);
 
     bool hasSymbolInstances() const;
@@ -69,10 +76,13 @@ private:
     // Stores the layer so that we can hold on to GeometryTileFeature instances in SymbolFeature,
     // which may reference data from this object.
     const std::unique_ptr<GeometryTileLayer> sourceLayer;
+    const InternedString indexedSourceLayerName;
+    const InternedString indexedBucketLeaderID;
     const float overscaling;
     const float zoom;
     const MapMode mode;
     const float pixelRatio;
+    const CancellationToken cancellation;
 
     style::SymbolLayoutProperties::PossiblyEvaluated layout;
 
@@ -82,6 +82,7 @@ public:
     bool cameraMutated = false;
 
     uint8_t prefetchZoomDelta = util::DEFAULT_PREFETCH_ZOOM_DELTA;
+    uint64_t maximumTileCacheSize = util::DEFAULT_MAX_TILE_CACHE_SIZE;
 
     bool loading = false;
     bool rendererFullyLoaded;
@@ -745,6 +746,15 @@ uint8_t Map::getPrefetchZoomDelta() const {
     return impl->prefetchZoomDelta;
 }
 
+void Map::setMaximumTileCacheSize(uint64_t bytes) {
+    impl->maximumTileCacheSize = bytes;
+    impl->onUpdate();
+}
+
+uint64_t Map::getMaximumTileCacheSize() const {
+    return impl->maximumTileCacheSize;
+}
+
 bool Map::isFullyLoaded() const {
     return impl->style->impl->isLoaded() && impl->rendererFullyLoaded;
 }
@@ -783,6 +793,7 @@ void Map::Impl::onUpdate() {
         style->impl->getLayerImpls(),
         annotationManager,
         prefetchZoomDelta,
+        maximumTileCacheSize,
         bool(stillImageRequest)
     };
 
@@ -2,6 +2,7 @@
 
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/util/memory_usage.hpp>
 
 #include <atomic>
 
@@ -24,12 +25,24 @@ public:
     virtual void addFeature(const GeometryTileFeature&,
                             const GeometryCollection&) {};
 
+    // Adds a batch of features at once, so that their paint property values can be evaluated for
+    // all of them together rather than one feature at a time.
+    virtual void addFeatures(const std::vector<const GeometryTileFeature*>& features,
+                             const std::vector<const GeometryCollection*>& geometries) {
+        for (std::size_t i = 0; i < features.size(); ++i) {
+            addFeature(*features[i], *geometries[i]);
+        }
+    }
+
     // As long as this bucket has a Prepare render pass, this function is getting called. Typically,
     // this only happens once when the bucket is being rendered for the first time.
     virtual void upload(gl::Context&) = 0;
 
     virtual bool hasData() const = 0;
 
+    // Bytes held by this bucket, both in client memory and in uploaded GL buffers and textures.
+    virtual MemoryUsage getMemoryUsage() const = 0;
+
     virtual float getQueryRadius(const RenderLayer&) const {
         return 0;
     };
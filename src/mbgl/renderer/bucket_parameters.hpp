@@ -2,6 +2,7 @@
 
 #include <mbgl/map/mode.hpp>
 #include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/cancellation_token.hpp>
 
 namespace mbgl {
 
@@ -10,6 +11,8 @@ public:
     const OverscaledTileID tileID;
     const MapMode mode;
     const float pixelRatio;
+    // Set once the tile is obsolete and the buckets will never be used.
+    const CancellationToken cancellation;
 };
 
 } // namespace mbgl
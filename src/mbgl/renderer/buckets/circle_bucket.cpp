@@ -37,8 +37,41 @@ bool CircleBucket::hasData() const {
     return !segments.empty();
 }
 
+MemoryUsage CircleBucket::getMemoryUsage() const {
+    MemoryUsage usage {
+        vertices.byteSize() + triangles.byteSize(),
+        uploadedByteSize(vertexBuffer) + uploadedByteSize(indexBuffer)
+    };
+    for (const auto& pair : paintPropertyBinders) {
+        usage += pair.second.getMemoryUsage();
+    }
+    return usage;
+}
+
 void CircleBucket::addFeature(const GeometryTileFeature& feature,
                               const GeometryCollection& geometry) {
+    addGeometry(geometry);
+
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.populateVertexVectors(feature, vertices.vertexSize());
+    }
+}
+
+void CircleBucket::addFeatures(const std::vector<const GeometryTileFeature*>& features,
+                               const std::vector<const GeometryCollection*>& geometries) {
+    std::vector<std::size_t> lengths;
+    lengths.reserve(features.size());
+    for (const GeometryCollection* geometry : geometries) {
+        addGeometry(*geometry);
+        lengths.push_back(vertices.vertexSize());
+    }
+
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.populateVertexVectors(features, lengths);
+    }
+}
+
+void CircleBucket::addGeometry(const GeometryCollection& geometry) {
     constexpr const uint16_t vertexLength = 4;
 
     for (auto& circle : geometry) {
@@ -84,10 +117,6 @@ void CircleBucket::addFeature(const GeometryTileFeature& feature,
             segment.indexLength += 6;
         }
     }
-
-    for (auto& pair : paintPropertyBinders) {
-        pair.second.populateVertexVectors(feature, vertices.vertexSize());
-    }
 }
 
 template <class Property>
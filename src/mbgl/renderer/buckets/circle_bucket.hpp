@@ -19,7 +19,10 @@ public:
 
     void addFeature(const GeometryTileFeature&,
                     const GeometryCollection&) override;
+    void addFeatures(const std::vector<const GeometryTileFeature*>&,
+                     const std::vector<const GeometryCollection*>&) override;
     bool hasData() const override;
+    MemoryUsage getMemoryUsage() const override;
 
     void upload(gl::Context&) override;
 
@@ -35,6 +38,9 @@ public:
     std::map<std::string, CircleProgram::PaintPropertyBinders> paintPropertyBinders;
 
     const MapMode mode;
+
+private:
+    void addGeometry(const GeometryCollection&);
 };
 
 } // namespace mbgl
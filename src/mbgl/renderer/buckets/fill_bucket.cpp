@@ -40,6 +40,28 @@ FillBucket::FillBucket(const BucketParameters& parameters, const std::vector<con
 
 void FillBucket::addFeature(const GeometryTileFeature& feature,
                             const GeometryCollection& geometry) {
+    addGeometry(geometry);
+
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.populateVertexVectors(feature, vertices.vertexSize());
+    }
+}
+
+void FillBucket::addFeatures(const std::vector<const GeometryTileFeature*>& features,
+                             const std::vector<const GeometryCollection*>& geometries) {
+    std::vector<std::size_t> lengths;
+    lengths.reserve(features.size());
+    for (const GeometryCollection* geometry : geometries) {
+        addGeometry(*geometry);
+        lengths.push_back(vertices.vertexSize());
+    }
+
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.populateVertexVectors(features, lengths);
+    }
+}
+
+void FillBucket::addGeometry(const GeometryCollection& geometry) {
     for (auto& polygon : classifyRings(geometry)) {
         // Optimize polygons with many interior rings for earcut tesselation.
         limitHoles(polygon, 500);
@@ -102,10 +124,6 @@ void FillBucket::addFeature(const GeometryTileFeature& feature,
         triangleSegment.vertexLength += totalVertices;
         triangleSegment.indexLength += nIndicies;
     }
-
-    for (auto& pair : paintPropertyBinders) {
-        pair.second.populateVertexVectors(feature, vertices.vertexSize());
-    }
 }
 
 void FillBucket::upload(gl::Context& context) {
@@ -124,6 +142,17 @@ bool FillBucket::hasData() const {
     return !triangleSegments.empty() || !lineSegments.empty();
 }
 
+MemoryUsage FillBucket::getMemoryUsage() const {
+    MemoryUsage usage {
+        vertices.byteSize() + lines.byteSize() + triangles.byteSize(),
+        uploadedByteSize(vertexBuffer) + uploadedByteSize(lineIndexBuffer) + uploadedByteSize(triangleIndexBuffer)
+    };
+    for (const auto& pair : paintPropertyBinders) {
+        usage += pair.second.getMemoryUsage();
+    }
+    return usage;
+}
+
 float FillBucket::getQueryRadius(const RenderLayer& layer) const {
     if (!layer.is<RenderFillLayer>()) {
         return 0;
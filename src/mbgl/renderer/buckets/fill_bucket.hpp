@@ -20,7 +20,10 @@ public:
 
     void addFeature(const GeometryTileFeature&,
                     const GeometryCollection&) override;
+    void addFeatures(const std::vector<const GeometryTileFeature*>&,
+                     const std::vector<const GeometryCollection*>&) override;
     bool hasData() const override;
+    MemoryUsage getMemoryUsage() const override;
 
     void upload(gl::Context&) override;
 
@@ -37,6 +40,9 @@ public:
     optional<gl::IndexBuffer<gl::Triangles>> triangleIndexBuffer;
 
     std::map<std::string, FillProgram::PaintPropertyBinders> paintPropertyBinders;
+
+private:
+    void addGeometry(const GeometryCollection&);
 };
 
 } // namespace mbgl
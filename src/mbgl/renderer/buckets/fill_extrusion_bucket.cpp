@@ -46,6 +46,28 @@ FillExtrusionBucket::FillExtrusionBucket(const BucketParameters& parameters, con
 
 void FillExtrusionBucket::addFeature(const GeometryTileFeature& feature,
                                      const GeometryCollection& geometry) {
+    addGeometry(geometry);
+
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.populateVertexVectors(feature, vertices.vertexSize());
+    }
+}
+
+void FillExtrusionBucket::addFeatures(const std::vector<const GeometryTileFeature*>& features,
+                                      const std::vector<const GeometryCollection*>& geometries) {
+    std::vector<std::size_t> lengths;
+    lengths.reserve(features.size());
+    for (const GeometryCollection* geometry : geometries) {
+        addGeometry(*geometry);
+        lengths.push_back(vertices.vertexSize());
+    }
+
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.populateVertexVectors(features, lengths);
+    }
+}
+
+void FillExtrusionBucket::addGeometry(const GeometryCollection& geometry) {
     for (auto& polygon : classifyRings(geometry)) {
         // Optimize polygons with many interior rings for earcut tesselation.
         limitHoles(polygon, 500);
@@ -140,10 +162,6 @@ void FillExtrusionBucket::addFeature(const GeometryTileFeature& feature,
         triangleSegment.vertexLength += totalVertices;
         triangleSegment.indexLength += nIndices;
     }
-
-    for (auto& pair : paintPropertyBinders) {
-        pair.second.populateVertexVectors(feature, vertices.vertexSize());
-    }
 }
 
 void FillExtrusionBucket::upload(gl::Context& context) {
@@ -161,6 +179,17 @@ bool FillExtrusionBucket::hasData() const {
     return !triangleSegments.empty();
 }
 
+MemoryUsage FillExtrusionBucket::getMemoryUsage() const {
+    MemoryUsage usage {
+        vertices.byteSize() + triangles.byteSize(),
+        uploadedByteSize(vertexBuffer) + uploadedByteSize(indexBuffer)
+    };
+    for (const auto& pair : paintPropertyBinders) {
+        usage += pair.second.getMemoryUsage();
+    }
+    return usage;
+}
+
 float FillExtrusionBucket::getQueryRadius(const RenderLayer& layer) const {
     if (!layer.is<RenderFillExtrusionLayer>()) {
         return 0;
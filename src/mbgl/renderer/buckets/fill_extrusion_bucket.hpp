@@ -18,7 +18,10 @@ public:
 
     void addFeature(const GeometryTileFeature&,
                     const GeometryCollection&) override;
+    void addFeatures(const std::vector<const GeometryTileFeature*>&,
+                     const std::vector<const GeometryCollection*>&) override;
     bool hasData() const override;
+    MemoryUsage getMemoryUsage() const override;
 
     void upload(gl::Context&) override;
 
@@ -32,6 +35,9 @@ public:
     optional<gl::IndexBuffer<gl::Triangles>> indexBuffer;
     
     std::unordered_map<std::string, FillExtrusionProgram::PaintPropertyBinders> paintPropertyBinders;
+
+private:
+    void addGeometry(const GeometryCollection&);
 };
 
 } // namespace mbgl
@@ -110,4 +110,19 @@ bool HillshadeBucket::hasData() const {
     return demdata.getImage()->valid();
 }
 
+MemoryUsage HillshadeBucket::getMemoryUsage() const {
+    MemoryUsage usage {
+        vertices.byteSize() + indices.byteSize() + demdata.getImage()->bytes(),
+        uploadedByteSize(vertexBuffer) + uploadedByteSize(indexBuffer)
+    };
+    // Both the DEM and the prepared hillshade texture are RGBA.
+    if (dem) {
+        usage.gpu += dem->size.area() * 4;
+    }
+    if (texture) {
+        usage.gpu += texture->size.area() * 4;
+    }
+    return usage;
+}
+
 } // namespace mbgl
@@ -24,6 +24,7 @@ public:
 
     void upload(gl::Context&) override;
     bool hasData() const override;
+    MemoryUsage getMemoryUsage() const override;
 
     void clear();
     void setMask(TileMask&&);
@@ -38,6 +38,22 @@ void LineBucket::addFeature(const GeometryTileFeature& feature,
     }
 }
 
+void LineBucket::addFeatures(const std::vector<const GeometryTileFeature*>& features,
+                             const std::vector<const GeometryCollection*>& geometries) {
+    std::vector<std::size_t> lengths;
+    lengths.reserve(features.size());
+    for (std::size_t i = 0; i < features.size(); ++i) {
+        for (auto& line : *geometries[i]) {
+            addGeometry(line, *features[i]);
+        }
+        lengths.push_back(vertices.vertexSize());
+    }
+
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.populateVertexVectors(features, lengths);
+    }
+}
+
 /*
  * Sharp corners cause dashed lines to tilt because the distance along the line
  * is the same at both the inner and outer corners. To improve the appearance of
@@ -465,6 +481,17 @@ bool LineBucket::hasData() const {
     return !segments.empty();
 }
 
+MemoryUsage LineBucket::getMemoryUsage() const {
+    MemoryUsage usage {
+        vertices.byteSize() + triangles.byteSize(),
+        uploadedByteSize(vertexBuffer) + uploadedByteSize(indexBuffer)
+    };
+    for (const auto& pair : paintPropertyBinders) {
+        usage += pair.second.getMemoryUsage();
+    }
+    return usage;
+}
+
 template <class Property>
 static float get(const RenderLineLayer& layer, const std::map<std::string, LineProgram::PaintPropertyBinders>& paintPropertyBinders) {
     auto it = paintPropertyBinders.find(layer.getID());
@@ -23,7 +23,10 @@ public:
 
     void addFeature(const GeometryTileFeature&,
                     const GeometryCollection&) override;
+    void addFeatures(const std::vector<const GeometryTileFeature*>&,
+                     const std::vector<const GeometryCollection*>&) override;
     bool hasData() const override;
+    MemoryUsage getMemoryUsage() const override;
 
     void upload(gl::Context&) override;
 
@@ -107,4 +107,18 @@ bool RasterBucket::hasData() const {
     return !!image;
 }
 
+MemoryUsage RasterBucket::getMemoryUsage() const {
+    MemoryUsage usage {
+        vertices.byteSize() + indices.byteSize(),
+        uploadedByteSize(vertexBuffer) + uploadedByteSize(indexBuffer)
+    };
+    if (image) {
+        usage.cpu += image->bytes();
+    }
+    if (texture) {
+        usage.gpu += texture->size.area() * 4;
+    }
+    return usage;
+}
+
 } // namespace mbgl
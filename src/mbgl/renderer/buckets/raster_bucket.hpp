@@ -19,6 +19,7 @@ public:
 
     void upload(gl::Context&) override;
     bool hasData() const override;
+    MemoryUsage getMemoryUsage() const override;
 
     void clear();
     void setImage(std::shared_ptr<PremultipliedImage>);
@@ -8,6 +8,25 @@ namespace mbgl {
 
 using namespace style;
 
+namespace {
+
+// Placement rewrites the opacity and collision debug vertices in place, so after the first
+// upload only the range of them that it changed needs to be sent again.
+template <class Vertex>
+void uploadChangedVertices(gl::Context& context,
+                           optional<gl::VertexBuffer<Vertex>>& buffer,
+                           gl::VertexVector<Vertex>& vertices,
+                           DirtyVertexRange& dirty) {
+    if (!buffer) {
+        buffer = context.createVertexBuffer(std::move(vertices), gl::BufferUsage::StreamDraw);
+    } else if (!dirty.empty()) {
+        context.updateVertexBuffer(*buffer, vertices, dirty.begin, dirty.end - dirty.begin);
+    }
+    dirty.clear();
+}
+
+} // namespace
+
 SymbolBucket::SymbolBucket(style::SymbolLayoutProperties::PossiblyEvaluated layout_,
                            const std::map<std::string, std::pair<
                                style::IconPaintProperties::PossiblyEvaluated,
@@ -53,11 +72,7 @@ void SymbolBucket::upload(gl::Context& context) {
             text.dynamicVertexBuffer = context.createVertexBuffer(std::move(text.dynamicVertices), gl::BufferUsage::StreamDraw);
         }
         if (!placementChangesUploaded) {
-            if (!text.opacityVertexBuffer) {
-                text.opacityVertexBuffer = context.createVertexBuffer(std::move(text.opacityVertices), gl::BufferUsage::StreamDraw);
-            } else {
-                context.updateVertexBuffer(*text.opacityVertexBuffer, std::move(text.opacityVertices));
-            }
+            uploadChangedVertices(context, text.opacityVertexBuffer, text.opacityVertices, text.dirtyOpacityVertices);
         }
     }
 
@@ -72,11 +87,7 @@ void SymbolBucket::upload(gl::Context& context) {
             icon.dynamicVertexBuffer = context.createVertexBuffer(std::move(icon.dynamicVertices), gl::BufferUsage::StreamDraw);
         }
         if (!placementChangesUploaded) {
-            if (!icon.opacityVertexBuffer) {
-                icon.opacityVertexBuffer = context.createVertexBuffer(std::move(icon.opacityVertices), gl::BufferUsage::StreamDraw);
-            } else {
-                context.updateVertexBuffer(*icon.opacityVertexBuffer, std::move(icon.opacityVertices));
-            }
+            uploadChangedVertices(context, icon.opacityVertexBuffer, icon.opacityVertices, icon.dirtyOpacityVertices);
         }
     }
 
@@ -86,11 +97,7 @@ void SymbolBucket::upload(gl::Context& context) {
             collisionBox.vertexBuffer = context.createVertexBuffer(std::move(collisionBox.vertices));
         }
         if (!placementChangesUploaded) {
-            if (!collisionBox.dynamicVertexBuffer) {
-                collisionBox.dynamicVertexBuffer = context.createVertexBuffer(std::move(collisionBox.dynamicVertices), gl::BufferUsage::StreamDraw);
-            } else {
-                context.updateVertexBuffer(*collisionBox.dynamicVertexBuffer, std::move(collisionBox.dynamicVertices));
-            }
+            uploadChangedVertices(context, collisionBox.dynamicVertexBuffer, collisionBox.dynamicVertices, collisionBox.dirtyDynamicVertices);
         }
     }
     
@@ -100,11 +107,7 @@ void SymbolBucket::upload(gl::Context& context) {
             collisionCircle.vertexBuffer = context.createVertexBuffer(std::move(collisionCircle.vertices));
         }
         if (!placementChangesUploaded) {
-            if (!collisionCircle.dynamicVertexBuffer) {
-                collisionCircle.dynamicVertexBuffer = context.createVertexBuffer(std::move(collisionCircle.dynamicVertices), gl::BufferUsage::StreamDraw);
-            } else {
-                context.updateVertexBuffer(*collisionCircle.dynamicVertexBuffer, std::move(collisionCircle.dynamicVertices));
-            }
+            uploadChangedVertices(context, collisionCircle.dynamicVertexBuffer, collisionCircle.dynamicVertices, collisionCircle.dirtyDynamicVertices);
         }
     }
 
@@ -126,6 +129,34 @@ bool SymbolBucket::hasData() const {
     return hasTextData() || hasIconData() || hasCollisionBoxData();
 }
 
+MemoryUsage SymbolBucket::getMemoryUsage() const {
+    MemoryUsage usage;
+
+    usage.cpu += text.vertices.byteSize() + text.dynamicVertices.byteSize() +
+                 text.opacityVertices.byteSize() + text.triangles.byteSize();
+    usage.cpu += icon.vertices.byteSize() + icon.dynamicVertices.byteSize() +
+                 icon.opacityVertices.byteSize() + icon.triangles.byteSize();
+    usage.cpu += (text.placedSymbols.size() + icon.placedSymbols.size()) * sizeof(PlacedSymbol);
+    usage.cpu += icon.atlasImage.bytes();
+    usage.cpu += collisionBox.vertices.byteSize() + collisionBox.dynamicVertices.byteSize() + collisionBox.lines.byteSize();
+    usage.cpu += collisionCircle.vertices.byteSize() + collisionCircle.dynamicVertices.byteSize() + collisionCircle.triangles.byteSize();
+
+    usage.gpu += uploadedByteSize(text.vertexBuffer) + uploadedByteSize(text.dynamicVertexBuffer) +
+                 uploadedByteSize(text.opacityVertexBuffer) + uploadedByteSize(text.indexBuffer);
+    usage.gpu += uploadedByteSize(icon.vertexBuffer) + uploadedByteSize(icon.dynamicVertexBuffer) +
+                 uploadedByteSize(icon.opacityVertexBuffer) + uploadedByteSize(icon.indexBuffer);
+    usage.gpu += uploadedByteSize(collisionBox.vertexBuffer) + uploadedByteSize(collisionBox.dynamicVertexBuffer) +
+                 uploadedByteSize(collisionBox.indexBuffer);
+    usage.gpu += uploadedByteSize(collisionCircle.vertexBuffer) + uploadedByteSize(collisionCircle.dynamicVertexBuffer) +
+                 uploadedByteSize(collisionCircle.indexBuffer);
+
+    for (const auto& pair : paintPropertyBinders) {
+        usage += pair.second.first.getMemoryUsage();
+        usage += pair.second.second.getMemoryUsage();
+    }
+    return usage;
+}
+
 bool SymbolBucket::hasTextData() const {
     return !text.segments.empty();
 }
@@ -12,6 +12,8 @@
 #include <mbgl/layout/symbol_feature.hpp>
 #include <mbgl/layout/symbol_instance.hpp>
 
+#include <algorithm>
+#include <limits>
 #include <vector>
 
 namespace mbgl {
@@ -37,6 +39,25 @@ public:
     size_t vertexStartIndex;
 };
 
+// The vertices of a buffer that were changed since the buffer was last uploaded.
+class DirtyVertexRange {
+public:
+    void add(std::size_t vertex) {
+        begin = std::min(begin, vertex);
+        end = std::max(end, vertex + 1);
+    }
+
+    bool empty() const { return begin >= end; }
+
+    void clear() {
+        begin = std::numeric_limits<std::size_t>::max();
+        end = 0;
+    }
+
+    std::size_t begin = std::numeric_limits<std::size_t>::max();
+    std::size_t end = 0;
+};
+
 class SymbolBucket : public Bucket {
 public:
     SymbolBucket(style::SymbolLayoutProperties::PossiblyEvaluated,
@@ -52,6 +73,7 @@ public:
 
     void upload(gl::Context&) override;
     bool hasData() const override;
+    MemoryUsage getMemoryUsage() const override;
     bool hasTextData() const;
     bool hasIconData() const;
     bool hasCollisionBoxData() const;
@@ -86,6 +108,7 @@ public:
         gl::VertexVector<SymbolLayoutVertex> vertices;
         gl::VertexVector<SymbolDynamicLayoutAttributes::Vertex> dynamicVertices;
         gl::VertexVector<SymbolOpacityAttributes::Vertex> opacityVertices;
+        DirtyVertexRange dirtyOpacityVertices;
         gl::IndexVector<gl::Triangles> triangles;
         SegmentVector<SymbolTextAttributes> segments;
         std::vector<PlacedSymbol> placedSymbols;
@@ -102,6 +125,7 @@ public:
         gl::VertexVector<SymbolLayoutVertex> vertices;
         gl::VertexVector<SymbolDynamicLayoutAttributes::Vertex> dynamicVertices;
         gl::VertexVector<SymbolOpacityAttributes::Vertex> opacityVertices;
+        DirtyVertexRange dirtyOpacityVertices;
         gl::IndexVector<gl::Triangles> triangles;
         SegmentVector<SymbolIconAttributes> segments;
         std::vector<PlacedSymbol> placedSymbols;
@@ -116,6 +140,7 @@ public:
     struct CollisionBuffer {
         gl::VertexVector<CollisionBoxLayoutAttributes::Vertex> vertices;
         gl::VertexVector<CollisionBoxDynamicAttributes::Vertex> dynamicVertices;
+        DirtyVertexRange dirtyDynamicVertices;
         SegmentVector<CollisionBoxProgram::Attributes> segments;
 
         optional<gl::VertexBuffer<CollisionBoxLayoutAttributes::Vertex>> vertexBuffer;
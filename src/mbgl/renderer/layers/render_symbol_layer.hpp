@@ -57,6 +57,7 @@ public:
 class BucketParameters;
 class SymbolLayout;
 class GeometryTileLayer;
+class FeatureIndex;
 
 class RenderSymbolLayer: public RenderLayer {
 public:
@@ -78,6 +79,7 @@ public:
     std::unique_ptr<SymbolLayout> createLayout(const BucketParameters&,
                                                const std::vector<const RenderLayer*>&,
                                                std::unique_ptr<GeometryTileLayer>,
+                                               FeatureIndex&,
                                                GlyphDependencies&,
                                                ImageDependencies&) const;
 
@@ -5,6 +5,7 @@
 #include <mbgl/gl/uniform.hpp>
 #include <mbgl/gl/context.hpp>
 #include <mbgl/util/type_list.hpp>
+#include <mbgl/util/memory_usage.hpp>
 #include <mbgl/renderer/possibly_evaluated_property_value.hpp>
 #include <mbgl/renderer/paint_property_statistics.hpp>
 
@@ -81,7 +82,12 @@ public:
     virtual ~PaintPropertyBinder() = default;
 
     virtual void populateVertexVector(const GeometryTileFeature& feature, std::size_t length) = 0;
+    // Populates the vertex vector for a batch of features at once, where lengths[i] is the vertex
+    // vector length after the vertices of features[i].
+    virtual void populateVertexVector(const std::vector<const GeometryTileFeature*>& features,
+                                      const std::vector<std::size_t>& lengths) = 0;
     virtual void upload(gl::Context& context) = 0;
+    virtual MemoryUsage getMemoryUsage() const = 0;
     virtual optional<AttributeBinding> attributeBinding(const PossiblyEvaluatedPropertyValue<T>& currentValue) const = 0;
     virtual float interpolationFactor(float currentZoom) const = 0;
     virtual T uniformValue(const PossiblyEvaluatedPropertyValue<T>& currentValue) const = 0;
@@ -102,8 +108,13 @@ public:
     }
 
     void populateVertexVector(const GeometryTileFeature&, std::size_t) override {}
+    void populateVertexVector(const std::vector<const GeometryTileFeature*>&, const std::vector<std::size_t>&) override {}
     void upload(gl::Context&) override {}
 
+    MemoryUsage getMemoryUsage() const override {
+        return {};
+    }
+
     optional<AttributeBinding> attributeBinding(const PossiblyEvaluatedPropertyValue<T>&) const override {
         return {};
     }
@@ -144,10 +155,27 @@ public:
         }
     }
 
+    void populateVertexVector(const std::vector<const GeometryTileFeature*>& features,
+                              const std::vector<std::size_t>& lengths) override {
+        assert(features.size() == lengths.size());
+        const std::vector<T> evaluated = function.evaluate(features, defaultValue);
+        for (std::size_t i = 0; i < evaluated.size(); ++i) {
+            this->statistics.add(evaluated[i]);
+            auto value = attributeValue(evaluated[i]);
+            for (std::size_t j = vertexVector.vertexSize(); j < lengths[i]; ++j) {
+                vertexVector.emplace_back(BaseVertex { value });
+            }
+        }
+    }
+
     void upload(gl::Context& context) override {
         vertexBuffer = context.createVertexBuffer(std::move(vertexVector));
     }
 
+    MemoryUsage getMemoryUsage() const override {
+        return { vertexVector.byteSize(), uploadedByteSize(vertexBuffer) };
+    }
+
     optional<AttributeBinding> attributeBinding(const PossiblyEvaluatedPropertyValue<T>& currentValue) const override {
         if (currentValue.isConstant()) {
             return {};
@@ -205,10 +233,30 @@ public:
         }
     }
 
+    void populateVertexVector(const std::vector<const GeometryTileFeature*>& features,
+                              const std::vector<std::size_t>& lengths) override {
+        assert(features.size() == lengths.size());
+        const std::vector<Range<T>> ranges = function.evaluate(zoomRange, features, defaultValue);
+        for (std::size_t i = 0; i < ranges.size(); ++i) {
+            this->statistics.add(ranges[i].min);
+            this->statistics.add(ranges[i].max);
+            AttributeValue value = zoomInterpolatedAttributeValue(
+                attributeValue(ranges[i].min),
+                attributeValue(ranges[i].max));
+            for (std::size_t j = vertexVector.vertexSize(); j < lengths[i]; ++j) {
+                vertexVector.emplace_back(Vertex { value });
+            }
+        }
+    }
+
     void upload(gl::Context& context) override {
         vertexBuffer = context.createVertexBuffer(std::move(vertexVector));
     }
 
+    MemoryUsage getMemoryUsage() const override {
+        return { vertexVector.byteSize(), uploadedByteSize(vertexBuffer) };
+    }
+
     optional<AttributeBinding> attributeBinding(const PossiblyEvaluatedPropertyValue<T>& currentValue) const override {
         if (currentValue.isConstant()) {
             return {};
@@ -300,12 +348,27 @@ public:
         });
     }
 
+    void populateVertexVectors(const std::vector<const GeometryTileFeature*>& features,
+                               const std::vector<std::size_t>& lengths) {
+        util::ignore({
+            (binders.template get<Ps>()->populateVertexVector(features, lengths), 0)...
+        });
+    }
+
     void upload(gl::Context& context) {
         util::ignore({
             (binders.template get<Ps>()->upload(context), 0)...
         });
     }
 
+    MemoryUsage getMemoryUsage() const {
+        MemoryUsage usage;
+        util::ignore({
+            (usage += binders.template get<Ps>()->getMemoryUsage(), 0)...
+        });
+        return usage;
+    }
+
     template <class P>
     using Attribute = ZoomInterpolatedAttribute<typename P::Attribute>;
 
@@ -99,4 +99,8 @@ void Renderer::reduceMemoryUse() {
     impl->reduceMemoryUse();
 }
 
+void Renderer::setPlacementBudget(optional<Duration> budget) {
+    impl->setPlacementBudget(budget);
+}
+
 } // namespace mbgl
@@ -53,7 +53,7 @@ Renderer::Impl::Impl(RendererBackend& backend_,
     , contextMode(contextMode_)
     , pixelRatio(pixelRatio_)
     , programCacheDir(programCacheDir_)
-    , glyphManager(std::make_unique<GlyphManager>(fileSource, std::make_unique<LocalGlyphRasterizer>(localFontFamily_)))
+    , glyphManager(std::make_unique<GlyphManager>(fileSource, std::make_unique<LocalGlyphRasterizer>(localFontFamily_), true))
     , imageManager(std::make_unique<ImageManager>())
     , lineAtlas(std::make_unique<LineAtlas>(Size{ 256, 512 }))
     , imageImpls(makeMutable<std::vector<Immutable<style::Image::Impl>>>())
@@ -116,7 +116,8 @@ void Renderer::Impl::render(const UpdateParameters& updateParameters) {
         updateParameters.annotationManager,
         *imageManager,
         *glyphManager,
-        updateParameters.prefetchZoomDelta
+        updateParameters.prefetchZoomDelta,
+        updateParameters.maximumTileCacheSize / std::max<std::size_t>(updateParameters.sources->size(), 1)
     };
 
     glyphManager->setURL(updateParameters.glyphURL);
@@ -385,23 +386,45 @@ void Renderer::Impl::render(const UpdateParameters& updateParameters) {
         }
     }
 
+    std::vector<std::string> symbolLayerIDs;
+    std::vector<std::reference_wrapper<RenderSymbolLayer>> symbolLayers;
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        if (it->layer.is<RenderSymbolLayer>()) {
+            symbolLayerIDs.push_back(it->layer.getID());
+            symbolLayers.push_back(*it->layer.as<RenderSymbolLayer>());
+        }
+    }
+
+    if (pendingPlacement && pendingPlacement->getLayerIDs() != symbolLayerIDs) {
+        // The symbol layers changed while they were being placed.
+        pendingPlacement.reset();
+    }
+
+    if (!pendingPlacement && !placement->stillRecent(parameters.timePoint)) {
+        // Unless the camera moved by half a pixel or more, only buckets that are new since the
+        // last placement need to be placed against the collision index.
+        pendingPlacement = std::make_unique<PauseablePlacement>(parameters.state, parameters.mapMode,
+            parameters.projMatrix, parameters.debugOptions & MapDebugOptions::Collision, symbolLayerIDs, *placement, &scheduler);
+    }
+
     bool placementChanged = false;
-    if (!placement->stillRecent(parameters.timePoint)) {
+    if (pendingPlacement) {
+        // With a budget, placement may take several frames, during which the last committed
+        // placement keeps being rendered.
+        optional<TimePoint> placementDeadline;
+        if (parameters.mapMode == MapMode::Continuous && placementBudget) {
+            placementDeadline = Clock::now() + *placementBudget;
+        }
+        pendingPlacement->continuePlacement(symbolLayers, placementDeadline);
+    }
+
+    if (pendingPlacement && pendingPlacement->isDone()) {
         placementChanged = true;
 
-        auto newPlacement = std::make_unique<Placement>(parameters.state, parameters.mapMode);
-        std::set<std::string> usedSymbolLayers;
-        for (auto it = order.rbegin(); it != order.rend(); ++it) {
-            if (it->layer.is<RenderSymbolLayer>()) {
-                usedSymbolLayers.insert(it->layer.getID());
-                newPlacement->placeLayer(*it->layer.as<RenderSymbolLayer>(), parameters.projMatrix, parameters.debugOptions & MapDebugOptions::Collision);
-            }
-        }
+        placement = pendingPlacement->commit(*placement, parameters.timePoint);
+        pendingPlacement.reset();
+        crossTileSymbolIndex.pruneUnusedLayers(std::set<std::string>(symbolLayerIDs.begin(), symbolLayerIDs.end()));
 
-        newPlacement->commit(*placement, parameters.timePoint);
-        crossTileSymbolIndex.pruneUnusedLayers(usedSymbolLayers);
-        placement = std::move(newPlacement);
-        
         updateFadingTiles();
     } else {
         placement->setStale();
@@ -810,7 +833,7 @@ bool Renderer::Impl::hasTransitions(TimePoint timePoint) const {
         }
     }
 
-    if (placement->hasTransitions(timePoint)) {
+    if (placement->hasTransitions(timePoint) || pendingPlacement) {
         return true;
     }
     
@@ -821,6 +844,10 @@ bool Renderer::Impl::hasTransitions(TimePoint timePoint) const {
     return false;
 }
 
+void Renderer::Impl::setPlacementBudget(optional<Duration> budget) {
+    placementBudget = budget;
+}
+
 void Renderer::Impl::updateFadingTiles() {
     fadingTiles = false;
     for (auto& source : renderSources) {
@@ -12,6 +12,7 @@
 #include <mbgl/text/cross_tile_symbol_index.hpp>
 #include <mbgl/text/glyph_manager_observer.hpp>
 #include <mbgl/text/placement.hpp>
+#include <mbgl/text/pauseable_placement.hpp>
 
 #include <memory>
 #include <string>
@@ -56,6 +57,8 @@ public:
     void reduceMemoryUse();
     void dumDebugLogs();
 
+    void setPlacementBudget(optional<Duration>);
+
 private:
     bool isLoaded() const;
     bool hasTransitions(TimePoint) const;
@@ -118,6 +121,8 @@ private:
 
     CrossTileSymbolIndex crossTileSymbolIndex;
     std::unique_ptr<Placement> placement;
+    std::unique_ptr<PauseablePlacement> pendingPlacement;
+    optional<Duration> placementBudget;
 
     bool contextLost = false;
     bool fadingTiles = false;
@@ -23,6 +23,8 @@ public:
     ImageManager& imageManager;
     GlyphManager& glyphManager;
     const uint8_t prefetchZoomDelta;
+    // Byte limit for the tile cache of a single source.
+    const uint64_t maximumTileCacheSize;
 };
 
 } // namespace mbgl
@@ -16,6 +16,7 @@
 #include <mapbox/geometry/envelope.hpp>
 
 #include <cmath>
+#include <cassert>
 #include <algorithm>
 
 namespace mbgl {
@@ -80,6 +81,7 @@ void TilePyramid::update(const std::vector<Immutable<style::Layer::Impl>>& layer
     if (!needsRendering) {
         if (!needsRelayout) {
             for (auto& entry : tiles) {
+                entry.second->setPriority(TilePriority::Kind::Cache);
                 cache.add(entry.first, std::move(entry.second));
             }
         }
@@ -132,11 +134,33 @@ void TilePyramid::update(const std::vector<Immutable<style::Layer::Impl>>& layer
     std::set<OverscaledTileID> retain;
     std::set<UnwrappedTileID> rendered;
 
+    // Ideal tiles are worked on in the order of their distance from the center of the viewport,
+    // which is the order in which the tile cover returns them. Any other tile we retain is either
+    // a stand-in for an ideal tile that isn't renderable yet, or a prefetched tile.
+    std::map<OverscaledTileID, uint32_t> idealTileRanks;
+    for (uint32_t i = 0; i < idealTiles.size(); ++i) {
+        idealTileRanks.emplace(OverscaledTileID(tileZoom, idealTiles[i].wrap, idealTiles[i].canonical), i);
+    }
+    std::map<OverscaledTileID, TilePriority> priorities;
+    bool prefetching = false;
+
     auto retainTileFn = [&](Tile& tile, TileNecessity necessity) -> void {
         if (retain.emplace(tile.id).second) {
             tile.setNecessity(necessity);
         }
 
+        TilePriority priority = TilePriority::Kind::Prefetch;
+        if (!prefetching) {
+            auto rank = idealTileRanks.find(tile.id);
+            priority = rank != idealTileRanks.end()
+                ? TilePriority(TilePriority::Kind::Ideal, rank->second)
+                : TilePriority(TilePriority::Kind::Fallback);
+        }
+        auto result = priorities.emplace(tile.id, priority);
+        if (!result.second && priority < result.first->second) {
+            result.first->second = priority;
+        }
+
         if (needsRelayout) {
             tile.setLayers(layers);
         }
@@ -186,8 +210,10 @@ void TilePyramid::update(const std::vector<Immutable<style::Layer::Impl>>& layer
     renderTiles.clear();
 
     if (!panTiles.empty()) {
+        prefetching = true;
         algorithm::updateRenderables(getTileFn, createTileFn, retainTileFn,
                 [](const UnwrappedTileID&, Tile&) {}, panTiles, zoomRange, panZoom);
+        prefetching = false;
     }
 
     algorithm::updateRenderables(getTileFn, createTileFn, retainTileFn, renderTileFn,
@@ -213,6 +239,7 @@ void TilePyramid::update(const std::vector<Immutable<style::Layer::Impl>>& layer
             0.5;
         cache.setSize(conservativeCacheSize);
     }
+    cache.setMaximumBytes(parameters.maximumTileCacheSize);
 
     // Remove stale tiles. This goes through the (sorted!) tiles map and retain set in lockstep
     // and removes items from tiles that don't have the corresponding key in the retain set.
@@ -223,6 +250,7 @@ void TilePyramid::update(const std::vector<Immutable<style::Layer::Impl>>& layer
             if (retainIt == retain.end() || tilesIt->first < *retainIt) {
                 if (!needsRelayout) {
                     tilesIt->second->setNecessity(TileNecessity::Optional);
+                    tilesIt->second->setPriority(TilePriority::Kind::Cache);
                     cache.add(tilesIt->first, std::move(tilesIt->second));
                 }
                 tiles.erase(tilesIt++);
@@ -236,6 +264,9 @@ void TilePyramid::update(const std::vector<Immutable<style::Layer::Impl>>& layer
     }
 
     for (auto& pair : tiles) {
+        auto priority = priorities.find(pair.first);
+        assert(priority != priorities.end());
+        pair.second->setPriority(priority->second);
         pair.second->setShowCollisionBoxes(parameters.debugOptions & MapDebugOptions::Collision);
     }
 }
@@ -35,6 +35,7 @@ public:
     AnnotationManager& annotationManager;
 
     const uint8_t prefetchZoomDelta;
+    const uint64_t maximumTileCacheSize;
     
     // For still image requests, render requested
     const bool stillImageRequest;
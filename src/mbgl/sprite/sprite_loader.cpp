@@ -59,7 +59,7 @@ void SpriteLoader::load(const std::string& url, Scheduler& scheduler, FileSource
             emitSpriteLoadedIfComplete();
         } else {
             // Only trigger a sprite loaded event we got new data.
-            loader->json = res.data;
+            loader->json = res.data.string();
             emitSpriteLoadedIfComplete();
         }
     });
@@ -73,7 +73,7 @@ void SpriteLoader::load(const std::string& url, Scheduler& scheduler, FileSource
             loader->image = std::make_shared<const std::string>();
             emitSpriteLoadedIfComplete();
         } else {
-            loader->image = res.data;
+            loader->image = res.data.string();
             emitSpriteLoadedIfComplete();
         }
     });
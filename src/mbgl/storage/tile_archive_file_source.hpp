@@ -0,0 +1,59 @@
+#pragma once
+
+#include <mbgl/storage/file_source.hpp>
+
+namespace mbgl {
+
+namespace util {
+template <typename T> class Thread;
+} // namespace util
+
+// Serves tiles from local, read-only tile archives, without touching the network
+// or the ambient cache. Two kinds of archives are supported:
+//
+//   mbtiles:///path/to/file.mbtiles   An MBTiles 1.x SQLite database. SQLite reads it
+//                                     through a memory map rather than read() calls, but
+//                                     each tile is copied out of it, since SQLite may split
+//                                     a tile across several pages.
+//   tilepack:///path/to/file.tilepack A tile pack, see below. The whole file is mapped
+//                                     into memory, tiles are found by binary search, and
+//                                     uncompressed tiles are served from the mapping without
+//                                     copying them.
+//
+// Requesting the archive URL itself returns TileJSON built from the archive's metadata,
+// so that it can be used as the "url" of a style source. Its tile URLs are of the form
+// <archive URL>?tile={z}/{x}/{y}. Tiles missing from the archive are reported as
+// noContent, like a 404 response for a tile. Gzip compressed tiles are inflated.
+//
+// A tile pack is a single file laid out as follows, all integers being little endian:
+//
+//   header     8 bytes    "MBGLPACK"
+//              uint32     version, currently 1
+//              uint32     number of tiles
+//              uint64     offset of the metadata
+//              uint64     length of the metadata
+//   directory  one 24 byte entry per tile, sorted by z, then x, then y:
+//              uint8      z
+//              3 bytes    padding
+//              uint32     x
+//              uint32     y, counted from the top (XYZ scheme)
+//              uint32     length of the tile data
+//              uint64     offset of the tile data
+//   metadata   TileJSON object, without "tiles"
+//   data       tile data at arbitrary offsets
+class TileArchiveFileSource : public FileSource {
+public:
+    TileArchiveFileSource();
+    ~TileArchiveFileSource() override;
+
+    std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
+
+    static bool acceptsURL(const std::string& url);
+
+private:
+    class Impl;
+
+    std::unique_ptr<util::Thread<Impl>> impl;
+};
+
+} // namespace mbgl
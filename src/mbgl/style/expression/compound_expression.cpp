@@ -2,6 +2,7 @@
 #include <mbgl/style/expression/collator.hpp>
 #include <mbgl/style/expression/compound_expression.hpp>
 #include <mbgl/style/expression/check_subtype.hpp>
+#include <mbgl/style/expression/literal.hpp>
 #include <mbgl/style/expression/util.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
 #include <mbgl/math/log2.hpp>
@@ -10,6 +11,7 @@
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/platform.hpp>
 #include <cmath>
+#include <tuple>
 
 namespace mbgl {
 namespace style {
@@ -41,10 +43,117 @@ namespace detail {
 template <class, class Enable = void>
 struct Signature;
 
+/*
+    Arguments that are literals, such as the key of ["get", key] or the value
+    that a filter compares against, are converted to their parameter type once,
+    when the expression is created, and kept in the expression's `Constants`.
+    Evaluating the expression then only evaluates the remaining arguments, and
+    doesn't copy the literals' strings and arrays on every evaluation. Nothing
+    else is precomputed: the rest of the tree is still walked each time.
+*/
+template <class T>
+optional<T> constantArgument(const Expression& arg) {
+    if (auto literal = dynamic_cast<const Literal*>(&arg)) {
+        return fromExpressionValue<T>(literal->getValue());
+    }
+    return {};
+}
+
+template <class T>
+EvaluationResult evaluateArgument(const EvaluationContext& evaluationParameters,
+                                  const Expression& arg,
+                                  const optional<T>& constant,
+                                  optional<T>& evaluated) {
+    if (constant) {
+        return Null;
+    }
+    EvaluationResult result = arg.evaluate(evaluationParameters);
+    if (result) {
+        evaluated = fromExpressionValue<T>(*result);
+    }
+    return result;
+}
+
+/*
+    Evaluating an expression for a batch of features evaluates each argument
+    that isn't constant for all of the features at once, producing a column of
+    results per argument. The expression's function is then applied to each
+    feature's row of arguments.
+*/
+template <class T>
+std::vector<EvaluationResult> evaluateColumn(const EvaluationContext& evaluationParameters,
+                                             const std::vector<const GeometryTileFeature*>& features,
+                                             const Expression& arg,
+                                             const optional<T>& constant) {
+    if (constant) {
+        return {};
+    }
+    return arg.evaluateBatch(evaluationParameters, features);
+}
+
+template <class T>
+EvaluationResult columnArgument(std::vector<EvaluationResult>& column,
+                                std::size_t row,
+                                const optional<T>& constant,
+                                optional<T>& evaluated) {
+    if (constant) {
+        return Null;
+    }
+    EvaluationResult result = std::move(column[row]);
+    if (result) {
+        evaluated = fromExpressionValue<T>(*result);
+    }
+    return result;
+}
+
+template <class T>
+EvaluationResult columnVarargs(const std::vector<std::vector<EvaluationResult>>& columns,
+                               std::size_t row,
+                               Varargs<T>& evaluated) {
+    evaluated.reserve(columns.size());
+    for (const auto& column : columns) {
+        const EvaluationResult& result = column[row];
+        if (!result) return result.error();
+        evaluated.push_back(*fromExpressionValue<std::decay_t<T>>(*result));
+    }
+    return Null;
+}
+
+inline std::vector<std::vector<EvaluationResult>> evaluateColumns(const EvaluationContext& evaluationParameters,
+                                                                  const std::vector<const GeometryTileFeature*>& features,
+                                                                  const std::vector<std::unique_ptr<Expression>>& args) {
+    std::vector<std::vector<EvaluationResult>> columns;
+    columns.reserve(args.size());
+    for (const auto& arg : args) {
+        columns.push_back(arg->evaluateBatch(evaluationParameters, features));
+    }
+    return columns;
+}
+
+inline EvaluationContext rowContext(const EvaluationContext& evaluationParameters, const GeometryTileFeature* feature) {
+    return EvaluationContext(evaluationParameters.zoom, feature, evaluationParameters.heatmapDensity);
+}
+
+// Varargs are only constant if all of them are literals.
+template <class T>
+optional<Varargs<T>> bindVarargsConstants(const std::vector<std::unique_ptr<Expression>>& args) {
+    Varargs<T> constants;
+    constants.reserve(args.size());
+    for (const auto& arg : args) {
+        optional<T> constant = constantArgument<T>(*arg);
+        if (!constant) {
+            return {};
+        }
+        constants.push_back(std::move(*constant));
+    }
+    return constants;
+}
+
 // Simple evaluate function (const T0&, const T1&, ...) -> Result<U>
 template <class R, class... Params>
 struct Signature<R (Params...)> : SignatureBase {
     using Args = std::array<std::unique_ptr<Expression>, sizeof...(Params)>;
+    using Constants = std::tuple<optional<std::decay_t<Params>>...>;
 
     Signature(R (*evaluate_)(Params...), std::string name_) :
         SignatureBase(
@@ -54,8 +163,19 @@ struct Signature<R (Params...)> : SignatureBase {
         ),
         evaluate(evaluate_)    {}
     
-    EvaluationResult apply(const EvaluationContext& evaluationParameters, const Args& args) const {
-        return applyImpl(evaluationParameters, args, std::index_sequence_for<Params...>{});
+    Constants bindConstants(const Args& args) const {
+        return bindConstantsImpl(args, std::index_sequence_for<Params...>{});
+    }
+
+    EvaluationResult apply(const EvaluationContext& evaluationParameters, const Args& args, const Constants& constants) const {
+        return applyImpl(evaluationParameters, args, constants, std::index_sequence_for<Params...>{});
+    }
+
+    std::vector<EvaluationResult> applyBatch(const EvaluationContext& evaluationParameters,
+                                             const std::vector<const GeometryTileFeature*>& features,
+                                             const Args& args,
+                                             const Constants& constants) const {
+        return applyBatchImpl(evaluationParameters, features, args, constants, std::index_sequence_for<Params...>{});
     }
 
     std::unique_ptr<Expression> makeExpression(std::vector<std::unique_ptr<Expression>> args) const override {
@@ -67,12 +187,51 @@ struct Signature<R (Params...)> : SignatureBase {
     R (*evaluate)(Params...);
 private:
     template <std::size_t ...I>
-    EvaluationResult applyImpl(const EvaluationContext& evaluationParameters, const Args& args, std::index_sequence<I...>) const {
-        const std::array<EvaluationResult, sizeof...(I)> evaluated = {{std::get<I>(args)->evaluate(evaluationParameters)...}};
-        for (const auto& arg : evaluated) {
-            if(!arg) return arg.error();
+    Constants bindConstantsImpl(const Args& args, std::index_sequence<I...>) const {
+        return Constants { constantArgument<std::decay_t<Params>>(*std::get<I>(args))... };
+    }
+
+    template <std::size_t ...I>
+    EvaluationResult applyImpl(const EvaluationContext& evaluationParameters, const Args& args, const Constants& constants, std::index_sequence<I...>) const {
+        Constants evaluated;
+        const std::array<EvaluationResult, sizeof...(I)> results = {{
+            evaluateArgument(evaluationParameters, *std::get<I>(args), std::get<I>(constants), std::get<I>(evaluated))...
+        }};
+        return applyEvaluated(evaluationParameters, results, constants, evaluated, std::index_sequence<I...>{});
+    }
+
+    template <std::size_t ...I>
+    std::vector<EvaluationResult> applyBatchImpl(const EvaluationContext& evaluationParameters,
+                                                 const std::vector<const GeometryTileFeature*>& features,
+                                                 const Args& args,
+                                                 const Constants& constants,
+                                                 std::index_sequence<I...>) const {
+        std::array<std::vector<EvaluationResult>, sizeof...(I)> columns = {{
+            evaluateColumn(evaluationParameters, features, *std::get<I>(args), std::get<I>(constants))...
+        }};
+        (void)columns; // Unused for functions without arguments.
+        std::vector<EvaluationResult> results;
+        results.reserve(features.size());
+        for (std::size_t row = 0; row < features.size(); ++row) {
+            Constants evaluated;
+            const std::array<EvaluationResult, sizeof...(I)> rowResults = {{
+                columnArgument(std::get<I>(columns), row, std::get<I>(constants), std::get<I>(evaluated))...
+            }};
+            results.push_back(applyEvaluated(rowContext(evaluationParameters, features[row]), rowResults, constants, evaluated, std::index_sequence<I...>{}));
         }
-        const R value = evaluate(*fromExpressionValue<std::decay_t<Params>>(*(evaluated[I]))...);
+        return results;
+    }
+
+    template <std::size_t ...I>
+    EvaluationResult applyEvaluated(const EvaluationContext&,
+                                    const std::array<EvaluationResult, sizeof...(I)>& results,
+                                    const Constants& constants,
+                                    const Constants& evaluated,
+                                    std::index_sequence<I...>) const {
+        for (const auto& result : results) {
+            if(!result) return result.error();
+        }
+        const R value = evaluate(*(std::get<I>(constants) ? std::get<I>(constants) : std::get<I>(evaluated))...);
         if (!value) return value.error();
         return *value;
     }
@@ -82,6 +241,7 @@ private:
 template <class R, typename T>
 struct Signature<R (const Varargs<T>&)> : SignatureBase {
     using Args = std::vector<std::unique_ptr<Expression>>;
+    using Constants = optional<Varargs<T>>;
 
     Signature(R (*evaluate_)(const Varargs<T>&), std::string name_) :
         SignatureBase(
@@ -96,7 +256,16 @@ struct Signature<R (const Varargs<T>&)> : SignatureBase {
         return std::make_unique<CompoundExpression<Signature>>(name, *this, std::move(args));
     };
 
-    EvaluationResult apply(const EvaluationContext& evaluationParameters, const Args& args) const {
+    Constants bindConstants(const Args& args) const {
+        return bindVarargsConstants<T>(args);
+    }
+
+    EvaluationResult apply(const EvaluationContext& evaluationParameters, const Args& args, const Constants& constants) const {
+        if (constants) {
+            const R value = evaluate(*constants);
+            if (!value) return value.error();
+            return *value;
+        }
         Varargs<T> evaluated;
         evaluated.reserve(args.size());
         for (const auto& arg : args) {
@@ -108,6 +277,33 @@ struct Signature<R (const Varargs<T>&)> : SignatureBase {
         if (!value) return value.error();
         return *value;
     }
+
+    std::vector<EvaluationResult> applyBatch(const EvaluationContext& evaluationParameters,
+                                             const std::vector<const GeometryTileFeature*>& features,
+                                             const Args& args,
+                                             const Constants& constants) const {
+        if (constants) {
+            return std::vector<EvaluationResult>(features.size(), apply(evaluationParameters, args, constants));
+        }
+        const std::vector<std::vector<EvaluationResult>> columns = evaluateColumns(evaluationParameters, features, args);
+        std::vector<EvaluationResult> results;
+        results.reserve(features.size());
+        for (std::size_t row = 0; row < features.size(); ++row) {
+            Varargs<T> evaluated;
+            const EvaluationResult evaluatedArgs = columnVarargs(columns, row, evaluated);
+            if (!evaluatedArgs) {
+                results.push_back(evaluatedArgs.error());
+                continue;
+            }
+            const R value = evaluate(evaluated);
+            if (!value) {
+                results.push_back(value.error());
+            } else {
+                results.push_back(*value);
+            }
+        }
+        return results;
+    }
     
     R (*evaluate)(const Varargs<T>&);
 };
@@ -117,6 +313,7 @@ struct Signature<R (const Varargs<T>&)> : SignatureBase {
 template <class R, class... Params>
 struct Signature<R (const EvaluationContext&, Params...)> : SignatureBase {
     using Args = std::array<std::unique_ptr<Expression>, sizeof...(Params)>;
+    using Constants = std::tuple<optional<std::decay_t<Params>>...>;
 
     Signature(R (*evaluate_)(const EvaluationContext&, Params...), std::string name_) :
         SignatureBase(
@@ -133,19 +330,69 @@ struct Signature<R (const EvaluationContext&, Params...)> : SignatureBase {
         return std::make_unique<CompoundExpression<Signature>>(name, *this, std::move(argsArray));
     }
 
-    EvaluationResult apply(const EvaluationContext& evaluationParameters, const Args& args) const {
-        return applyImpl(evaluationParameters, args, std::index_sequence_for<Params...>{});
+    Constants bindConstants(const Args& args) const {
+        return bindConstantsImpl(args, std::index_sequence_for<Params...>{});
+    }
+
+    EvaluationResult apply(const EvaluationContext& evaluationParameters, const Args& args, const Constants& constants) const {
+        return applyImpl(evaluationParameters, args, constants, std::index_sequence_for<Params...>{});
+    }
+
+    std::vector<EvaluationResult> applyBatch(const EvaluationContext& evaluationParameters,
+                                             const std::vector<const GeometryTileFeature*>& features,
+                                             const Args& args,
+                                             const Constants& constants) const {
+        return applyBatchImpl(evaluationParameters, features, args, constants, std::index_sequence_for<Params...>{});
     }
 
 private:
     template <std::size_t ...I>
-    EvaluationResult applyImpl(const EvaluationContext& evaluationParameters, const Args& args, std::index_sequence<I...>) const {
-        const std::array<EvaluationResult, sizeof...(I)> evaluated = {{std::get<I>(args)->evaluate(evaluationParameters)...}};
-        for (const auto& arg : evaluated) {
-            if(!arg) return arg.error();
+    Constants bindConstantsImpl(const Args& args, std::index_sequence<I...>) const {
+        return Constants { constantArgument<std::decay_t<Params>>(*std::get<I>(args))... };
+    }
+
+    template <std::size_t ...I>
+    EvaluationResult applyImpl(const EvaluationContext& evaluationParameters, const Args& args, const Constants& constants, std::index_sequence<I...>) const {
+        Constants evaluated;
+        const std::array<EvaluationResult, sizeof...(I)> results = {{
+            evaluateArgument(evaluationParameters, *std::get<I>(args), std::get<I>(constants), std::get<I>(evaluated))...
+        }};
+        return applyEvaluated(evaluationParameters, results, constants, evaluated, std::index_sequence<I...>{});
+    }
+
+    template <std::size_t ...I>
+    std::vector<EvaluationResult> applyBatchImpl(const EvaluationContext& evaluationParameters,
+                                                 const std::vector<const GeometryTileFeature*>& features,
+                                                 const Args& args,
+                                                 const Constants& constants,
+                                                 std::index_sequence<I...>) const {
+        std::array<std::vector<EvaluationResult>, sizeof...(I)> columns = {{
+            evaluateColumn(evaluationParameters, features, *std::get<I>(args), std::get<I>(constants))...
+        }};
+        (void)columns; // Unused for functions without arguments.
+        std::vector<EvaluationResult> results;
+        results.reserve(features.size());
+        for (std::size_t row = 0; row < features.size(); ++row) {
+            Constants evaluated;
+            const std::array<EvaluationResult, sizeof...(I)> rowResults = {{
+                columnArgument(std::get<I>(columns), row, std::get<I>(constants), std::get<I>(evaluated))...
+            }};
+            results.push_back(applyEvaluated(rowContext(evaluationParameters, features[row]), rowResults, constants, evaluated, std::index_sequence<I...>{}));
+        }
+        return results;
+    }
+
+    template <std::size_t ...I>
+    EvaluationResult applyEvaluated(const EvaluationContext& evaluationParameters,
+                                    const std::array<EvaluationResult, sizeof...(I)>& results,
+                                    const Constants& constants,
+                                    const Constants& evaluated,
+                                    std::index_sequence<I...>) const {
+        for (const auto& result : results) {
+            if(!result) return result.error();
         }
         // TODO: assert correct runtime type of each arg value
-        const R value = evaluate(evaluationParameters, *fromExpressionValue<std::decay_t<Params>>(*(evaluated[I]))...);
+        const R value = evaluate(evaluationParameters, *(std::get<I>(constants) ? std::get<I>(constants) : std::get<I>(evaluated))...);
         if (!value) return value.error();
         return *value;
     }
@@ -158,6 +405,7 @@ private:
 template <class R, typename T>
 struct Signature<R (const EvaluationContext&, const Varargs<T>&)> : SignatureBase {
     using Args = std::vector<std::unique_ptr<Expression>>;
+    using Constants = optional<Varargs<T>>;
     
     Signature(R (*evaluate_)(const EvaluationContext&, const Varargs<T>&), std::string name_) :
     SignatureBase(
@@ -172,7 +420,16 @@ struct Signature<R (const EvaluationContext&, const Varargs<T>&)> : SignatureBas
         return std::make_unique<CompoundExpression<Signature>>(name, *this, std::move(args));
     };
     
-    EvaluationResult apply(const EvaluationContext& evaluationParameters, const Args& args) const {
+    Constants bindConstants(const Args& args) const {
+        return bindVarargsConstants<T>(args);
+    }
+
+    EvaluationResult apply(const EvaluationContext& evaluationParameters, const Args& args, const Constants& constants) const {
+        if (constants) {
+            const R value = evaluate(evaluationParameters, *constants);
+            if (!value) return value.error();
+            return *value;
+        }
         Varargs<T> evaluated;
         evaluated.reserve(args.size());
         for (const auto& arg : args) {
@@ -184,6 +441,35 @@ struct Signature<R (const EvaluationContext&, const Varargs<T>&)> : SignatureBas
         if (!value) return value.error();
         return *value;
     }
+
+    std::vector<EvaluationResult> applyBatch(const EvaluationContext& evaluationParameters,
+                                             const std::vector<const GeometryTileFeature*>& features,
+                                             const Args& args,
+                                             const Constants& constants) const {
+        std::vector<std::vector<EvaluationResult>> columns;
+        if (!constants) {
+            columns = evaluateColumns(evaluationParameters, features, args);
+        }
+        std::vector<EvaluationResult> results;
+        results.reserve(features.size());
+        for (std::size_t row = 0; row < features.size(); ++row) {
+            Varargs<T> evaluated;
+            if (!constants) {
+                const EvaluationResult evaluatedArgs = columnVarargs(columns, row, evaluated);
+                if (!evaluatedArgs) {
+                    results.push_back(evaluatedArgs.error());
+                    continue;
+                }
+            }
+            const R value = evaluate(rowContext(evaluationParameters, features[row]), constants ? *constants : evaluated);
+            if (!value) {
+                results.push_back(value.error());
+            } else {
+                results.push_back(*value);
+            }
+        }
+        return results;
+    }
     
     R (*evaluate)(const EvaluationContext&, const Varargs<T>&);
 };
@@ -541,7 +827,7 @@ std::unordered_map<std::string, CompoundExpressionRegistry::Definition> initiali
         return rhs ? rhs < lhs : false;
     });
 
-    define("filter-<", [](const EvaluationContext& params, const std::string& key, std::string lhs) -> Result<bool> {
+    define("filter-<", [](const EvaluationContext& params, const std::string& key, const std::string& lhs) -> Result<bool> {
         auto rhs = featurePropertyAsString(params, key);
         return rhs ? rhs < lhs : false;
     });
@@ -551,7 +837,7 @@ std::unordered_map<std::string, CompoundExpressionRegistry::Definition> initiali
         return rhs ? rhs < lhs : false;
     });
 
-    define("filter-id-<", [](const EvaluationContext& params, std::string lhs) -> Result<bool> {
+    define("filter-id-<", [](const EvaluationContext& params, const std::string& lhs) -> Result<bool> {
         auto rhs = featureIdAsString(params);
         return rhs ? rhs < lhs : false;
     });
@@ -561,7 +847,7 @@ std::unordered_map<std::string, CompoundExpressionRegistry::Definition> initiali
         return rhs ? rhs > lhs : false;
     });
 
-    define("filter->", [](const EvaluationContext& params, const std::string& key, std::string lhs) -> Result<bool> {
+    define("filter->", [](const EvaluationContext& params, const std::string& key, const std::string& lhs) -> Result<bool> {
         auto rhs = featurePropertyAsString(params, key);
         return rhs ? rhs > lhs : false;
     });
@@ -571,7 +857,7 @@ std::unordered_map<std::string, CompoundExpressionRegistry::Definition> initiali
         return rhs ? rhs > lhs : false;
     });
 
-    define("filter-id->", [](const EvaluationContext& params, std::string lhs) -> Result<bool> {
+    define("filter-id->", [](const EvaluationContext& params, const std::string& lhs) -> Result<bool> {
         auto rhs = featureIdAsString(params);
         return rhs ? rhs > lhs : false;
     });
@@ -581,7 +867,7 @@ std::unordered_map<std::string, CompoundExpressionRegistry::Definition> initiali
         return rhs ? rhs <= lhs : false;
     });
     
-    define("filter-<=", [](const EvaluationContext& params, const std::string& key, std::string lhs) -> Result<bool> {
+    define("filter-<=", [](const EvaluationContext& params, const std::string& key, const std::string& lhs) -> Result<bool> {
         auto rhs = featurePropertyAsString(params, key);
         return rhs ? rhs <= lhs : false;
     });
@@ -591,7 +877,7 @@ std::unordered_map<std::string, CompoundExpressionRegistry::Definition> initiali
         return rhs ? rhs <= lhs : false;
     });
     
-    define("filter-id-<=", [](const EvaluationContext& params, std::string lhs) -> Result<bool> {
+    define("filter-id-<=", [](const EvaluationContext& params, const std::string& lhs) -> Result<bool> {
         auto rhs = featureIdAsString(params);
         return rhs ? rhs <= lhs : false;
     });
@@ -601,7 +887,7 @@ std::unordered_map<std::string, CompoundExpressionRegistry::Definition> initiali
         return rhs ? rhs >= lhs : false;
     });
     
-    define("filter->=", [](const EvaluationContext& params, const std::string& key, std::string lhs) -> Result<bool> {
+    define("filter->=", [](const EvaluationContext& params, const std::string& key, const std::string& lhs) -> Result<bool> {
         auto rhs = featurePropertyAsString(params, key);
         return rhs ? rhs >= lhs : false;
     });
@@ -611,7 +897,7 @@ std::unordered_map<std::string, CompoundExpressionRegistry::Definition> initiali
         return rhs ? rhs >= lhs : false;
     });
 
-    define("filter-id->=", [](const EvaluationContext& params, std::string lhs) -> Result<bool> {
+    define("filter-id->=", [](const EvaluationContext& params, const std::string& lhs) -> Result<bool> {
         auto rhs = featureIdAsString(params);
         return rhs ? rhs >= lhs : false;
     });
@@ -19,7 +19,21 @@ Step::Step(const type::Type& type_,
 }
 
 EvaluationResult Step::evaluate(const EvaluationContext& params) const {
-    const EvaluationResult evaluatedInput = input->evaluate(params);
+    return evaluateStops(params, input->evaluate(params));
+}
+
+std::vector<EvaluationResult> Step::evaluateBatch(const EvaluationContext& params,
+                                                  const std::vector<const GeometryTileFeature*>& features) const {
+    const std::vector<EvaluationResult> inputs = input->evaluateBatch(params, features);
+    std::vector<EvaluationResult> results;
+    results.reserve(features.size());
+    for (std::size_t i = 0; i < features.size(); ++i) {
+        results.push_back(evaluateStops(EvaluationContext(params.zoom, features[i], params.heatmapDensity), inputs[i]));
+    }
+    return results;
+}
+
+EvaluationResult Step::evaluateStops(const EvaluationContext& params, const EvaluationResult& evaluatedInput) const {
     if (!evaluatedInput) {
         return evaluatedInput.error();
     }
@@ -1,12 +1,173 @@
 #include <mbgl/style/filter.hpp>
+#include <mbgl/style/expression/boolean_operator.hpp>
+#include <mbgl/style/expression/compound_expression.hpp>
+#include <mbgl/style/expression/equals.hpp>
+#include <mbgl/style/expression/literal.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
 
 namespace mbgl {
 namespace style {
 
+using namespace expression;
+
+namespace {
+
+std::vector<const Expression*> children(const Expression& e) {
+    std::vector<const Expression*> result;
+    e.eachChild([&](const Expression& child) {
+        result.push_back(&child);
+    });
+    return result;
+}
+
+const CompoundExpressionBase* compound(const Expression& e, const std::string& name) {
+    auto result = dynamic_cast<const CompoundExpressionBase*>(&e);
+    return result && result->getName() == name ? result : nullptr;
+}
+
+optional<Value> literalValue(const Expression& e) {
+    if (auto literal = dynamic_cast<const Literal*>(&e)) {
+        return literal->getValue();
+    }
+    return {};
+}
+
+// Returns the value that the filter expression has for every feature, if it has one. Inputs of
+// "all" and "any" are evaluated in order and an error fails the filter, so a literal only decides
+// them when no input before it could fail.
+optional<bool> constantValue(const Expression& e) {
+    if (optional<Value> value = literalValue(e)) {
+        return value->is<bool>() ? value->get<bool>() : optional<bool>();
+    }
+
+    const bool isAll = dynamic_cast<const All*>(&e);
+    if (isAll || dynamic_cast<const Any*>(&e)) {
+        bool allConstant = true;
+        for (const Expression* input : children(e)) {
+            const optional<bool> inputValue = constantValue(*input);
+            if (!inputValue) {
+                allConstant = false;
+            } else if (*inputValue != isAll && allConstant) {
+                return !isAll;
+            }
+        }
+        return allConstant ? isAll : optional<bool>();
+    }
+
+    if (compound(e, "!")) {
+        const optional<bool> inputValue = constantValue(*children(e).at(0));
+        return inputValue ? !*inputValue : optional<bool>();
+    }
+
+    return {};
+}
+
+optional<FeatureType> featureType(const Value& value) {
+    if (value == Value(std::string("Point"))) return FeatureType::Point;
+    if (value == Value(std::string("LineString"))) return FeatureType::LineString;
+    if (value == Value(std::string("Polygon"))) return FeatureType::Polygon;
+    if (value == Value(std::string("Unknown"))) return FeatureType::Unknown;
+    return {};
+}
+
+// Returns the literal values of the given expressions, or nothing if one of them isn't a literal.
+optional<std::vector<Value>> literalValues(const std::vector<const Expression*>& expressions) {
+    std::vector<Value> values;
+    for (const Expression* e : expressions) {
+        optional<Value> value = literalValue(*e);
+        if (!value) {
+            return {};
+        }
+        values.push_back(std::move(*value));
+    }
+    return values;
+}
+
+void addTypes(FilterPredicate& predicate, const std::vector<Value>& values) {
+    if (predicate.types) {
+        return;
+    }
+    predicate.types.emplace();
+    for (const auto& value : values) {
+        if (optional<FeatureType> type = featureType(value)) {
+            predicate.types->push_back(*type);
+        }
+    }
+}
+
+void addKey(FilterPredicate& predicate, const Value& key, optional<std::vector<Value>> values) {
+    if (predicate.key || !key.is<std::string>()) {
+        return;
+    }
+    predicate.key = key.get<std::string>();
+    predicate.values = std::move(values);
+}
+
+// Adds the condition that a feature needs to meet for the expression to be true, if it's a
+// comparison of the geometry type or of a property with literal values.
+void addCondition(FilterPredicate& predicate, const Expression& e) {
+    const std::vector<const Expression*> args = children(e);
+
+    if (compound(e, "filter-type-==") || compound(e, "filter-type-in")) {
+        if (optional<std::vector<Value>> values = literalValues(args)) {
+            addTypes(predicate, *values);
+        }
+    } else if (compound(e, "filter-==") || compound(e, "filter-in")) {
+        optional<std::vector<Value>> values = literalValues(args);
+        if (values && values->size() >= 2) {
+            addKey(predicate, values->front(), std::vector<Value>(values->begin() + 1, values->end()));
+        }
+    } else if (compound(e, "filter-has")) {
+        if (optional<Value> key = literalValue(*args.at(0))) {
+            addKey(predicate, *key, {});
+        }
+    } else if (dynamic_cast<const Equals*>(&e) && e.getOperator() == "==" && args.size() == 2) {
+        // ["==", ["get", key], value] or ["==", ["geometry-type"], type], with the operands in
+        // either order. Features without the property compare as null.
+        for (std::size_t i = 0; i < 2; ++i) {
+            const Expression& operand = *args[i];
+            const optional<Value> value = literalValue(*args[1 - i]);
+            if (!value || value->is<NullValue>()) {
+                continue;
+            }
+            if (compound(operand, "geometry-type")) {
+                addTypes(predicate, { *value });
+            } else if (compound(operand, "get") && children(operand).size() == 1) {
+                if (optional<Value> key = literalValue(*children(operand).front())) {
+                    addKey(predicate, *key, std::vector<Value> { *value });
+                }
+            }
+        }
+    }
+}
+
+FilterPredicate predicateOf(const Expression& e) {
+    FilterPredicate predicate;
+    if (dynamic_cast<const All*>(&e)) {
+        for (const Expression* input : children(e)) {
+            addCondition(predicate, *input);
+        }
+    } else {
+        addCondition(predicate, e);
+    }
+    return predicate;
+}
+
+} // namespace
+
+Filter::Filter(expression::ParseResult _expression) : expression(std::move(*_expression)) {
+    assert(!expression || *expression != nullptr);
+    if (expression) {
+        constant = constantValue(**expression);
+        predicate = predicateOf(**expression);
+    }
+}
+
 bool Filter::operator()(const expression::EvaluationContext &context) const {
     
     if (!this->expression) return true;
+
+    if (constant) return *constant;
     
     const expression::EvaluationResult result = (*this->expression)->evaluate(context);
     if (result) {
@@ -33,6 +33,16 @@ EvaluationResult Expression::evaluate(optional<float> zoom, const Feature& featu
     return this->evaluate(EvaluationContext(zoom, &f, heatmapDensity));
 }
 
+std::vector<EvaluationResult> Expression::evaluateBatch(const EvaluationContext& params,
+                                                        const std::vector<const GeometryTileFeature*>& features) const {
+    std::vector<EvaluationResult> results;
+    results.reserve(features.size());
+    for (const GeometryTileFeature* feature : features) {
+        results.push_back(this->evaluate(EvaluationContext(params.zoom, feature, params.heatmapDensity)));
+    }
+    return results;
+}
+
 } // namespace expression
 } // namespace style
 } // namespace mbgl
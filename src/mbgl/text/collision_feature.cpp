@@ -34,6 +34,17 @@ CollisionFeature::CollisionFeature(const GeometryCoordinates& line,
 
         GeometryCoordinate anchorPoint = convertPoint<int16_t>(anchor.point);
         bboxifyLabel(line, anchorPoint, anchor.segment, length, height, overscaling);
+
+        if (!boxes.empty()) {
+            circleCentersMin = circleCentersMax = boxes.front().anchor;
+            for (const CollisionBox& box : boxes) {
+                circleCentersMin.x = std::min(circleCentersMin.x, box.anchor.x);
+                circleCentersMin.y = std::min(circleCentersMin.y, box.anchor.y);
+                circleCentersMax.x = std::max(circleCentersMax.x, box.anchor.x);
+                circleCentersMax.y = std::max(circleCentersMax.y, box.anchor.y);
+                maxCircleRadius = std::max(maxCircleRadius, (box.x2 - box.x1) / 2);
+            }
+        }
     } else {
         boxes.emplace_back(anchor.point, Point<float>{ 0, 0 }, x1, y1, x2, y2);
     }
@@ -93,6 +93,12 @@ public:
     IndexedSubfeature indexedFeature;
     bool alongLine;
 
+    // For line labels, the extent of the circle centers and the largest circle radius in tile
+    // units, so that labels far outside the viewport can be rejected without projecting each circle.
+    Point<float> circleCentersMin;
+    Point<float> circleCentersMax;
+    float maxCircleRadius = 0;
+
 private:
     void bboxifyLabel(const GeometryCoordinates& line, GeometryCoordinate& anchorPoint,
                       const int segment, const float length, const float height, const float overscaling);
@@ -12,7 +12,9 @@
 
 #include <mbgl/renderer/buckets/symbol_bucket.hpp> // For PlacedSymbol: pull out to another location
 
+#include <array>
 #include <cmath>
+#include <limits>
 
 namespace mbgl {
 
@@ -24,6 +26,20 @@ namespace mbgl {
 // stability, but it's expensive.
 static const float viewportPadding = 100;
 
+namespace {
+
+// Transforms a point on the tile plane (z = 0, w = 1) to clip space. Only the x, y and w rows of
+// the matrix contribute to the collision geometry, so the z row isn't computed at all.
+inline std::array<double, 3> projectToClip(const mat4& m, const Point<float>& point) {
+    const double x = point.x;
+    const double y = point.y;
+    return {{ m[0] * x + m[4] * y + m[12],
+              m[1] * x + m[5] * y + m[13],
+              m[3] * x + m[7] * y + m[15] }};
+}
+
+} // namespace
+
 CollisionIndex::CollisionIndex(const TransformState& transformState_)
     : transformState(transformState_)
     , collisionGrid(transformState.getSize().width + 2 * viewportPadding, transformState.getSize().height + 2 * viewportPadding, 25)
@@ -35,7 +51,7 @@ CollisionIndex::CollisionIndex(const TransformState& transformState_)
     , pitchFactor(std::cos(transformState.getPitch()) * transformState.getCameraToCenterDistance())
 {}
 
-float CollisionIndex::approximateTileDistance(const TileDistance& tileDistance, const float lastSegmentAngle, const float pixelsToTileUnits, const float cameraToAnchorDistance, const bool pitchWithMap) {
+float CollisionIndex::approximateTileDistance(const TileDistance& tileDistance, const float lastSegmentAngle, const float pixelsToTileUnits, const float cameraToAnchorDistance, const bool pitchWithMap) const {
     // This is a quick and dirty solution for chosing which collision circles to use (since collision circles are
     // laid out in tile units). Ideally, I think we should generate collision circles on the fly in viewport coordinates
     // at the time we do collision detection.
@@ -63,6 +79,44 @@ bool CollisionIndex::isInsideGrid(const CollisionBox& box) const {
     return box.px2 >= 0 && box.px1 < gridRightBoundary && box.py2 >= 0 && box.py1 < gridBottomBoundary;
 }
 
+bool CollisionIndex::circlesAreOutsideGrid(const CollisionFeature& feature, const mat4& posMatrix, const float viewportRadius) const {
+    if (feature.boxes.empty()) {
+        return false;
+    }
+
+    // The circle centers lie within the rectangle spanned by their extent on the tile plane. As
+    // long as it is entirely in front of the camera, it projects to the quadrilateral spanned by
+    // its projected corners, so their bounds contain all projected centers.
+    const Point<float> corners[] = {
+        feature.circleCentersMin,
+        { feature.circleCentersMax.x, feature.circleCentersMin.y },
+        feature.circleCentersMax,
+        { feature.circleCentersMin.x, feature.circleCentersMax.y }
+    };
+
+    float x1 = std::numeric_limits<float>::infinity();
+    float y1 = std::numeric_limits<float>::infinity();
+    float x2 = -std::numeric_limits<float>::infinity();
+    float y2 = -std::numeric_limits<float>::infinity();
+    for (const auto& corner : corners) {
+        const auto p = projectToClip(posMatrix, corner);
+        if (p[2] <= 0) {
+            return false;
+        }
+        const float x = (((p[0] / p[2] + 1) / 2) * transformState.getSize().width) + viewportPadding;
+        const float y = (((-p[1] / p[2] + 1) / 2) * transformState.getSize().height) + viewportPadding;
+        x1 = util::min(x1, x);
+        y1 = util::min(y1, y);
+        x2 = util::max(x2, x);
+        y2 = util::max(y2, y);
+    }
+
+    // Leave a pixel of slack for rounding differences to the projection of the circles themselves.
+    const float radius = viewportRadius + 1;
+    return x2 + radius < 0 || x1 - radius >= gridRightBoundary ||
+           y2 + radius < 0 || y1 - radius >= gridBottomBoundary;
+}
+
 
 std::pair<bool,bool> CollisionIndex::placeFeature(CollisionFeature& feature,
                                       const mat4& posMatrix,
@@ -74,6 +128,18 @@ std::pair<bool,bool> CollisionIndex::placeFeature(CollisionFeature& feature,
                                       const bool allowOverlap,
                                       const bool pitchWithMap,
                                       const bool collisionDebug) {
+    const auto projected = projectFeature(feature, posMatrix, labelPlaneMatrix, textPixelRatio, symbol, scale, fontSize, pitchWithMap);
+    return placeProjectedFeature(feature, projected, allowOverlap, collisionDebug);
+}
+
+CollisionIndex::ProjectedFeature CollisionIndex::projectFeature(CollisionFeature& feature,
+                                      const mat4& posMatrix,
+                                      const mat4& labelPlaneMatrix,
+                                      const float textPixelRatio,
+                                      const PlacedSymbol& symbol,
+                                      const float scale,
+                                      const float fontSize,
+                                      const bool pitchWithMap) const {
     if (!feature.alongLine) {
         CollisionBox& box = feature.boxes.front();
         const auto projectedPoint = projectAndGetPerspectiveRatio(posMatrix, box.anchor);
@@ -83,30 +149,59 @@ std::pair<bool,bool> CollisionIndex::placeFeature(CollisionFeature& feature,
         box.px2 = box.x2 * tileToViewport + projectedPoint.first.x;
         box.py2 = box.y2 * tileToViewport + projectedPoint.first.y;
 
-        if (!isInsideGrid(box) ||
+        return { isInsideGrid(box), isOffscreen(box) };
+    } else {
+        return projectLineFeature(feature, posMatrix, labelPlaneMatrix, textPixelRatio, symbol, scale, fontSize, pitchWithMap);
+    }
+}
+
+std::pair<bool,bool> CollisionIndex::placeProjectedFeature(const CollisionFeature& feature,
+                                      const ProjectedFeature& projected,
+                                      const bool allowOverlap,
+                                      const bool collisionDebug) const {
+    if (!feature.alongLine) {
+        const CollisionBox& box = feature.boxes.front();
+        if (!projected.fits ||
             (!allowOverlap && collisionGrid.hitTest({{ box.px1, box.py1 }, { box.px2, box.py2 }}))) {
             return { false, false };
         }
 
-        return {true, isOffscreen(box)};
-    } else {
-        return placeLineFeature(feature, posMatrix, labelPlaneMatrix, textPixelRatio, symbol, scale, fontSize, allowOverlap, pitchWithMap, collisionDebug);
+        return { true, projected.offscreen };
+    }
+
+    if (!allowOverlap) {
+        for (const CollisionBox& circle : feature.boxes) {
+            if (circle.used && collisionGrid.hitTest({{ circle.px, circle.py }, circle.radius })) {
+                // Colliding line labels are only reported offscreen when the debug circles are shown.
+                return { false, collisionDebug && projected.offscreen };
+            }
+        }
     }
+
+    return { projected.fits, projected.offscreen };
 }
 
-std::pair<bool,bool> CollisionIndex::placeLineFeature(CollisionFeature& feature,
+CollisionIndex::ProjectedFeature CollisionIndex::projectLineFeature(CollisionFeature& feature,
                                       const mat4& posMatrix,
                                       const mat4& labelPlaneMatrix,
                                       const float textPixelRatio,
-                                      PlacedSymbol& symbol,
+                                      const PlacedSymbol& symbol,
                                       const float scale,
                                       const float fontSize,
-                                      const bool allowOverlap,
-                                      const bool pitchWithMap,
-                                      const bool collisionDebug) {
+                                      const bool pitchWithMap) const {
 
     const auto tileUnitAnchorPoint = symbol.anchorPoint;
     const auto projectedAnchor = projectAnchor(posMatrix, tileUnitAnchorPoint);
+    const auto tileToViewport = projectedAnchor.first * textPixelRatio;
+
+    if (circlesAreOutsideGrid(feature, posMatrix, feature.maxCircleRadius * tileToViewport)) {
+        // None of the circles can end up in the grid, so the label can't be placed and all of its
+        // circles are offscreen, whichever of them the label would use.
+        for (CollisionBox& circle : feature.boxes) {
+            circle.used = false;
+        }
+        return { false, true };
+    }
 
     const float fontScale = fontSize / 24;
     const float lineOffsetX = symbol.lineOffset[0] * fontSize;
@@ -125,11 +220,9 @@ std::pair<bool,bool> CollisionIndex::placeLineFeature(CollisionFeature& feature,
         labelPlaneMatrix,
         /*return tile distance*/ true);
 
-    bool collisionDetected = false;
     bool inGrid = false;
     bool entirelyOffscreen = true;
 
-    const auto tileToViewport = projectedAnchor.first * textPixelRatio;
     // pixelsToTileUnits is used for translating line geometry to tile units
     // ... so we care about 'scale' but not 'perspectiveRatio'
     // equivalent to pixel_to_tile_units
@@ -201,21 +294,9 @@ std::pair<bool,bool> CollisionIndex::placeLineFeature(CollisionFeature& feature,
         
         entirelyOffscreen &= isOffscreen(circle);
         inGrid |= isInsideGrid(circle);
-
-        if (!allowOverlap) {
-            if (collisionGrid.hitTest({{circle.px, circle.py}, circle.radius})) {
-                if (!collisionDebug) {
-                    return {false, false};
-                } else {
-                    // Don't early exit if we're showing the debug circles because we still want to calculate
-                    // which circles are in use
-                    collisionDetected = true;
-                }
-            }
-        }
     }
 
-    return {!collisionDetected && firstAndLastGlyph && inGrid, entirelyOffscreen};
+    return { firstAndLastGlyph && inGrid, entirelyOffscreen };
 }
 
 
@@ -304,35 +385,32 @@ std::unordered_map<uint32_t, std::vector<IndexedSubfeature>> CollisionIndex::que
 }
 
 std::pair<float,float> CollisionIndex::projectAnchor(const mat4& posMatrix, const Point<float>& point) const {
-    vec4 p = {{ point.x, point.y, 0, 1 }};
-    matrix::transformMat4(p, p, posMatrix);
+    const auto p = projectToClip(posMatrix, point);
     return std::make_pair(
-        0.5 + 0.5 * (transformState.getCameraToCenterDistance() / p[3]),
-        p[3]
+        0.5 + 0.5 * (transformState.getCameraToCenterDistance() / p[2]),
+        p[2]
     );
 }
 
 std::pair<Point<float>,float> CollisionIndex::projectAndGetPerspectiveRatio(const mat4& posMatrix, const Point<float>& point) const {
-    vec4 p = {{ point.x, point.y, 0, 1 }};
-    matrix::transformMat4(p, p, posMatrix);
+    const auto p = projectToClip(posMatrix, point);
     return std::make_pair(
         Point<float>(
-            (((p[0]  / p[3] + 1) / 2) * transformState.getSize().width) + viewportPadding,
-            (((-p[1] / p[3] + 1) / 2) * transformState.getSize().height) + viewportPadding
+            (((p[0]  / p[2] + 1) / 2) * transformState.getSize().width) + viewportPadding,
+            (((-p[1] / p[2] + 1) / 2) * transformState.getSize().height) + viewportPadding
         ),
         // See perspective ratio comment in symbol_sdf.vertex
         // We're doing collision detection in viewport space so we need
         // to scale down boxes in the distance
-        0.5 + 0.5 * (transformState.getCameraToCenterDistance() / p[3])
+        0.5 + 0.5 * (transformState.getCameraToCenterDistance() / p[2])
     );
 }
 
 Point<float> CollisionIndex::projectPoint(const mat4& posMatrix, const Point<float>& point) const {
-    vec4 p = {{ point.x, point.y, 0, 1 }};
-    matrix::transformMat4(p, p, posMatrix);
+    const auto p = projectToClip(posMatrix, point);
     return Point<float>(
-        (((p[0]  / p[3] + 1) / 2) * transformState.getSize().width) + viewportPadding,
-        (((-p[1] / p[3] + 1) / 2) * transformState.getSize().height) + viewportPadding
+        (((p[0]  / p[2] + 1) / 2) * transformState.getSize().width) + viewportPadding,
+        (((-p[1] / p[2] + 1) / 2) * transformState.getSize().height) + viewportPadding
     );
 }
 
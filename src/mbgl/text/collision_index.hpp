@@ -17,6 +17,31 @@ public:
 
     explicit CollisionIndex(const TransformState&);
 
+    // A collision feature projected to the viewport: whether it can be placed at all, and
+    // whether it is entirely outside the viewport.
+    struct ProjectedFeature {
+        bool fits = false;
+        bool offscreen = true;
+    };
+
+    // Projects the feature's collision boxes without looking at the index. This only touches
+    // the feature, so different features can be projected concurrently.
+    ProjectedFeature projectFeature(CollisionFeature& feature,
+                                    const mat4& posMatrix,
+                                    const mat4& labelPlaneMatrix,
+                                    const float textPixelRatio,
+                                    const PlacedSymbol& symbol,
+                                    const float scale,
+                                    const float fontSize,
+                                    const bool pitchWithMap) const;
+
+    // Tests a projected feature against the features inserted so far. Returns whether it can
+    // be placed, and whether it is offscreen.
+    std::pair<bool,bool> placeProjectedFeature(const CollisionFeature& feature,
+                                               const ProjectedFeature&,
+                                               const bool allowOverlap,
+                                               const bool collisionDebug) const;
+
     std::pair<bool,bool> placeFeature(CollisionFeature& feature,
                                       const mat4& posMatrix,
                                       const mat4& labelPlaneMatrix,
@@ -35,19 +60,18 @@ public:
 private:
     bool isOffscreen(const CollisionBox&) const;
     bool isInsideGrid(const CollisionBox&) const;
+    bool circlesAreOutsideGrid(const CollisionFeature&, const mat4& posMatrix, const float viewportRadius) const;
 
-    std::pair<bool,bool> placeLineFeature(CollisionFeature& feature,
-                                  const mat4& posMatrix,
-                                  const mat4& labelPlaneMatrix,
-                                  const float textPixelRatio,
-                                  PlacedSymbol& symbol,
-                                  const float scale,
-                                  const float fontSize,
-                                  const bool allowOverlap,
-                                  const bool pitchWithMap,
-                                  const bool collisionDebug);
+    ProjectedFeature projectLineFeature(CollisionFeature& feature,
+                                        const mat4& posMatrix,
+                                        const mat4& labelPlaneMatrix,
+                                        const float textPixelRatio,
+                                        const PlacedSymbol& symbol,
+                                        const float scale,
+                                        const float fontSize,
+                                        const bool pitchWithMap) const;
     
-    float approximateTileDistance(const TileDistance& tileDistance, const float lastSegmentAngle, const float pixelsToTileUnits, const float cameraToAnchorDistance, const bool pitchWithMap);
+    float approximateTileDistance(const TileDistance& tileDistance, const float lastSegmentAngle, const float pixelsToTileUnits, const float cameraToAnchorDistance, const bool pitchWithMap) const;
     
     std::pair<float,float> projectAnchor(const mat4& posMatrix, const Point<float>& point) const;
     std::pair<Point<float>,float> projectAndGetPerspectiveRatio(const mat4& posMatrix, const Point<float>& point) const;
@@ -4,13 +4,46 @@
 #include <mbgl/renderer/render_tile.hpp>
 #include <mbgl/tile/tile.hpp>
 
+#include <algorithm>
+
 namespace mbgl {
 
+namespace {
+
+// The size of the grid cells that indexed symbols are sorted by, in the ~4px units of
+// TileLayerIndex::getScaledCoordinates.
+const int64_t cellSize = 16;
+
+// Above this many cells per axis, looking at all the symbols with a key is cheaper.
+const int64_t maxCellSpan = 4;
+
+int64_t cellCoordinate(int64_t coordinate) {
+    // Rounds towards negative infinity, since symbols in the tile buffer can be negative.
+    return coordinate >= 0 ? coordinate / cellSize : -((cellSize - 1 - coordinate) / cellSize);
+}
+
+// Cells are ordered by row, so that consecutive cells of a row are contiguous.
+using Cell = std::pair<int64_t, int64_t>;
+
+Cell cellOf(const Point<int64_t>& coord) {
+    return { cellCoordinate(coord.y), cellCoordinate(coord.x) };
+}
+
+} // namespace
 
 TileLayerIndex::TileLayerIndex(OverscaledTileID coord_, std::vector<SymbolInstance>& symbolInstances, uint32_t bucketInstanceId_)
     : coord(coord_), bucketInstanceId(bucketInstanceId_) {
         for (SymbolInstance& symbolInstance : symbolInstances) {
-            indexedSymbolInstances[symbolInstance.key].emplace_back(symbolInstance.crossTileID, getScaledCoordinates(symbolInstance, coord));
+            auto& instances = indexedSymbolInstances[symbolInstance.key];
+            instances.emplace_back(symbolInstance.crossTileID, getScaledCoordinates(symbolInstance, coord), static_cast<uint32_t>(instances.size()));
+        }
+
+        for (auto& entry : indexedSymbolInstances) {
+            std::sort(entry.second.begin(), entry.second.end(), [](const IndexedSymbolInstance& a, const IndexedSymbolInstance& b) {
+                const Cell cellA = cellOf(a.coord);
+                const Cell cellB = cellOf(b.coord);
+                return cellA < cellB || (cellA == cellB && a.order < b.order);
+            });
         }
     }
 
@@ -24,7 +57,7 @@ Point<int64_t> TileLayerIndex::getScaledCoordinates(SymbolInstance& symbolInstan
     };
 }
 
-void TileLayerIndex::findMatches(std::vector<SymbolInstance>& symbolInstances, const OverscaledTileID& newCoord, std::set<uint32_t>& zoomCrossTileIDs) {
+void TileLayerIndex::findMatches(std::vector<SymbolInstance>& symbolInstances, const OverscaledTileID& newCoord, std::unordered_set<uint32_t>& zoomCrossTileIDs) {
     float tolerance = coord.canonical.z < newCoord.canonical.z ? 1 : std::pow(2, coord.canonical.z - newCoord.canonical.z);
 
     for (auto& symbolInstance : symbolInstances) {
@@ -41,19 +74,48 @@ void TileLayerIndex::findMatches(std::vector<SymbolInstance>& symbolInstances, c
 
         auto scaledSymbolCoord = getScaledCoordinates(symbolInstance, newCoord);
 
-        for (IndexedSymbolInstance& thisTileSymbol: it->second) {
-            // Return any symbol with the same keys whose coordinates are within 1
-            // grid unit. (with a 4px grid, this covers a 12px by 12px area)
-            if (std::abs(thisTileSymbol.coord.x - scaledSymbolCoord.x) <= tolerance &&
+        // Match the first symbol with the same key whose coordinates are within 1
+        // grid unit. (with a 4px grid, this covers a 12px by 12px area)
+        const IndexedSymbolInstance* match = nullptr;
+        auto test = [&](const IndexedSymbolInstance& thisTileSymbol) {
+            if ((!match || thisTileSymbol.order < match->order) &&
+                std::abs(thisTileSymbol.coord.x - scaledSymbolCoord.x) <= tolerance &&
                 std::abs(thisTileSymbol.coord.y - scaledSymbolCoord.y) <= tolerance &&
                 zoomCrossTileIDs.find(thisTileSymbol.crossTileID) == zoomCrossTileIDs.end()) {
-                // Once we've marked ourselves duplicate against this parent symbol,
-                // don't let any other symbols at the same zoom level duplicate against
-                // the same parent (see issue #10844)
-                zoomCrossTileIDs.insert(thisTileSymbol.crossTileID);
-                symbolInstance.crossTileID = thisTileSymbol.crossTileID;
-                break;
+                match = &thisTileSymbol;
             }
+        };
+
+        const auto& instances = it->second;
+        const Cell minCell = cellOf({ static_cast<int64_t>(std::floor(scaledSymbolCoord.x - tolerance)),
+                                      static_cast<int64_t>(std::floor(scaledSymbolCoord.y - tolerance)) });
+        const Cell maxCell = cellOf({ static_cast<int64_t>(std::ceil(scaledSymbolCoord.x + tolerance)),
+                                      static_cast<int64_t>(std::ceil(scaledSymbolCoord.y + tolerance)) });
+
+        if (maxCell.first - minCell.first >= maxCellSpan || maxCell.second - minCell.second >= maxCellSpan) {
+            for (const IndexedSymbolInstance& thisTileSymbol : instances) {
+                test(thisTileSymbol);
+            }
+        } else {
+            for (int64_t row = minCell.first; row <= maxCell.first; ++row) {
+                const Cell first { row, minCell.second };
+                const Cell last { row, maxCell.second };
+                auto cellIt = std::lower_bound(instances.begin(), instances.end(), first,
+                    [](const IndexedSymbolInstance& indexed, const Cell& cell) {
+                        return cellOf(indexed.coord) < cell;
+                    });
+                for (; cellIt != instances.end() && cellOf(cellIt->coord) <= last; ++cellIt) {
+                    test(*cellIt);
+                }
+            }
+        }
+
+        if (match) {
+            // Once we've marked ourselves duplicate against this parent symbol,
+            // don't let any other symbols at the same zoom level duplicate against
+            // the same parent (see issue #10844)
+            zoomCrossTileIDs.insert(match->crossTileID);
+            symbolInstance.crossTileID = match->crossTileID;
         }
     }
 }
@@ -108,7 +170,7 @@ bool CrossTileSymbolLayerIndex::addBucket(const OverscaledTileID& tileID, Symbol
 
     for (auto& it : indexes) {
         auto zoom = it.first;
-        auto zoomIndexes = it.second;
+        auto& zoomIndexes = it.second;
         if (zoom > tileID.overscaledZ) {
             for (auto& childIndex : zoomIndexes) {
                 if (childIndex.second.coord.isChildOf(tileID)) {
@@ -139,8 +201,8 @@ bool CrossTileSymbolLayerIndex::addBucket(const OverscaledTileID& tileID, Symbol
 }
 
 void CrossTileSymbolLayerIndex::removeBucketCrossTileIDs(uint8_t zoom, const TileLayerIndex& removedBucket) {
-    for (auto key : removedBucket.indexedSymbolInstances) {
-        for (auto indexedSymbolInstance : key.second) {
+    for (const auto& key : removedBucket.indexedSymbolInstances) {
+        for (const auto& indexedSymbolInstance : key.second) {
             usedCrossTileIDs[zoom].erase(indexedSymbolInstance.crossTileID);
         }
     }
@@ -203,7 +265,7 @@ bool CrossTileSymbolIndex::addLayer(RenderSymbolLayer& symbolLayer, float lng) {
 
 void CrossTileSymbolIndex::pruneUnusedLayers(const std::set<std::string>& usedLayers) {
     std::vector<std::string> unusedLayers;
-    for (auto layerIndex : layerIndexes) {
+    for (const auto& layerIndex : layerIndexes) {
         if (usedLayers.find(layerIndex.first) == usedLayers.end()) {
             unusedLayers.push_back(layerIndex.first);
         }
@@ -10,6 +10,7 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace mbgl {
@@ -20,12 +21,14 @@ class SymbolBucket;
 
 class IndexedSymbolInstance {
 public:
-    IndexedSymbolInstance(uint32_t crossTileID_, Point<int64_t> coord_)
-        : crossTileID(crossTileID_), coord(coord_)
+    IndexedSymbolInstance(uint32_t crossTileID_, Point<int64_t> coord_, uint32_t order_)
+        : crossTileID(crossTileID_), coord(coord_), order(order_)
     {}
 
     uint32_t crossTileID;
     Point<int64_t> coord;
+    // The position of the symbol among the bucket's symbols with the same key.
+    uint32_t order;
 };
 
 class TileLayerIndex {
@@ -33,11 +36,14 @@ public:
     TileLayerIndex(OverscaledTileID coord, std::vector<SymbolInstance>&, uint32_t bucketInstanceId);
 
     Point<int64_t> getScaledCoordinates(SymbolInstance&, const OverscaledTileID&);
-    void findMatches(std::vector<SymbolInstance>&, const OverscaledTileID&, std::set<uint32_t>&);
+    void findMatches(std::vector<SymbolInstance>&, const OverscaledTileID&, std::unordered_set<uint32_t>&);
     
     OverscaledTileID coord;
     uint32_t bucketInstanceId;
-    std::map<std::u16string,std::vector<IndexedSymbolInstance>> indexedSymbolInstances;
+
+    // The symbols with each key, sorted by the cell of a coarse grid that they fall in, so that
+    // finding the symbols near a position only needs to look at the cells around it.
+    std::unordered_map<std::u16string, std::vector<IndexedSymbolInstance>> indexedSymbolInstances;
 };
 
 class CrossTileSymbolLayerIndex {
@@ -50,7 +56,7 @@ private:
     void removeBucketCrossTileIDs(uint8_t zoom, const TileLayerIndex& removedBucket);
 
     std::map<uint8_t, std::map<OverscaledTileID,TileLayerIndex>> indexes;
-    std::map<uint8_t, std::set<uint32_t>> usedCrossTileIDs;
+    std::map<uint8_t, std::unordered_set<uint32_t>> usedCrossTileIDs;
     float lng = 0;
 };
 
@@ -10,10 +10,13 @@ namespace mbgl {
 
 static GlyphManagerObserver nullObserver;
 
-GlyphManager::GlyphManager(FileSource& fileSource_, std::unique_ptr<LocalGlyphRasterizer> localGlyphRasterizer_)
+GlyphManager::GlyphManager(FileSource& fileSource_,
+                           std::unique_ptr<LocalGlyphRasterizer> localGlyphRasterizer_,
+                           bool useSharedAtlas)
     : fileSource(fileSource_),
       observer(&nullObserver),
-      localGlyphRasterizer(std::move(localGlyphRasterizer_)) {
+      localGlyphRasterizer(std::move(localGlyphRasterizer_)),
+      sharedAtlas(useSharedAtlas ? std::make_unique<SharedGlyphAtlas>() : nullptr) {
 }
 
 GlyphManager::~GlyphManager() = default;
@@ -142,7 +145,12 @@ void GlyphManager::notify(GlyphRequestor& requestor, const GlyphDependencies& gl
         }
     }
 
-    requestor.onGlyphsAvailable(response);
+    optional<GlyphPositions> positions;
+    if (sharedAtlas) {
+        positions = sharedAtlas->addGlyphs(requestor, response);
+    }
+
+    requestor.onGlyphsAvailable(response, std::move(positions));
 }
 
 void GlyphManager::removeRequestor(GlyphRequestor& requestor) {
@@ -151,6 +159,10 @@ void GlyphManager::removeRequestor(GlyphRequestor& requestor) {
             range.second.requestors.erase(&requestor);
         }
     }
+
+    if (sharedAtlas) {
+        sharedAtlas->removeRequestor(requestor);
+    }
 }
 
 } // namespace mbgl
@@ -4,10 +4,13 @@
 #include <mbgl/text/glyph_manager_observer.hpp>
 #include <mbgl/text/glyph_range.hpp>
 #include <mbgl/text/local_glyph_rasterizer.hpp>
+#include <mbgl/text/shaping_cache.hpp>
+#include <mbgl/text/shared_glyph_atlas.hpp>
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/font_stack.hpp>
 #include <mbgl/util/immutable.hpp>
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 
@@ -20,12 +23,15 @@ class Response;
 class GlyphRequestor {
 public:
     virtual ~GlyphRequestor() = default;
-    virtual void onGlyphsAvailable(GlyphMap) = 0;
+    // When the manager has a shared atlas, the positions of the glyphs in it are provided too.
+    virtual void onGlyphsAvailable(GlyphMap, optional<GlyphPositions>) = 0;
 };
 
 class GlyphManager : public util::noncopyable {
 public:
-    GlyphManager(FileSource&, std::unique_ptr<LocalGlyphRasterizer> = std::make_unique<LocalGlyphRasterizer>(optional<std::string>()));
+    GlyphManager(FileSource&,
+                 std::unique_ptr<LocalGlyphRasterizer> = std::make_unique<LocalGlyphRasterizer>(optional<std::string>()),
+                 bool useSharedAtlas = false);
     ~GlyphManager();
 
     // Workers send a `getGlyphs` message to the main thread once they have determined
@@ -42,6 +48,16 @@ public:
 
     void setObserver(GlyphManagerObserver*);
 
+    // Shared with the workers, which shape text with the glyphs that this manager provides.
+    std::shared_ptr<ShapingCache> getShapingCache() const {
+        return shapingCache;
+    }
+
+    // The atlas that holds the glyphs of all requestors, if this manager was created with one.
+    SharedGlyphAtlas* getSharedAtlas() {
+        return sharedAtlas.get();
+    }
+
 private:
     Glyph generateLocalSDF(const FontStack& fontStack, GlyphID glyphID);
 
@@ -68,6 +84,10 @@ private:
     GlyphManagerObserver* observer = nullptr;
     
     std::unique_ptr<LocalGlyphRasterizer> localGlyphRasterizer;
+
+    std::shared_ptr<ShapingCache> shapingCache = std::make_shared<ShapingCache>();
+
+    std::unique_ptr<SharedGlyphAtlas> sharedAtlas;
 };
 
 } // namespace mbgl
@@ -0,0 +1,54 @@
+#include <mbgl/text/pauseable_placement.hpp>
+#include <mbgl/renderer/layers/render_symbol_layer.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+
+PauseablePlacement::PauseablePlacement(const TransformState& state,
+                                       MapMode mapMode,
+                                       const mat4& projMatrix_,
+                                       bool showCollisionBoxes_,
+                                       std::vector<std::string> layerIDs_,
+                                       const Placement& prevPlacement,
+                                       Scheduler* workers)
+    : placement(std::make_unique<Placement>(state, mapMode, workers)),
+      projMatrix(projMatrix_),
+      showCollisionBoxes(showCollisionBoxes_),
+      layerIDs(std::move(layerIDs_)) {
+    placement->reuse(prevPlacement);
+}
+
+void PauseablePlacement::continuePlacement(const std::vector<std::reference_wrapper<RenderSymbolLayer>>& layers,
+                                           optional<TimePoint> deadline) {
+    assert(layers.size() == layerIDs.size());
+
+    auto shouldPause = [&] {
+        return deadline && Clock::now() >= *deadline;
+    };
+
+    while (currentLayer < layers.size()) {
+        if (!placement->placeLayer(layers[currentLayer], projMatrix, showCollisionBoxes, layerProgress, shouldPause)) {
+            break;
+        }
+
+        currentLayer++;
+        layerProgress = {};
+
+        if (currentLayer < layers.size() && shouldPause()) {
+            break;
+        }
+    }
+}
+
+bool PauseablePlacement::isDone() const {
+    return currentLayer == layerIDs.size();
+}
+
+std::unique_ptr<Placement> PauseablePlacement::commit(const Placement& prevPlacement, TimePoint now) {
+    assert(isDone());
+    placement->commit(prevPlacement, now);
+    return std::move(placement);
+}
+
+} // namespace mbgl
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <mbgl/text/placement.hpp>
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+class RenderSymbolLayer;
+
+// A placement that can be spread over several frames, placing layers and their tiles in order
+// until a deadline passes, while the previous placement keeps being rendered. The camera and the
+// layers are fixed when it starts: if the layers change, the placement must be started again.
+class PauseablePlacement {
+public:
+    PauseablePlacement(const TransformState&,
+                       MapMode,
+                       const mat4& projMatrix,
+                       bool showCollisionBoxes,
+                       std::vector<std::string> layerIDs,
+                       const Placement& prevPlacement,
+                       Scheduler* workers);
+
+    // Continues placing `layers`, which must match the layer IDs the placement was started
+    // with, until all of them are placed or `deadline` passes. At least one tile is placed.
+    void continuePlacement(const std::vector<std::reference_wrapper<RenderSymbolLayer>>& layers,
+                           optional<TimePoint> deadline);
+
+    bool isDone() const;
+
+    const std::vector<std::string>& getLayerIDs() const {
+        return layerIDs;
+    }
+
+    // Commits the finished placement against the one rendered so far.
+    std::unique_ptr<Placement> commit(const Placement& prevPlacement, TimePoint);
+
+private:
+    std::unique_ptr<Placement> placement;
+    const mat4 projMatrix;
+    const bool showCollisionBoxes;
+    const std::vector<std::string> layerIDs;
+
+    std::size_t currentLayer = 0;
+    LayerPlacementProgress layerProgress;
+};
+
+} // namespace mbgl
@@ -5,6 +5,13 @@
 #include <mbgl/tile/geometry_tile.hpp>
 #include <mbgl/renderer/buckets/symbol_bucket.hpp>
 #include <mbgl/renderer/bucket.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/mat4.hpp>
+#include <mbgl/util/parallel_for.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
 namespace mbgl {
 
@@ -34,17 +41,61 @@ bool JointOpacityState::isHidden() const {
     return icon.isHidden() && text.isHidden();
 }
 
-Placement::Placement(const TransformState& state_, MapMode mapMode_)
+Placement::Placement(const TransformState& state_, MapMode mapMode_, Scheduler* workers_)
     : collisionIndex(state_)
+    , workers(workers_)
     , state(state_)
     , mapMode(mapMode_)
 {}
 
-void Placement::placeLayer(RenderSymbolLayer& symbolLayer, const mat4& projMatrix, bool showCollisionBoxes) {
+void Placement::reuse(const Placement& prevPlacement) {
+    if (mapMode == MapMode::Continuous && prevPlacement.reusable) {
+        reusablePlacement = &prevPlacement;
+    }
+}
 
-    std::unordered_set<uint32_t> seenCrossTileIDs;
+void Placement::placeLayer(RenderSymbolLayer& symbolLayer, const mat4& projMatrix_, bool showCollisionBoxes) {
+    LayerPlacementProgress progress;
+    placeLayer(symbolLayer, projMatrix_, showCollisionBoxes, progress, [] { return false; });
+}
 
-    for (RenderTile& renderTile : symbolLayer.renderTiles) {
+bool Placement::placeLayer(RenderSymbolLayer& symbolLayer, const mat4& projMatrix_, bool showCollisionBoxes,
+                           LayerPlacementProgress& progress, const std::function<bool()>& shouldPause) {
+    projMatrix = projMatrix_;
+    placedWithCollisionBoxes = showCollisionBoxes;
+
+    // Buckets keep the collision boxes they were last projected with, in viewport pixels, so
+    // they can only be reused in a viewport of the same size. Whether the camera moved too far
+    // for them is decided for each bucket.
+    if (reusablePlacement && (reusablePlacement->state.getSize() != state.getSize() ||
+                              reusablePlacement->placedWithCollisionBoxes != showCollisionBoxes)) {
+        reusablePlacement = nullptr;
+    }
+    auto& seenCrossTileIDs = progress.seenCrossTileIDs;
+
+    if (!progress.tileIDs) {
+        progress.tileIDs.emplace();
+        for (const RenderTile& renderTile : symbolLayer.renderTiles) {
+            progress.tileIDs->push_back(renderTile.id);
+        }
+    }
+
+    // At least one tile is placed per call, so that placing progresses even past the deadline.
+    for (bool first = true; progress.tileIndex < progress.tileIDs->size(); first = false) {
+        if (!first && shouldPause()) {
+            return false;
+        }
+
+        const UnwrappedTileID& tileID = (*progress.tileIDs)[progress.tileIndex++];
+        auto it = std::find_if(symbolLayer.renderTiles.begin(), symbolLayer.renderTiles.end(),
+                               [&](const RenderTile& renderTile) { return renderTile.id == tileID; });
+        if (it == symbolLayer.renderTiles.end()) {
+            // The tile stopped being rendered since placing the layer started. Tiles that
+            // started being rendered since are left to the next placement.
+            continue;
+        }
+
+        RenderTile& renderTile = *it;
         if (!renderTile.tile.isRenderable()) {
             continue;
         }
@@ -90,9 +141,95 @@ void Placement::placeLayer(RenderSymbolLayer& symbolLayer, const mat4& projMatri
         retainedQueryData.emplace(std::piecewise_construct,
                                   std::forward_as_tuple(symbolBucket.bucketInstanceId),
                                   std::forward_as_tuple(symbolBucket.bucketInstanceId, geometryTile.getFeatureIndex(), geometryTile.id));
-        
-        placeLayerBucket(symbolBucket, posMatrix, textLabelPlaneMatrix, iconLabelPlaneMatrix, scale, textPixelRatio, showCollisionBoxes, seenCrossTileIDs, renderTile.tile.holdForFade());
+
+        if (renderTile.tile.holdForFade()) {
+            // Holding a bucket for fading doesn't use the collision index, so it doesn't stop reuse.
+            placeLayerBucket(symbolBucket, posMatrix, textLabelPlaneMatrix, iconLabelPlaneMatrix, scale, textPixelRatio, showCollisionBoxes, *seenCrossTileIDs, true);
+            continue;
+        }
+
+        const mat4* reusedPosMatrix = nullptr;
+        if (reusablePlacement && !reuseStopped) {
+            reusedPosMatrix = reuseBucket(symbolBucket, posMatrix, *seenCrossTileIDs);
+            reuseStopped = !reusedPosMatrix;
+        }
+
+        if (reusedPosMatrix) {
+            placedBuckets[symbolBucket.bucketInstanceId] = *reusedPosMatrix;
+        } else {
+            placeLayerBucket(symbolBucket, posMatrix, textLabelPlaneMatrix, iconLabelPlaneMatrix, scale, textPixelRatio, showCollisionBoxes, *seenCrossTileIDs, false);
+            placedBuckets[symbolBucket.bucketInstanceId] = posMatrix;
+        }
+    }
+
+    return true;
+}
+
+namespace {
+
+// Collision boxes projected with a tile matrix are reused with another one if no corner of the
+// tile moves by more than this many pixels in the viewport between the two.
+constexpr double reuseTolerance = 0.5;
+
+// Anchors within the tile move by about as much as its corners at most, and the boxes around
+// them are scaled by the same projection, so their projections stay within the tolerance too.
+bool projectsWithinTolerance(const mat4& a, const mat4& b, const Size& size) {
+    for (const auto& corner : { Point<double>(0, 0), Point<double>(util::EXTENT, 0),
+                                Point<double>(0, util::EXTENT), Point<double>(util::EXTENT, util::EXTENT) }) {
+        vec4 pa, pb;
+        matrix::transformMat4(pa, {{ corner.x, corner.y, 0, 1 }}, a);
+        matrix::transformMat4(pb, {{ corner.x, corner.y, 0, 1 }}, b);
+        if (pa[3] <= 0 || pb[3] <= 0) {
+            return false;
+        }
+        const double dx = (pa[0] / pa[3] - pb[0] / pb[3]) / 2 * size.width;
+        const double dy = (pa[1] / pa[3] - pb[1] / pb[3]) / 2 * size.height;
+        if (std::abs(dx) > reuseTolerance || std::abs(dy) > reuseTolerance) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+const mat4* Placement::reuseBucket(SymbolBucket& bucket, const mat4& posMatrix, std::unordered_set<uint32_t>& seenCrossTileIDs) {
+    auto projected = reusablePlacement->placedBuckets.find(bucket.bucketInstanceId);
+    if (projected == reusablePlacement->placedBuckets.end() ||
+        !projectsWithinTolerance(projected->second, posMatrix, state.getSize())) {
+        return nullptr;
+    }
+
+    // Symbols that the previous placement placed from another tile didn't have their boxes in
+    // this bucket projected, so the bucket can only be reused if it placed all of its symbols.
+    for (const auto& symbolInstance : bucket.symbolInstances) {
+        if (seenCrossTileIDs.count(symbolInstance.crossTileID) == 0) {
+            auto prev = reusablePlacement->placements.find(symbolInstance.crossTileID);
+            if (prev == reusablePlacement->placements.end() || prev->second.bucketInstanceId != bucket.bucketInstanceId) {
+                return nullptr;
+            }
+        }
+    }
+
+    for (auto& symbolInstance : bucket.symbolInstances) {
+        if (seenCrossTileIDs.count(symbolInstance.crossTileID) == 0) {
+            const JointPlacement& prev = reusablePlacement->placements.at(symbolInstance.crossTileID);
+
+            if (prev.text) {
+                collisionIndex.insertFeature(symbolInstance.textCollisionFeature, bucket.layout.get<style::TextIgnorePlacement>(), bucket.bucketInstanceId);
+            }
+
+            if (prev.icon) {
+                collisionIndex.insertFeature(symbolInstance.iconCollisionFeature, bucket.layout.get<style::IconIgnorePlacement>(), bucket.bucketInstanceId);
+            }
+
+            placements.erase(symbolInstance.crossTileID);
+            placements.emplace(symbolInstance.crossTileID, prev);
+            seenCrossTileIDs.insert(symbolInstance.crossTileID);
+        }
     }
+
+    return &projected->second;
 }
 
 void Placement::placeLayerBucket(
@@ -109,13 +246,51 @@ void Placement::placeLayerBucket(
     auto partiallyEvaluatedTextSize = bucket.textSizeBinder->evaluateForZoom(state.getZoom());
     auto partiallyEvaluatedIconSize = bucket.iconSizeBinder->evaluateForZoom(state.getZoom());
 
-    for (auto& symbolInstance : bucket.symbolInstances) {
+    // Projecting a symbol's collision features doesn't depend on the other symbols, so it's
+    // done for all of them first, spread over the workers. They are then tested against the
+    // collision index in order, so the result doesn't depend on how the work was split.
+    struct ProjectedSymbol {
+        CollisionIndex::ProjectedFeature text;
+        CollisionIndex::ProjectedFeature icon;
+    };
+    std::vector<ProjectedSymbol> projectedSymbols;
+
+    if (!holdingForFade) {
+        projectedSymbols.resize(bucket.symbolInstances.size());
+        util::parallelFor(workers, bucket.symbolInstances.size(), 128, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                auto& symbolInstance = bucket.symbolInstances[i];
+                if (seenCrossTileIDs.count(symbolInstance.crossTileID) != 0) {
+                    continue;
+                }
+
+                if (symbolInstance.placedTextIndex) {
+                    const PlacedSymbol& placedSymbol = bucket.text.placedSymbols.at(*symbolInstance.placedTextIndex);
+                    projectedSymbols[i].text = collisionIndex.projectFeature(symbolInstance.textCollisionFeature,
+                            posMatrix, textLabelPlaneMatrix, textPixelRatio,
+                            placedSymbol, scale, evaluateSizeForFeature(partiallyEvaluatedTextSize, placedSymbol),
+                            bucket.layout.get<style::TextPitchAlignment>() == style::AlignmentType::Map);
+                }
+
+                if (symbolInstance.placedIconIndex) {
+                    const PlacedSymbol& placedSymbol = bucket.icon.placedSymbols.at(*symbolInstance.placedIconIndex);
+                    projectedSymbols[i].icon = collisionIndex.projectFeature(symbolInstance.iconCollisionFeature,
+                            posMatrix, iconLabelPlaneMatrix, textPixelRatio,
+                            placedSymbol, scale, evaluateSizeForFeature(partiallyEvaluatedIconSize, placedSymbol),
+                            bucket.layout.get<style::IconPitchAlignment>() == style::AlignmentType::Map);
+                }
+            }
+        });
+    }
+
+    for (std::size_t i = 0; i < bucket.symbolInstances.size(); ++i) {
+        auto& symbolInstance = bucket.symbolInstances[i];
 
         if (seenCrossTileIDs.count(symbolInstance.crossTileID) == 0) {
             if (holdingForFade) {
                 // Mark all symbols from this tile as "not placed", but don't add to seenCrossTileIDs, because we don't
                 // know yet if we have a duplicate in a parent tile that _should_ be placed.
-                placements.emplace(symbolInstance.crossTileID, JointPlacement(false, false, false));
+                placements.emplace(symbolInstance.crossTileID, JointPlacement(false, false, false, bucket.bucketInstanceId));
                 continue;
             }
 
@@ -124,28 +299,18 @@ void Placement::placeLayerBucket(
             bool offscreen = true;
 
             if (symbolInstance.placedTextIndex) {
-                PlacedSymbol& placedSymbol = bucket.text.placedSymbols.at(*symbolInstance.placedTextIndex);
-                const float fontSize = evaluateSizeForFeature(partiallyEvaluatedTextSize, placedSymbol);
-
-                auto placed = collisionIndex.placeFeature(symbolInstance.textCollisionFeature,
-                        posMatrix, textLabelPlaneMatrix, textPixelRatio,
-                        placedSymbol, scale, fontSize,
+                auto placed = collisionIndex.placeProjectedFeature(symbolInstance.textCollisionFeature,
+                        projectedSymbols[i].text,
                         bucket.layout.get<style::TextAllowOverlap>(),
-                        bucket.layout.get<style::TextPitchAlignment>() == style::AlignmentType::Map,
                         showCollisionBoxes);
                 placeText = placed.first;
                 offscreen &= placed.second;
             }
 
             if (symbolInstance.placedIconIndex) {
-                PlacedSymbol& placedSymbol = bucket.icon.placedSymbols.at(*symbolInstance.placedIconIndex);
-                const float fontSize = evaluateSizeForFeature(partiallyEvaluatedIconSize, placedSymbol);
-
-                auto placed = collisionIndex.placeFeature(symbolInstance.iconCollisionFeature,
-                        posMatrix, iconLabelPlaneMatrix, textPixelRatio,
-                        placedSymbol, scale, fontSize,
+                auto placed = collisionIndex.placeProjectedFeature(symbolInstance.iconCollisionFeature,
+                        projectedSymbols[i].icon,
                         bucket.layout.get<style::IconAllowOverlap>(),
-                        bucket.layout.get<style::IconPitchAlignment>() == style::AlignmentType::Map,
                         showCollisionBoxes);
                 placeIcon = placed.first;
                 offscreen &= placed.second;
@@ -179,7 +344,7 @@ void Placement::placeLayerBucket(
                 placements.erase(symbolInstance.crossTileID);
             }
             
-            placements.emplace(symbolInstance.crossTileID, JointPlacement(placeText, placeIcon, offscreen || bucket.justReloaded));
+            placements.emplace(symbolInstance.crossTileID, JointPlacement(placeText, placeIcon, offscreen || bucket.justReloaded, bucket.bucketInstanceId));
             seenCrossTileIDs.insert(symbolInstance.crossTileID);
         }
     } 
@@ -188,6 +353,16 @@ void Placement::placeLayerBucket(
 }
 
 void Placement::commit(const Placement& prevPlacement, TimePoint now) {
+    if (reusablePlacement) {
+        for (const auto& bucket : reusablePlacement->placedBuckets) {
+            if (!placedBuckets.count(bucket.first)) {
+                reusable = false;
+                break;
+            }
+        }
+        reusablePlacement = nullptr;
+    }
+
     commitTime = now;
 
     bool placementChanged = false;
@@ -242,11 +417,32 @@ void Placement::updateLayerOpacities(RenderSymbolLayer& symbolLayer) {
     }
 }
 
+namespace {
+
+// Sets `count` vertices starting at `offset` to `vertex`, recording the ones that change, and
+// advances `offset` past them.
+template <class Vertex>
+void updateVertices(gl::VertexVector<Vertex>& vertices, DirtyVertexRange& dirty,
+                    std::size_t& offset, std::size_t count, const Vertex& vertex) {
+    assert(offset + count <= vertices.vertexSize());
+    for (const std::size_t end = offset + count; offset < end; offset++) {
+        if (std::memcmp(&vertices[offset], &vertex, sizeof(Vertex)) != 0) {
+            vertices[offset] = vertex;
+            dirty.add(offset);
+        }
+    }
+}
+
+} // namespace
+
 void Placement::updateBucketOpacities(SymbolBucket& bucket, std::set<uint32_t>& seenCrossTileIDs) {
-    if (bucket.hasTextData()) bucket.text.opacityVertices.clear();
-    if (bucket.hasIconData()) bucket.icon.opacityVertices.clear();
-    if (bucket.hasCollisionBoxData()) bucket.collisionBox.dynamicVertices.clear();
-    if (bucket.hasCollisionCircleData()) bucket.collisionCircle.dynamicVertices.clear();
+    // The layout already allocated all opacity and collision debug vertices, in the same order
+    // the symbol instances are visited here, so they're overwritten in place and only the ones
+    // whose value changed are marked for upload.
+    std::size_t textVertex = 0;
+    std::size_t iconVertex = 0;
+    std::size_t collisionBoxVertex = 0;
+    std::size_t collisionCircleVertex = 0;
 
     JointOpacityState duplicateOpacityState(false, false, true);
 
@@ -274,12 +470,8 @@ void Placement::updateBucketOpacities(SymbolBucket& bucket, std::set<uint32_t>&
 
         if (symbolInstance.hasText) {
             auto opacityVertex = SymbolOpacityAttributes::vertex(opacityState.text.placed, opacityState.text.opacity);
-            for (size_t i = 0; i < symbolInstance.horizontalGlyphQuads.size() * 4; i++) {
-                bucket.text.opacityVertices.emplace_back(opacityVertex);
-            }
-            for (size_t i = 0; i < symbolInstance.verticalGlyphQuads.size() * 4; i++) {
-                bucket.text.opacityVertices.emplace_back(opacityVertex);
-            }
+            const std::size_t vertexCount = (symbolInstance.horizontalGlyphQuads.size() + symbolInstance.verticalGlyphQuads.size()) * 4;
+            updateVertices(bucket.text.opacityVertices, bucket.text.dirtyOpacityVertices, textVertex, vertexCount, opacityVertex);
             if (symbolInstance.placedTextIndex) {
                 bucket.text.placedSymbols[*symbolInstance.placedTextIndex].hidden = opacityState.isHidden();
             }
@@ -290,10 +482,7 @@ void Placement::updateBucketOpacities(SymbolBucket& bucket, std::set<uint32_t>&
         if (symbolInstance.hasIcon) {
             auto opacityVertex = SymbolOpacityAttributes::vertex(opacityState.icon.placed, opacityState.icon.opacity);
             if (symbolInstance.iconQuad) {
-                bucket.icon.opacityVertices.emplace_back(opacityVertex);
-                bucket.icon.opacityVertices.emplace_back(opacityVertex);
-                bucket.icon.opacityVertices.emplace_back(opacityVertex);
-                bucket.icon.opacityVertices.emplace_back(opacityVertex);
+                updateVertices(bucket.icon.opacityVertices, bucket.icon.dirtyOpacityVertices, iconVertex, 4, opacityVertex);
             }
             if (symbolInstance.placedIconIndex) {
                 bucket.icon.placedSymbols[*symbolInstance.placedIconIndex].hidden = opacityState.isHidden();
@@ -305,9 +494,8 @@ void Placement::updateBucketOpacities(SymbolBucket& bucket, std::set<uint32_t>&
                 return;
             }
             auto dynamicVertex = CollisionBoxDynamicAttributes::vertex(placed, false);
-            for (size_t i = 0; i < feature.boxes.size() * 4; i++) {
-                bucket.collisionBox.dynamicVertices.emplace_back(dynamicVertex);
-            }
+            updateVertices(bucket.collisionBox.dynamicVertices, bucket.collisionBox.dirtyDynamicVertices,
+                           collisionBoxVertex, feature.boxes.size() * 4, dynamicVertex);
         };
         
         auto updateCollisionCircles = [&](const auto& feature, const bool placed) {
@@ -316,10 +504,8 @@ void Placement::updateBucketOpacities(SymbolBucket& bucket, std::set<uint32_t>&
             }
             for (const CollisionBox& box : feature.boxes) {
                 auto dynamicVertex = CollisionBoxDynamicAttributes::vertex(placed, !box.used);
-                bucket.collisionCircle.dynamicVertices.emplace_back(dynamicVertex);
-                bucket.collisionCircle.dynamicVertices.emplace_back(dynamicVertex);
-                bucket.collisionCircle.dynamicVertices.emplace_back(dynamicVertex);
-                bucket.collisionCircle.dynamicVertices.emplace_back(dynamicVertex);
+                updateVertices(bucket.collisionCircle.dynamicVertices, bucket.collisionCircle.dirtyDynamicVertices,
+                               collisionCircleVertex, 4, dynamicVertex);
             }
         };
         
@@ -333,6 +519,9 @@ void Placement::updateBucketOpacities(SymbolBucket& bucket, std::set<uint32_t>&
         }
     }
 
+    assert(textVertex == bucket.text.opacityVertices.vertexSize());
+    assert(iconVertex == bucket.icon.opacityVertices.vertexSize());
+
     bucket.updateOpacity();
     bucket.sortFeatures(state.getAngle());
     auto retainedData = retainedQueryData.find(bucket.bucketInstanceId);
@@ -5,12 +5,18 @@
 #include <mbgl/util/chrono.hpp>
 #include <mbgl/text/collision_index.hpp>
 #include <mbgl/layout/symbol_projection.hpp>
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/optional.hpp>
+#include <functional>
+#include <memory>
 #include <unordered_set>
+#include <vector>
 
 namespace mbgl {
 
 class RenderSymbolLayer;
 class SymbolBucket;
+class Scheduler;
 
 class OpacityState {
 public:
@@ -32,8 +38,8 @@ public:
 
 class JointPlacement {
 public:
-    JointPlacement(bool text_, bool icon_, bool skipFade_)
-        : text(text_), icon(icon_), skipFade(skipFade_)
+    JointPlacement(bool text_, bool icon_, bool skipFade_, uint32_t bucketInstanceId_)
+        : text(text_), icon(icon_), skipFade(skipFade_), bucketInstanceId(bucketInstanceId_)
     {}
 
     const bool text;
@@ -43,6 +49,8 @@ public:
     // and if a subsequent viewport change brings them into view, they'll be fully
     // visible right away.
     const bool skipFade;
+    // The bucket whose collision features were used to place the symbol.
+    const uint32_t bucketInstanceId;
 };
     
 struct RetainedQueryData {
@@ -59,10 +67,39 @@ struct RetainedQueryData {
         , tileID(std::move(tileID_)) {}
 };
     
+// The tiles of a layer placed so far, for placing a layer across several placeLayer() calls.
+// The layer's render tiles are rebuilt every frame, so the tiles it had when placing started are
+// recorded, and the following calls continue with those of them that are still rendered.
+class LayerPlacementProgress {
+public:
+    optional<std::vector<UnwrappedTileID>> tileIDs;
+    std::size_t tileIndex = 0;
+    std::shared_ptr<std::unordered_set<uint32_t>> seenCrossTileIDs =
+        std::make_shared<std::unordered_set<uint32_t>>();
+};
+
 class Placement {
 public:
-    Placement(const TransformState&, MapMode mapMode);
+    // Collision features are projected on `workers` if given, and on the calling thread
+    // otherwise. Either way, symbols are tested against each other in the same order.
+    Placement(const TransformState&, MapMode mapMode, Scheduler* workers = nullptr);
+
+    // Makes the following placeLayer() calls reuse the collision results of `prevPlacement`,
+    // which must stay alive until commit(), for the buckets it placed, as long as their tiles
+    // moved by less than half a pixel since their collision boxes were projected. Reused symbols
+    // are inserted into the collision index as they were placed, without being projected and
+    // tested again. From the first bucket that can't be reused on, buckets are placed again in
+    // order, so that symbols keep their priority over later ones.
+    void reuse(const Placement& prevPlacement);
+
     void placeLayer(RenderSymbolLayer&, const mat4&, bool showCollisionBoxes);
+
+    // Places the layer's tiles, continuing from `progress`, until `shouldPause`, which is called
+    // after each tile, returns true. At least one tile is placed. Returns whether the layer has
+    // been placed completely.
+    bool placeLayer(RenderSymbolLayer&, const mat4&, bool showCollisionBoxes,
+                    LayerPlacementProgress&, const std::function<bool()>& shouldPause);
+
     void commit(const Placement& prevPlacement, TimePoint);
     void updateLayerOpacities(RenderSymbolLayer&);
     float symbolFadeChange(TimePoint now) const;
@@ -88,9 +125,14 @@ private:
             std::unordered_set<uint32_t>& seenCrossTileIDs,
             const bool holdingForFade);
 
+    // Returns the tile matrix the reused collision boxes were projected with, or null if the
+    // bucket can't be reused with `posMatrix`.
+    const mat4* reuseBucket(SymbolBucket&, const mat4& posMatrix, std::unordered_set<uint32_t>& seenCrossTileIDs);
+
     void updateBucketOpacities(SymbolBucket&, std::set<uint32_t>&);
 
     CollisionIndex collisionIndex;
+    Scheduler* const workers;
 
     TransformState state;
     MapMode mapMode;
@@ -103,6 +145,23 @@ private:
     bool stale = false;
     
     std::unordered_map<uint32_t, RetainedQueryData> retainedQueryData;
+
+    // The camera and debug option the layers were placed with, and the buckets whose symbols
+    // were placed rather than held for fading, with the tile matrix their collision boxes were
+    // last projected with. Used to tell whether the next placement can reuse the collision
+    // results.
+    mat4 projMatrix {};
+    bool placedWithCollisionBoxes = false;
+    std::unordered_map<uint32_t, mat4> placedBuckets;
+
+    // Cleared when a bucket placed by the previous placement went away, in which case symbols
+    // it hid may fit now: the next placement then places everything again.
+    bool reusable = true;
+
+    const Placement* reusablePlacement = nullptr;
+    // Set once a bucket had to be placed again: reused symbols aren't tested for collisions, so
+    // they can't follow symbols that were.
+    bool reuseStopped = false;
 };
 
 } // namespace mbgl
@@ -0,0 +1,105 @@
+#include <mbgl/text/shaping_cache.hpp>
+#include <mbgl/text/shaping.hpp>
+
+#include <boost/functional/hash.hpp>
+
+namespace mbgl {
+
+bool ShapingCache::Key::operator==(const Key& other) const {
+    return string == other.string &&
+           fontStack == other.fontStack &&
+           missingGlyphs == other.missingGlyphs &&
+           maxWidth == other.maxWidth &&
+           lineHeight == other.lineHeight &&
+           textAnchor == other.textAnchor &&
+           textJustify == other.textJustify &&
+           spacing == other.spacing &&
+           translate == other.translate &&
+           verticalHeight == other.verticalHeight &&
+           writingMode == other.writingMode;
+}
+
+std::size_t ShapingCache::KeyHash::operator()(const Key& key) const {
+    std::size_t seed = std::hash<std::u16string>()(key.string);
+    boost::hash_combine(seed, FontStackHash()(key.fontStack));
+    boost::hash_combine(seed, std::hash<std::u16string>()(key.missingGlyphs));
+    boost::hash_combine(seed, key.maxWidth);
+    boost::hash_combine(seed, key.lineHeight);
+    boost::hash_combine(seed, static_cast<uint8_t>(key.textAnchor));
+    boost::hash_combine(seed, static_cast<uint8_t>(key.textJustify));
+    boost::hash_combine(seed, key.spacing);
+    boost::hash_combine(seed, key.translate.x);
+    boost::hash_combine(seed, key.translate.y);
+    boost::hash_combine(seed, key.verticalHeight);
+    boost::hash_combine(seed, static_cast<uint8_t>(key.writingMode));
+    return seed;
+}
+
+ShapingCache::ShapingCache(std::size_t capacity_)
+    : capacity(capacity_) {
+}
+
+Shaping ShapingCache::getShaping(const std::u16string& string,
+                                 const FontStack& fontStack,
+                                 const float maxWidth,
+                                 const float lineHeight,
+                                 const style::SymbolAnchorType textAnchor,
+                                 const style::TextJustifyType textJustify,
+                                 const float spacing,
+                                 const Point<float>& translate,
+                                 const float verticalHeight,
+                                 const WritingModeType writingMode,
+                                 BiDi& bidi,
+                                 const Glyphs& glyphs) {
+    std::u16string missingGlyphs;
+    for (char16_t chr : string) {
+        auto it = glyphs.find(chr);
+        if (it == glyphs.end() || !it->second) {
+            missingGlyphs.push_back(chr);
+        }
+    }
+
+    Key key { string, fontStack, std::move(missingGlyphs), maxWidth, lineHeight, textAnchor,
+              textJustify, spacing, translate, verticalHeight, writingMode };
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = index.find(key);
+        if (it != index.end()) {
+            hits++;
+            entries.splice(entries.begin(), entries, it->second);
+            return it->second->second;
+        }
+        misses++;
+    }
+
+    // Shape outside of the lock so that workers missing different strings don't wait on each other.
+    Shaping shaping = mbgl::getShaping(string, maxWidth, lineHeight, textAnchor, textJustify, spacing,
+                                       translate, verticalHeight, writingMode, bidi, glyphs);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (capacity == 0 || index.find(key) != index.end()) {
+        // Another worker shaped the same string in the meantime.
+        return shaping;
+    }
+    if (entries.size() >= capacity) {
+        index.erase(entries.back().first);
+        entries.pop_back();
+    }
+    entries.emplace_front(std::move(key), shaping);
+    index.emplace(entries.front().first, entries.begin());
+    return shaping;
+}
+
+ShapingCache::Stats ShapingCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return { hits, misses, entries.size() };
+}
+
+void ShapingCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    index.clear();
+    entries.clear();
+}
+
+} // namespace mbgl
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <mbgl/text/glyph.hpp>
+#include <mbgl/style/types.hpp>
+#include <mbgl/util/font_stack.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace mbgl {
+
+class BiDi;
+
+// A bounded cache of text shapings, shared by all workers that lay out tiles for a renderer.
+// Labels such as road and place names repeat across many tiles and zoom levels, and shaping
+// them, which includes line breaking and bidirectional reordering, is costly. When the cache is
+// full, the least recently used shaping is evicted.
+class ShapingCache : private util::noncopyable {
+public:
+    explicit ShapingCache(std::size_t capacity = 4096);
+
+    // Same as the free function `getShaping`, with the font stack that `glyphs` belong to.
+    Shaping getShaping(const std::u16string& string,
+                       const FontStack&,
+                       float maxWidth,
+                       float lineHeight,
+                       style::SymbolAnchorType textAnchor,
+                       style::TextJustifyType textJustify,
+                       float spacing,
+                       const Point<float>& translate,
+                       float verticalHeight,
+                       const WritingModeType,
+                       BiDi& bidi,
+                       const Glyphs& glyphs);
+
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;
+        std::size_t size;
+    };
+    Stats getStats() const;
+
+    void clear();
+
+private:
+    class Key {
+    public:
+        std::u16string string;
+        FontStack fontStack;
+        // The code units of `string` that have no glyph. Shaping skips them, so the same text
+        // is shaped differently while some of its glyphs aren't available.
+        std::u16string missingGlyphs;
+        float maxWidth;
+        float lineHeight;
+        style::SymbolAnchorType textAnchor;
+        style::TextJustifyType textJustify;
+        float spacing;
+        Point<float> translate;
+        float verticalHeight;
+        WritingModeType writingMode;
+
+        bool operator==(const Key&) const;
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key&) const;
+    };
+
+    using Entries = std::list<std::pair<Key, Shaping>>;
+
+    const std::size_t capacity;
+
+    mutable std::mutex mutex;
+    // Ordered from the most to the least recently used.
+    Entries entries;
+    std::unordered_map<std::reference_wrapper<const Key>, Entries::iterator, KeyHash, std::equal_to<Key>> index;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+};
+
+} // namespace mbgl
@@ -0,0 +1,196 @@
+#include <mbgl/text/shared_glyph_atlas.hpp>
+#include <mbgl/gl/context.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace mbgl {
+
+// Same padding as in per-tile glyph atlases, so that positions from either kind of atlas are
+// interchangeable.
+static constexpr uint32_t padding = 1;
+
+SharedGlyphAtlas::SharedGlyphAtlas(Size initialSize, Size maxSize_)
+    : maxSize(maxSize_),
+      shelfPack(initialSize.width, initialSize.height),
+      atlasImage(initialSize) {
+}
+
+SharedGlyphAtlas::~SharedGlyphAtlas() = default;
+
+optional<GlyphPositions> SharedGlyphAtlas::addGlyphs(GlyphRequestor& requestor, const GlyphMap& glyphMap) {
+    if (overflowed.count(&requestor)) {
+        return {};
+    }
+
+    GlyphPositions result;
+    std::unordered_set<const Glyph*>& held = holdings[&requestor];
+
+    for (const auto& glyphMapEntry : glyphMap) {
+        const FontStack& fontStack = glyphMapEntry.first;
+        GlyphPositionMap& positions = result[fontStack];
+
+        for (const auto& glyphEntry : glyphMapEntry.second) {
+            if (!glyphEntry.second || !(*glyphEntry.second)->bitmap.valid()) {
+                continue;
+            }
+
+            const Immutable<Glyph>& glyph = *glyphEntry.second;
+
+            auto it = entries.find(glyph.get());
+            if (it == entries.end()) {
+                mapbox::Bin* bin = pack(glyph->bitmap.size.width + 2 * padding,
+                                        glyph->bitmap.size.height + 2 * padding);
+                if (!bin) {
+                    // Keep holding what the requestor already has, as it may still be drawn with
+                    // those positions until the requestor has built an atlas of its own.
+                    overflowed.insert(&requestor);
+                    return {};
+                }
+
+                AlphaImage::copy(glyph->bitmap,
+                                 atlasImage,
+                                 { 0, 0 },
+                                 {
+                                    bin->x + padding,
+                                    bin->y + padding
+                                 },
+                                 glyph->bitmap.size);
+                markDirty(*bin);
+
+                it = entries.emplace(glyph.get(), Entry { glyph, bin, 0 }).first;
+            }
+
+            if (held.insert(glyph.get()).second && it->second.holders++ == 0) {
+                unused.erase(glyph.get());
+            }
+
+            const mapbox::Bin& bin = *it->second.bin;
+            positions.emplace(glyph->id,
+                              GlyphPosition {
+                                 Rect<uint16_t> {
+                                     static_cast<uint16_t>(bin.x),
+                                     static_cast<uint16_t>(bin.y),
+                                     static_cast<uint16_t>(bin.w),
+                                     static_cast<uint16_t>(bin.h)
+                                 },
+                                 glyph->metrics
+                              });
+        }
+    }
+
+    return result;
+}
+
+void SharedGlyphAtlas::removeRequestor(GlyphRequestor& requestor) {
+    overflowed.erase(&requestor);
+
+    auto it = holdings.find(&requestor);
+    if (it == holdings.end()) {
+        return;
+    }
+
+    for (const Glyph* glyph : it->second) {
+        if (--entries.at(glyph).holders == 0) {
+            unused.insert(glyph);
+        }
+    }
+
+    holdings.erase(it);
+}
+
+mapbox::Bin* SharedGlyphAtlas::pack(uint32_t width, uint32_t height) {
+    mapbox::Bin* bin = shelfPack.packOne(-1, width, height);
+    while (!bin && grow()) {
+        bin = shelfPack.packOne(-1, width, height);
+    }
+    if (!bin && evictUnused()) {
+        bin = shelfPack.packOne(-1, width, height);
+    }
+    return bin;
+}
+
+bool SharedGlyphAtlas::grow() {
+    const Size size = getPixelSize();
+    const Size grown {
+        std::min(size.width * 2, maxSize.width),
+        std::min(size.height * 2, maxSize.height)
+    };
+    if (grown == size) {
+        return false;
+    }
+
+    // Growing keeps the bins where they are, so the positions that were handed out stay valid.
+    shelfPack.resize(grown.width, grown.height);
+    atlasImage.resize(grown);
+    return true;
+}
+
+bool SharedGlyphAtlas::evictUnused() {
+    if (unused.empty()) {
+        return false;
+    }
+
+    for (const Glyph* glyph : unused) {
+        auto it = entries.find(glyph);
+        assert(it != entries.end());
+
+        // Clear the glyph, so that whatever reuses its bin gets a blank padding.
+        const uint32_t x = it->second.bin->x;
+        const uint32_t y = it->second.bin->y;
+        const uint32_t w = it->second.bin->w;
+        const uint32_t h = it->second.bin->h;
+        AlphaImage::clear(atlasImage, { x, y }, { w, h });
+        markDirty(*it->second.bin);
+
+        shelfPack.unref(*it->second.bin);
+        entries.erase(it);
+    }
+
+    unused.clear();
+    return true;
+}
+
+void SharedGlyphAtlas::markDirty(const mapbox::Bin& bin) {
+    const Rect<uint32_t> rect(static_cast<uint32_t>(bin.x), static_cast<uint32_t>(bin.y),
+                              static_cast<uint32_t>(bin.w), static_cast<uint32_t>(bin.h));
+    if (!dirtyRect) {
+        dirtyRect = rect;
+        return;
+    }
+
+    const uint32_t x1 = std::min(dirtyRect->x, rect.x);
+    const uint32_t y1 = std::min(dirtyRect->y, rect.y);
+    const uint32_t x2 = std::max(dirtyRect->x + dirtyRect->w, rect.x + rect.w);
+    const uint32_t y2 = std::max(dirtyRect->y + dirtyRect->h, rect.y + rect.h);
+    dirtyRect = Rect<uint32_t>(x1, y1, x2 - x1, y2 - y1);
+}
+
+Size SharedGlyphAtlas::getPixelSize() const {
+    return Size {
+        static_cast<uint32_t>(shelfPack.width()),
+        static_cast<uint32_t>(shelfPack.height())
+    };
+}
+
+void SharedGlyphAtlas::upload(gl::Context& context, gl::TextureUnit unit) {
+    if (!atlasTexture) {
+        atlasTexture = context.createTexture(atlasImage, unit);
+    } else if (atlasTexture->size != atlasImage.size) {
+        context.updateTexture(*atlasTexture, atlasImage, unit);
+    } else if (dirtyRect) {
+        // Only the glyphs added or cleared since the last upload are copied to the texture.
+        AlphaImage region({ dirtyRect->w, dirtyRect->h });
+        AlphaImage::copy(atlasImage, region, { dirtyRect->x, dirtyRect->y }, { 0, 0 }, region.size);
+        context.updateTextureSub(*atlasTexture, region, { dirtyRect->x, dirtyRect->y }, unit);
+    }
+
+    dirtyRect = {};
+}
+
+void SharedGlyphAtlas::bind(gl::Context& context, gl::TextureUnit unit) {
+    upload(context, unit);
+    context.bindTexture(*atlasTexture, unit, gl::TextureFilter::Linear);
+}
+
+} // namespace mbgl
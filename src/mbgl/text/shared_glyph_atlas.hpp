@@ -0,0 +1,81 @@
+#pragma once
+
+#include <mbgl/text/glyph_atlas.hpp>
+#include <mbgl/gl/texture.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+#include <mbgl/util/rect.hpp>
+
+#include <mapbox/shelf-pack.hpp>
+
+#include <unordered_map>
+#include <unordered_set>
+
+namespace mbgl {
+
+namespace gl {
+class Context;
+} // namespace gl
+
+class GlyphRequestor;
+
+// A glyph atlas that is shared by all tiles of a renderer, so that glyphs used by many tiles are
+// copied and uploaded once instead of once per tile. Each requestor holds the glyphs that it was
+// given positions for until it is removed. The atlas starts small and doubles in size when it
+// fills up; once it reaches its maximum size, it makes room by evicting glyphs that no requestor
+// holds anymore.
+class SharedGlyphAtlas : private util::noncopyable {
+public:
+    SharedGlyphAtlas(Size initialSize = { 256, 256 }, Size maxSize = { 2048, 2048 });
+    ~SharedGlyphAtlas();
+
+    // Adds the glyphs that aren't in the atlas yet, and holds all of them for the requestor.
+    // Returns nothing if they don't fit; the requestor then needs to build an atlas of its own,
+    // and doesn't get any more positions from this one until it is removed.
+    optional<GlyphPositions> addGlyphs(GlyphRequestor&, const GlyphMap&);
+    void removeRequestor(GlyphRequestor&);
+
+    Size getPixelSize() const;
+
+    void upload(gl::Context&, gl::TextureUnit unit);
+    void bind(gl::Context&, gl::TextureUnit unit);
+
+    // Only for use in tests.
+    const AlphaImage& getAtlasImage() const {
+        return atlasImage;
+    }
+
+    // Only for use in tests.
+    const optional<Rect<uint32_t>>& getDirtyRect() const {
+        return dirtyRect;
+    }
+
+private:
+    mapbox::Bin* pack(uint32_t width, uint32_t height);
+    bool grow();
+    bool evictUnused();
+    void markDirty(const mapbox::Bin&);
+
+    struct Entry {
+        Immutable<Glyph> glyph;
+        mapbox::Bin* bin;
+        uint32_t holders;
+    };
+
+    const Size maxSize;
+    mapbox::ShelfPack shelfPack;
+
+    std::unordered_map<const Glyph*, Entry> entries;
+    std::unordered_set<const Glyph*> unused;
+    std::unordered_map<GlyphRequestor*, std::unordered_set<const Glyph*>> holdings;
+    std::unordered_set<GlyphRequestor*> overflowed;
+
+    AlphaImage atlasImage;
+    mbgl::optional<gl::Texture> atlasTexture;
+
+    // The part of the atlas image that changed since the last upload. Once the atlas has grown,
+    // the texture is replaced as a whole instead.
+    optional<Rect<uint32_t>> dirtyRect;
+};
+
+} // namespace mbgl
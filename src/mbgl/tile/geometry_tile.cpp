@@ -20,6 +20,7 @@
 #include <mbgl/actor/scheduler.hpp>
 
 #include <iostream>
+#include <unordered_set>
 
 namespace mbgl {
 
@@ -54,7 +55,8 @@ GeometryTile::GeometryTile(const OverscaledTileID& id_,
              obsolete,
              parameters.mode,
              parameters.pixelRatio,
-             parameters.debugOptions & MapDebugOptions::Collision),
+             parameters.debugOptions & MapDebugOptions::Collision,
+             parameters.glyphManager.getShapingCache()),
       glyphManager(parameters.glyphManager),
       imageManager(parameters.imageManager),
       mode(parameters.mode),
@@ -123,6 +125,10 @@ void GeometryTile::setShowCollisionBoxes(const bool showCollisionBoxes_) {
     }
 }
 
+void GeometryTile::setPriority(TilePriority priority) {
+    worker.setPriority(priority.toMailboxPriority());
+}
+
 void GeometryTile::onLayout(LayoutResult result, const uint64_t resultCorrelationID) {
     loaded = true;
     renderable = true;
@@ -152,8 +158,8 @@ void GeometryTile::onError(std::exception_ptr err, const uint64_t resultCorrelat
     observer->onTileError(*this, err);
 }
     
-void GeometryTile::onGlyphsAvailable(GlyphMap glyphs) {
-    worker.self().invoke(&GeometryTileWorker::onGlyphsAvailable, std::move(glyphs));
+void GeometryTile::onGlyphsAvailable(GlyphMap glyphs, optional<GlyphPositions> positions) {
+    worker.self().invoke(&GeometryTileWorker::onGlyphsAvailable, std::move(glyphs), std::move(positions));
 }
 
 void GeometryTile::getGlyphs(GlyphDependencies glyphDependencies) {
@@ -190,6 +196,19 @@ void GeometryTile::upload(gl::Context& context) {
     }
 }
 
+Size GeometryTile::bindGlyphAtlas(gl::Context& context) {
+    // Tiles whose glyphs didn't fit into the shared atlas have an atlas of their own.
+    if (glyphAtlasTexture) {
+        context.bindTexture(*glyphAtlasTexture, 0, gl::TextureFilter::Linear);
+        return glyphAtlasTexture->size;
+    }
+
+    SharedGlyphAtlas* sharedAtlas = glyphManager.getSharedAtlas();
+    assert(sharedAtlas);
+    sharedAtlas->bind(context, 0);
+    return sharedAtlas->getPixelSize();
+}
+
 Bucket* GeometryTile::getBucket(const Layer::Impl& layer) const {
     const auto it = buckets.find(layer.id);
     if (it == buckets.end()) {
@@ -200,6 +219,33 @@ Bucket* GeometryTile::getBucket(const Layer::Impl& layer) const {
     return it->second.get();
 }
 
+MemoryUsage GeometryTile::getMemoryUsage() const {
+    MemoryUsage usage;
+
+    // Layers with identical layout properties share a bucket.
+    std::unordered_set<const Bucket*> counted;
+    for (const auto& entry : buckets) {
+        if (counted.insert(entry.second.get()).second) {
+            usage += entry.second->getMemoryUsage();
+        }
+    }
+
+    if (glyphAtlasImage) {
+        usage.cpu += glyphAtlasImage->bytes();
+    }
+    if (iconAtlasImage) {
+        usage.cpu += iconAtlasImage->bytes();
+    }
+    if (glyphAtlasTexture) {
+        usage.gpu += glyphAtlasTexture->size.area();
+    }
+    if (iconAtlasTexture) {
+        usage.gpu += iconAtlasTexture->size.area() * 4;
+    }
+
+    return usage;
+}
+
 float GeometryTile::getQueryPadding(const std::vector<const RenderLayer*>& layers) {
     float queryPadding = 0;
     for (const RenderLayer* layer : layers) {
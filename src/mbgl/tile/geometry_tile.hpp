@@ -35,8 +35,9 @@ public:
 
     void setLayers(const std::vector<Immutable<style::Layer::Impl>>&) override;
     void setShowCollisionBoxes(const bool showCollisionBoxes) override;
+    void setPriority(TilePriority) override;
 
-    void onGlyphsAvailable(GlyphMap) override;
+    void onGlyphsAvailable(GlyphMap, optional<GlyphPositions>) override;
     void onImagesAvailable(ImageMap, uint64_t imageCorrelationID) override;
     
     void getGlyphs(GlyphDependencies);
@@ -44,6 +45,7 @@ public:
 
     void upload(gl::Context&) override;
     Bucket* getBucket(const style::Layer::Impl&) const override;
+    MemoryUsage getMemoryUsage() const override;
 
     Size bindGlyphAtlas(gl::Context&);
     Size bindIconAtlas(gl::Context&);
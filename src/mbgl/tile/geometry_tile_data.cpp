@@ -3,6 +3,8 @@
 
 #include <mapbox/geometry/wagyu/wagyu.hpp>
 
+#include <numeric>
+
 namespace mbgl {
 
 static double signedArea(const GeometryCoordinates& ring) {
@@ -180,4 +182,10 @@ Feature convertFeature(const GeometryTileFeature& geometryTileFeature, const Can
     return feature;
 }
 
+std::vector<std::size_t> GeometryTileLayer::getFeatureIndices(const style::FilterPredicate&) const {
+    std::vector<std::size_t> indices(featureCount());
+    std::iota(indices.begin(), indices.end(), 0);
+    return indices;
+}
+
 } // namespace mbgl
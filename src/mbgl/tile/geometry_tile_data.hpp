@@ -13,6 +13,10 @@ namespace mbgl {
 
 class CanonicalTileID;
 
+namespace style {
+class FilterPredicate;
+} // namespace style
+
 // Normalized vector tile coordinates.
 // Each geometry coordinate represents a point in a bidimensional space,
 // varying from -V...0...+V, where V is the maximum extent applicable.
@@ -56,6 +60,11 @@ public:
     // object may *not* outlive the layer object.
     virtual std::unique_ptr<GeometryTileFeature> getFeature(std::size_t) const = 0;
 
+    // Returns the positions of the features that may pass a filter with the given predicate.
+    // Layers that can check the predicate without creating feature objects leave out the
+    // features that don't meet it; this one returns all positions.
+    virtual std::vector<std::size_t> getFeatureIndices(const style::FilterPredicate&) const;
+
     virtual std::string getName() const = 0;
 };
 
@@ -14,12 +14,34 @@
 #include <mbgl/util/exception.hpp>
 #include <mbgl/util/stopwatch.hpp>
 
+#include <algorithm>
+#include <map>
 #include <unordered_set>
 
 namespace mbgl {
 
 using namespace style;
 
+namespace {
+
+std::atomic<uint64_t> abandonedParses { 0 };
+std::atomic<uint64_t> abandonedSymbolLayouts { 0 };
+std::atomic<Duration::rep> wastedWallTime { 0 };
+
+// The number of features that are read and decoded before they're added to the buckets.
+constexpr std::size_t featureBatchSize = 256;
+
+void recordObsoleteWork(std::atomic<uint64_t>& counter, const TimePoint start) {
+    ++counter;
+    wastedWallTime += (Clock::now() - start).count();
+}
+
+} // namespace
+
+GeometryTileWorker::ObsoleteWorkStats GeometryTileWorker::getObsoleteWorkStats() {
+    return { abandonedParses, abandonedSymbolLayouts, Duration(wastedWallTime) };
+}
+
 GeometryTileWorker::GeometryTileWorker(ActorRef<GeometryTileWorker> self_,
                                        ActorRef<GeometryTile> parent_,
                                        OverscaledTileID id_,
@@ -27,7 +49,8 @@ GeometryTileWorker::GeometryTileWorker(ActorRef<GeometryTileWorker> self_,
                                        const std::atomic<bool>& obsolete_,
                                        const MapMode mode_,
                                        const float pixelRatio_,
-                                       const bool showCollisionBoxes_)
+                                       const bool showCollisionBoxes_,
+                                       std::shared_ptr<ShapingCache> shapingCache_)
     : self(std::move(self_)),
       parent(std::move(parent_)),
       id(std::move(id_)),
@@ -35,6 +58,7 @@ GeometryTileWorker::GeometryTileWorker(ActorRef<GeometryTileWorker> self_,
       obsolete(obsolete_),
       mode(mode_),
       pixelRatio(pixelRatio_),
+      shapingCache(std::move(shapingCache_)),
       showCollisionBoxes(showCollisionBoxes_) {
 }
 
@@ -247,7 +271,20 @@ void GeometryTileWorker::coalesce() {
     self.invoke(&GeometryTileWorker::coalesced);
 }
 
-void GeometryTileWorker::onGlyphsAvailable(GlyphMap newGlyphMap) {
+void GeometryTileWorker::onGlyphsAvailable(GlyphMap newGlyphMap, optional<GlyphPositions> newGlyphPositions) {
+    if (!newGlyphPositions) {
+        ownGlyphAtlas = true;
+        sharedGlyphPositions = {};
+    } else if (!ownGlyphAtlas) {
+        if (!sharedGlyphPositions) {
+            sharedGlyphPositions = GlyphPositions();
+        }
+        for (auto& newFontPositions : *newGlyphPositions) {
+            (*sharedGlyphPositions)[newFontPositions.first].insert(newFontPositions.second.begin(),
+                                                                   newFontPositions.second.end());
+        }
+    }
+
     for (auto& newFontGlyphs : newGlyphMap) {
         const FontStack& fontStack = newFontGlyphs.first;
         Glyphs& newGlyphs = newFontGlyphs.second;
@@ -297,6 +334,14 @@ void GeometryTileWorker::requestNewImages(const ImageDependencies& imageDependen
     }
 }
 
+static std::vector<std::string> layerIDs(const std::vector<const RenderLayer*>& group) {
+    std::vector<std::string> result;
+    for (const auto& layer : group) {
+        result.push_back(layer->getID());
+    }
+    return result;
+}
+
 static std::vector<std::unique_ptr<RenderLayer>> toRenderLayers(const std::vector<Immutable<style::Layer::Impl>>& layers, float zoom) {
     std::vector<std::unique_ptr<RenderLayer>> renderLayers;
     renderLayers.reserve(layers.size());
@@ -321,6 +366,7 @@ void GeometryTileWorker::parse() {
     }
 
     MBGL_TIMING_START(watch)
+    const TimePoint start = Clock::now();
     std::vector<std::string> symbolOrder;
     for (auto it = layers->rbegin(); it != layers->rend(); it++) {
         if ((*it)->type == LayerType::Symbol) {
@@ -331,7 +377,7 @@ void GeometryTileWorker::parse() {
     std::unordered_map<std::string, std::unique_ptr<SymbolLayout>> symbolLayoutMap;
     buckets.clear();
     featureIndex = std::make_unique<FeatureIndex>(*data ? (*data)->clone() : nullptr);
-    BucketParameters parameters { id, mode, pixelRatio };
+    BucketParameters parameters { id, mode, pixelRatio, obsolete };
 
     GlyphDependencies glyphDependencies;
     ImageDependencies imageDependencies;
@@ -340,8 +386,13 @@ void GeometryTileWorker::parse() {
     std::vector<std::unique_ptr<RenderLayer>> renderLayers = toRenderLayers(*layers, id.overscaledZ);
     std::vector<std::vector<const RenderLayer*>> groups = groupByLayout(renderLayers);
 
+    // Layers other than symbol layers are parsed together for each source layer, so that its
+    // features are read once no matter how many layers use them.
+    std::map<std::string, std::vector<std::vector<const RenderLayer*>>> groupsBySourceLayer;
+
     for (auto& group : groups) {
         if (obsolete) {
+            recordObsoleteWork(abandonedParses, start);
             return;
         }
 
@@ -351,49 +402,47 @@ void GeometryTileWorker::parse() {
 
         const RenderLayer& leader = *group.at(0);
 
-        auto geometryLayer = (*data)->getLayer(leader.baseImpl->sourceLayer);
-        if (!geometryLayer) {
+        if (!leader.is<RenderSymbolLayer>()) {
+            groupsBySourceLayer[leader.baseImpl->sourceLayer].push_back(std::move(group));
             continue;
         }
 
-        std::vector<std::string> layerIDs;
-        for (const auto& layer : group) {
-            layerIDs.push_back(layer->getID());
+        auto geometryLayer = (*data)->getLayer(leader.baseImpl->sourceLayer);
+        if (!geometryLayer) {
+            continue;
         }
 
-        featureIndex->setBucketLayerIDs(leader.getID(), layerIDs);
-
-        if (leader.is<RenderSymbolLayer>()) {
-            auto layout = leader.as<RenderSymbolLayer>()->createLayout(
-                parameters, group, std::move(geometryLayer), glyphDependencies, imageDependencies);
-            symbolLayoutMap.emplace(leader.getID(), std::move(layout));
-            symbolLayoutsNeedPreparation = true;
-        } else {
-            const Filter& filter = leader.baseImpl->filter;
-            const std::string& sourceLayerID = leader.baseImpl->sourceLayer;
-            std::shared_ptr<Bucket> bucket = leader.createBucket(parameters, group);
-
-            for (std::size_t i = 0; !obsolete && i < geometryLayer->featureCount(); i++) {
-                std::unique_ptr<GeometryTileFeature> feature = geometryLayer->getFeature(i);
+        featureIndex->setBucketLayerIDs(leader.getID(), layerIDs(group));
 
-                if (!filter(expression::EvaluationContext { static_cast<float>(this->id.overscaledZ), feature.get() }))
-                    continue;
+        auto layout = leader.as<RenderSymbolLayer>()->createLayout(
+            parameters, group, std::move(geometryLayer), *featureIndex, glyphDependencies, imageDependencies);
+        symbolLayoutMap.emplace(leader.getID(), std::move(layout));
+        symbolLayoutsNeedPreparation = true;
+    }
 
-                GeometryCollection geometries = feature->getGeometries();
-                bucket->addFeature(*feature, geometries);
-                featureIndex->insert(geometries, i, sourceLayerID, leader.getID());
-            }
+    for (const auto& entry : groupsBySourceLayer) {
+        if (obsolete) {
+            recordObsoleteWork(abandonedParses, start);
+            return;
+        }
 
-            if (!bucket->hasData()) {
-                continue;
-            }
+        auto geometryLayer = (*data)->getLayer(entry.first);
+        if (!geometryLayer) {
+            continue;
+        }
 
-            for (const auto& layer : group) {
-                buckets.emplace(layer->getID(), bucket);
-            }
+        if (!parseSourceLayer(*geometryLayer, entry.second, parameters)) {
+            recordObsoleteWork(abandonedParses, start);
+            return;
         }
     }
 
+    // Symbol layouts stop early, without results, when they're cancelled during construction.
+    if (obsolete) {
+        recordObsoleteWork(abandonedParses, start);
+        return;
+    }
+
     symbolLayouts.clear();
     for (const auto& symbolLayerID : symbolOrder) {
         auto it = symbolLayoutMap.find(symbolLayerID);
@@ -413,6 +462,145 @@ void GeometryTileWorker::parse() {
     performSymbolLayout();
 }
 
+bool GeometryTileWorker::parseSourceLayer(const GeometryTileLayer& sourceLayer,
+                                          const std::vector<std::vector<const RenderLayer*>>& groups,
+                                          const BucketParameters& parameters) {
+    const InternedString sourceLayerID = featureIndex->intern(groups.at(0).at(0)->baseImpl->sourceLayer);
+
+    // Groups with equal filters share their evaluation, and so does the check of the filter's
+    // predicate against the source layer.
+    std::vector<const Filter*> filters;
+    std::vector<std::size_t> groupFilters;
+    for (const auto& group : groups) {
+        const Filter& filter = group.at(0)->baseImpl->filter;
+        auto it = std::find_if(filters.begin(), filters.end(), [&](const Filter* other) {
+            return *other == filter;
+        });
+        groupFilters.push_back(static_cast<std::size_t>(it - filters.begin()));
+        if (it == filters.end()) {
+            filters.push_back(&filter);
+        }
+    }
+
+    // The positions of the features that may pass each filter, in ascending order, and how far
+    // the pass below has got through each of them.
+    std::vector<std::vector<std::size_t>> candidates;
+    std::vector<bool> anyCandidate(sourceLayer.featureCount());
+    for (const Filter* filter : filters) {
+        candidates.push_back(sourceLayer.getFeatureIndices(filter->getPredicate()));
+        for (std::size_t i : candidates.back()) {
+            anyCandidate[i] = true;
+        }
+    }
+    std::vector<std::size_t> nextCandidates(filters.size(), 0);
+
+    std::vector<std::shared_ptr<Bucket>> groupBuckets;
+    std::vector<InternedString> bucketLeaderIDs;
+    for (const auto& group : groups) {
+        const RenderLayer& leader = *group.at(0);
+        featureIndex->setBucketLayerIDs(leader.getID(), layerIDs(group));
+        bucketLeaderIDs.push_back(featureIndex->intern(leader.getID()));
+        groupBuckets.push_back(leader.createBucket(parameters, group));
+    }
+
+    // Each feature that passes at least one of the filters is read once, and its geometries are
+    // decoded once for all buckets that it is added to. Features are added to the buckets in
+    // batches, so that paint properties are evaluated for many features together while only a
+    // batch of features and geometries is held at a time.
+    std::vector<std::unique_ptr<GeometryTileFeature>> features;
+    std::vector<GeometryCollection> geometries;
+    std::vector<std::size_t> indices;
+    std::vector<std::vector<std::size_t>> filterFeatures(filters.size());
+    std::vector<bool> passes(filters.size());
+
+    // Returns false if the tile became obsolete before the batch was added to all buckets.
+    auto addBatch = [&] {
+        std::vector<const GeometryTileFeature*> groupFeatures;
+        std::vector<const GeometryCollection*> groupGeometries;
+        for (std::size_t g = 0; g < groups.size(); ++g) {
+            if (obsolete) {
+                return false;
+            }
+
+            groupFeatures.clear();
+            groupGeometries.clear();
+            for (std::size_t j : filterFeatures[groupFilters[g]]) {
+                featureIndex->insert(geometries[j], indices[j], sourceLayerID, bucketLeaderIDs[g]);
+                groupFeatures.push_back(features[j].get());
+                groupGeometries.push_back(&geometries[j]);
+            }
+            if (!groupFeatures.empty()) {
+                groupBuckets[g]->addFeatures(groupFeatures, groupGeometries);
+            }
+        }
+
+        features.clear();
+        geometries.clear();
+        indices.clear();
+        for (auto& batch : filterFeatures) {
+            batch.clear();
+        }
+        return true;
+    };
+
+    for (std::size_t i = 0; i < anyCandidate.size(); ++i) {
+        if (obsolete) {
+            return false;
+        }
+
+        if (!anyCandidate[i]) {
+            continue;
+        }
+
+        std::unique_ptr<GeometryTileFeature> feature = sourceLayer.getFeature(i);
+        const expression::EvaluationContext context { static_cast<float>(this->id.overscaledZ), feature.get() };
+
+        bool anyPasses = false;
+        for (std::size_t f = 0; f < filters.size(); ++f) {
+            std::size_t& next = nextCandidates[f];
+            const bool candidate = next < candidates[f].size() && candidates[f][next] == i;
+            if (candidate) {
+                ++next;
+            }
+            passes[f] = candidate && (*filters[f])(context);
+            anyPasses = anyPasses || passes[f];
+        }
+
+        if (!anyPasses) {
+            continue;
+        }
+
+        for (std::size_t f = 0; f < filters.size(); ++f) {
+            if (passes[f]) {
+                filterFeatures[f].push_back(features.size());
+            }
+        }
+        geometries.push_back(feature->getGeometries());
+        indices.push_back(i);
+        features.push_back(std::move(feature));
+
+        if (features.size() == featureBatchSize && !addBatch()) {
+            return false;
+        }
+    }
+
+    if (!addBatch()) {
+        return false;
+    }
+
+    for (std::size_t g = 0; g < groups.size(); ++g) {
+        if (!groupBuckets[g]->hasData()) {
+            continue;
+        }
+
+        for (const auto& layer : groups[g]) {
+            buckets.emplace(layer->getID(), groupBuckets[g]);
+        }
+    }
+
+    return true;
+}
+
 bool GeometryTileWorker::hasPendingSymbolDependencies() const {
     for (auto& glyphDependency : pendingGlyphDependencies) {
         if (!glyphDependency.second.empty()) {
@@ -432,23 +620,35 @@ void GeometryTileWorker::performSymbolLayout() {
     }
     
     MBGL_TIMING_START(watch)
+    const TimePoint start = Clock::now();
     optional<AlphaImage> glyphAtlasImage;
     optional<PremultipliedImage> iconAtlasImage;
 
     if (symbolLayoutsNeedPreparation) {
-        GlyphAtlas glyphAtlas = makeGlyphAtlas(glyphMap);
-        ImageAtlas imageAtlas = makeImageAtlas(imageMap);
+        GlyphAtlas glyphAtlas;
+        if (sharedGlyphPositions) {
+            glyphAtlas.positions = *sharedGlyphPositions;
+        } else {
+            glyphAtlas = makeGlyphAtlas(glyphMap);
+            glyphAtlasImage = std::move(glyphAtlas.image);
+        }
 
-        glyphAtlasImage = std::move(glyphAtlas.image);
+        ImageAtlas imageAtlas = makeImageAtlas(imageMap);
         iconAtlasImage = std::move(imageAtlas.image);
 
         for (auto& symbolLayout : symbolLayouts) {
             if (obsolete) {
+                recordObsoleteWork(abandonedSymbolLayouts, start);
                 return;
             }
 
             symbolLayout->prepare(glyphMap, glyphAtlas.positions,
-                                  imageMap, imageAtlas.positions);
+                                  imageMap, imageAtlas.positions, *shapingCache);
+        }
+
+        if (obsolete) {
+            recordObsoleteWork(abandonedSymbolLayouts, start);
+            return;
         }
 
         symbolLayoutsNeedPreparation = false;
@@ -456,6 +656,7 @@ void GeometryTileWorker::performSymbolLayout() {
 
     for (auto& symbolLayout : symbolLayouts) {
         if (obsolete) {
+            recordObsoleteWork(abandonedSymbolLayouts, start);
             return;
         }
 
@@ -464,6 +665,10 @@ void GeometryTileWorker::performSymbolLayout() {
         }
 
         std::shared_ptr<SymbolBucket> bucket = symbolLayout->place(showCollisionBoxes);
+        if (!bucket) {
+            recordObsoleteWork(abandonedSymbolLayouts, start);
+            return;
+        }
         for (const auto& pair : symbolLayout->layerPaintProperties) {
             if (!firstLoad) {
                 bucket->justReloaded = true;
@@ -4,8 +4,10 @@
 #include <mbgl/tile/tile_id.hpp>
 #include <mbgl/style/image_impl.hpp>
 #include <mbgl/text/glyph.hpp>
+#include <mbgl/text/glyph_atlas.hpp>
 #include <mbgl/actor/actor_ref.hpp>
 #include <mbgl/util/optional.hpp>
+#include <mbgl/util/chrono.hpp>
 #include <mbgl/util/immutable.hpp>
 #include <mbgl/style/layer_impl.hpp>
 #include <mbgl/geometry/feature_index.hpp>
@@ -18,7 +20,11 @@ namespace mbgl {
 
 class GeometryTile;
 class GeometryTileData;
+class GeometryTileLayer;
+class RenderLayer;
+class BucketParameters;
 class SymbolLayout;
+class ShapingCache;
 
 namespace style {
 class Layer;
@@ -33,19 +39,36 @@ public:
                        const std::atomic<bool>&,
                        const MapMode,
                        const float pixelRatio,
-                       const bool showCollisionBoxes_);
+                       const bool showCollisionBoxes_,
+                       std::shared_ptr<ShapingCache>);
     ~GeometryTileWorker();
 
     void setLayers(std::vector<Immutable<style::Layer::Impl>>, uint64_t correlationID);
     void setData(std::unique_ptr<const GeometryTileData>, uint64_t correlationID);
     void setShowCollisionBoxes(bool showCollisionBoxes_, uint64_t correlationID_);
     
-    void onGlyphsAvailable(GlyphMap glyphs);
+    void onGlyphsAvailable(GlyphMap glyphs, optional<GlyphPositions> glyphPositions);
     void onImagesAvailable(ImageMap images, uint64_t imageCorrelationID);
 
+    // Process-wide totals of parses and symbol layouts that were abandoned because their tile
+    // became obsolete while a worker was busy with them, and of the time spent on them until then.
+    // Parses check for that between features and between the batches of features they add to
+    // buckets, symbol layouts before each feature they shape. The time is wall time rather than
+    // CPU time, so it includes any time the worker thread was descheduled.
+    struct ObsoleteWorkStats {
+        uint64_t abandonedParses;
+        uint64_t abandonedSymbolLayouts;
+        Duration wastedWallTime;
+    };
+    static ObsoleteWorkStats getObsoleteWorkStats();
+
 private:
     void coalesced();
     void parse();
+    // Returns false if the tile became obsolete before the source layer was parsed.
+    bool parseSourceLayer(const GeometryTileLayer&,
+                          const std::vector<std::vector<const RenderLayer*>>& groups,
+                          const BucketParameters&);
     void performSymbolLayout();
     
     void coalesce();
@@ -65,6 +88,7 @@ private:
     const std::atomic<bool>& obsolete;
     const MapMode mode;
     const float pixelRatio;
+    const std::shared_ptr<ShapingCache> shapingCache;
     
     std::unique_ptr<FeatureIndex> featureIndex;
     std::unordered_map<std::string, std::shared_ptr<Bucket>> buckets;
@@ -89,6 +113,10 @@ private:
     GlyphDependencies pendingGlyphDependencies;
     ImageDependencies pendingImageDependencies;
     GlyphMap glyphMap;
+    // The positions of `glyphMap` in the glyph manager's shared atlas, as long as it had room for
+    // all of them. Otherwise, each symbol layout builds an atlas of its own.
+    optional<GlyphPositions> sharedGlyphPositions;
+    bool ownGlyphAtlas = false;
     ImageMap imageMap;
     
     bool showCollisionBoxes;
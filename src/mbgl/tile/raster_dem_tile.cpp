@@ -45,7 +45,7 @@ void RasterDEMTile::setMetadata(optional<Timestamp> modified_, optional<Timestam
     expires = expires_;
 }
 
-void RasterDEMTile::setData(std::shared_ptr<const std::string> data) {
+void RasterDEMTile::setData(Blob data) {
     pending = true;
     ++correlationID;
     worker.self().invoke(&RasterDEMTileWorker::parse, data, correlationID, encoding);
@@ -80,6 +80,10 @@ Bucket* RasterDEMTile::getBucket(const style::Layer::Impl&) const {
     return bucket.get();
 }
 
+MemoryUsage RasterDEMTile::getMemoryUsage() const {
+    return bucket ? bucket->getMemoryUsage() : MemoryUsage();
+}
+
 HillshadeBucket* RasterDEMTile::getBucket() const {
     return bucket.get();
 }
@@ -122,4 +126,8 @@ void RasterDEMTile::setNecessity(TileNecessity necessity) {
     loader.setNecessity(necessity);
 }
 
+void RasterDEMTile::setPriority(TilePriority priority) {
+    worker.setPriority(priority.toMailboxPriority());
+}
+
 } // namespace mbgl
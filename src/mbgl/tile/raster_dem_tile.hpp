@@ -67,13 +67,15 @@ public:
     ~RasterDEMTile() override;
 
     void setNecessity(TileNecessity) final;
+    void setPriority(TilePriority) final;
 
     void setError(std::exception_ptr);
     void setMetadata(optional<Timestamp> modified, optional<Timestamp> expires);
-    void setData(std::shared_ptr<const std::string> data);
+    void setData(Blob data);
 
     void upload(gl::Context&) override;
     Bucket* getBucket(const style::Layer::Impl&) const override;
+    MemoryUsage getMemoryUsage() const override;
 
     HillshadeBucket* getBucket() const;
     void backfillBorder(const RasterDEMTile& borderTile, const DEMTileNeighbors mask);
@@ -34,7 +34,7 @@ void RasterTile::setMetadata(optional<Timestamp> modified_, optional<Timestamp>
     expires = expires_;
 }
 
-void RasterTile::setData(std::shared_ptr<const std::string> data) {
+void RasterTile::setData(Blob data) {
     pending = true;
     ++correlationID;
     worker.self().invoke(&RasterTileWorker::parse, data, correlationID);
@@ -68,6 +68,10 @@ Bucket* RasterTile::getBucket(const style::Layer::Impl&) const {
     return bucket.get();
 }
 
+MemoryUsage RasterTile::getMemoryUsage() const {
+    return bucket ? bucket->getMemoryUsage() : MemoryUsage();
+}
+
 void RasterTile::setMask(TileMask&& mask) {
     if (bucket) {
         bucket->setMask(std::move(mask));
@@ -78,4 +82,8 @@ void RasterTile::setNecessity(TileNecessity necessity) {
     loader.setNecessity(necessity);
 }
 
+void RasterTile::setPriority(TilePriority priority) {
+    worker.setPriority(priority.toMailboxPriority());
+}
+
 } // namespace mbgl
@@ -23,13 +23,15 @@ public:
     ~RasterTile() override;
 
     void setNecessity(TileNecessity) final;
+    void setPriority(TilePriority) final;
 
     void setError(std::exception_ptr);
     void setMetadata(optional<Timestamp> modified, optional<Timestamp> expires);
-    void setData(std::shared_ptr<const std::string> data);
+    void setData(Blob data);
 
     void upload(gl::Context&) override;
     Bucket* getBucket(const style::Layer::Impl&) const override;
+    MemoryUsage getMemoryUsage() const override;
 
     void setMask(TileMask&&) override;
 
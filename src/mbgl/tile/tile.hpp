@@ -5,8 +5,10 @@
 #include <mbgl/util/optional.hpp>
 #include <mbgl/util/feature.hpp>
 #include <mbgl/util/tile_coordinate.hpp>
+#include <mbgl/util/memory_usage.hpp>
 #include <mbgl/tile/tile_id.hpp>
 #include <mbgl/tile/tile_necessity.hpp>
+#include <mbgl/tile/tile_priority.hpp>
 #include <mbgl/renderer/tile_mask.hpp>
 #include <mbgl/renderer/bucket.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
@@ -42,12 +44,20 @@ public:
 
     virtual void setNecessity(TileNecessity) {}
 
+    // Hints the order in which worker threads should process this tile relative to others.
+    virtual void setPriority(TilePriority) {}
+
     // Mark this tile as no longer needed and cancel any pending work.
     virtual void cancel();
 
     virtual void upload(gl::Context&) = 0;
     virtual Bucket* getBucket(const style::Layer::Impl&) const = 0;
 
+    // Approximate number of bytes held by this tile's render data. Used to bound the tile cache.
+    virtual MemoryUsage getMemoryUsage() const {
+        return {};
+    }
+
     virtual void setShowCollisionBoxes(const bool) {}
     virtual void setLayers(const std::vector<Immutable<style::Layer::Impl>>&) {}
     virtual void setMask(TileMask&&) {}
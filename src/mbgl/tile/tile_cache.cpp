@@ -2,19 +2,31 @@
 #include <mbgl/tile/tile.hpp>
 
 #include <cassert>
+#include <iterator>
 
 namespace mbgl {
 
 void TileCache::setSize(size_t size_) {
     size = size_;
+    evict();
+}
+
+void TileCache::setMaximumBytes(uint64_t maximumBytes_) {
+    maximumBytes = maximumBytes_;
+    evict();
+}
 
-    while (orderedKeys.size() > size) {
-        auto key = orderedKeys.front();
+void TileCache::evict() {
+    while (!orderedKeys.empty() && (tiles.size() > size || bytes > maximumBytes)) {
+        auto it = tiles.find(orderedKeys.front());
+        assert(it != tiles.end());
+        bytes -= it->second.bytes;
+        tiles.erase(it);
         orderedKeys.pop_front();
-        tiles.erase(key);
     }
 
-    assert(orderedKeys.size() <= size);
+    assert(tiles.size() <= size);
+    assert(bytes <= maximumBytes);
 }
 
 void TileCache::add(const OverscaledTileID& key, std::unique_ptr<Tile> tile) {
@@ -22,27 +34,31 @@ void TileCache::add(const OverscaledTileID& key, std::unique_ptr<Tile> tile) {
         return;
     }
 
-    // insert new or query existing tile
-    if (tiles.emplace(key, std::move(tile)).second) {
-        // remove existing tile key
-        orderedKeys.remove(key);
+    auto it = tiles.find(key);
+    if (it != tiles.end()) {
+        // Keep the tile we already have, but treat it as the newest.
+        orderedKeys.splice(orderedKeys.end(), orderedKeys, it->second.position);
+        return;
+    }
+
+    // A tile that doesn't fit on its own would only flush everything else.
+    const uint64_t tileBytes = tile->getMemoryUsage().total();
+    if (tileBytes > maximumBytes) {
+        return;
     }
 
-    // (re-)insert tile key as newest
     orderedKeys.push_back(key);
+    tiles.emplace(key, Entry { std::move(tile), tileBytes, std::prev(orderedKeys.end()) });
+    bytes += tileBytes;
 
-    // purge oldest key/tile if necessary
-    if (orderedKeys.size() > size) {
-        pop(orderedKeys.front());
-    }
-
-    assert(orderedKeys.size() <= size);
+    // purge oldest keys/tiles if necessary
+    evict();
 }
 
 Tile* TileCache::get(const OverscaledTileID& key) {
     auto it = tiles.find(key);
     if (it != tiles.end()) {
-        return it->second.get();
+        return it->second.tile.get();
     } else {
         return nullptr;
     }
@@ -54,9 +70,10 @@ std::unique_ptr<Tile> TileCache::pop(const OverscaledTileID& key) {
 
     auto it = tiles.find(key);
     if (it != tiles.end()) {
-        tile = std::move(it->second);
+        tile = std::move(it->second.tile);
+        bytes -= it->second.bytes;
+        orderedKeys.erase(it->second.position);
         tiles.erase(it);
-        orderedKeys.remove(key);
         assert(tile->isRenderable());
     }
 
@@ -70,6 +87,7 @@ bool TileCache::has(const OverscaledTileID& key) {
 void TileCache::clear() {
     orderedKeys.clear();
     tiles.clear();
+    bytes = 0;
 }
 
 } // namespace mbgl
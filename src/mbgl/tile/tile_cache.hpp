@@ -2,20 +2,31 @@
 
 #include <mbgl/tile/tile_id.hpp>
 
+#include <cstdint>
 #include <list>
+#include <limits>
 #include <memory>
-#include <map>
+#include <unordered_map>
 
 namespace mbgl {
 
 class Tile;
 
+// Least recently used cache of tiles that dropped out of the render tree. It is bounded both by
+// the number of tiles and by their combined memory usage, as reported by Tile::getMemoryUsage()
+// when they are added.
+//
+// Tiles are looked up by hash, and every entry keeps its position in the recency list, so adding,
+// refreshing, popping and evicting a tile all take constant time regardless of the cache size.
 class TileCache {
 public:
     TileCache(size_t size_ = 0) : size(size_) {}
 
     void setSize(size_t);
     size_t getSize() const { return size; };
+    void setMaximumBytes(uint64_t);
+    uint64_t getMaximumBytes() const { return maximumBytes; }
+    uint64_t getBytes() const { return bytes; }
     void add(const OverscaledTileID& key, std::unique_ptr<Tile> data);
     std::unique_ptr<Tile> pop(const OverscaledTileID& key);
     Tile* get(const OverscaledTileID& key);
@@ -23,10 +34,23 @@ public:
     void clear();
 
 private:
-    std::map<OverscaledTileID, std::unique_ptr<Tile>> tiles;
-    std::list<OverscaledTileID> orderedKeys;
+    void evict();
+
+    // Oldest first.
+    using OrderedKeys = std::list<OverscaledTileID>;
+
+    struct Entry {
+        std::unique_ptr<Tile> tile;
+        uint64_t bytes;
+        OrderedKeys::iterator position;
+    };
+
+    std::unordered_map<OverscaledTileID, Entry> tiles;
+    OrderedKeys orderedKeys;
 
     size_t size;
+    uint64_t maximumBytes = std::numeric_limits<uint64_t>::max();
+    uint64_t bytes = 0;
 };
 
 } // namespace mbgl
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <mbgl/actor/mailbox.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <tuple>
+
+namespace mbgl {
+
+// Determines the order in which worker threads process tiles. Tiles that cover
+// the viewport come first, ranked by their distance from its center. They're
+// followed by parent and child tiles that stand in while ideal tiles are loading,
+// by prefetched tiles, and finally by tiles that are only kept in the cache.
+class TilePriority {
+public:
+    enum class Kind : uint8_t {
+        Ideal,
+        Fallback,
+        Prefetch,
+        Cache,
+    };
+
+    TilePriority(Kind kind_, uint32_t rank_ = 0)
+        : kind(kind_), rank(rank_) {
+    }
+
+    // The lowest Mailbox priority is left to actors that aren't tile workers.
+    Mailbox::Priority toMailboxPriority() const {
+        return ((Mailbox::Priority(kind) + 1) << 24) | std::min<uint32_t>(rank, 0xFFFFFF);
+    }
+
+    bool operator<(const TilePriority& rhs) const {
+        return std::tie(kind, rank) < std::tie(rhs.kind, rhs.rank);
+    }
+
+    Kind kind;
+    uint32_t rank;
+};
+
+} // namespace mbgl
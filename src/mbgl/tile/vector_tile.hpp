@@ -2,6 +2,7 @@
 
 #include <mbgl/tile/geometry_tile.hpp>
 #include <mbgl/tile/tile_loader.hpp>
+#include <mbgl/util/blob.hpp>
 
 namespace mbgl {
 
@@ -17,7 +18,7 @@ public:
 
     void setNecessity(TileNecessity) final;
     void setMetadata(optional<Timestamp> modified, optional<Timestamp> expires);
-    void setData(std::shared_ptr<const std::string> data);
+    void setData(Blob data);
 
 private:
     TileLoader<VectorTile> loader;
@@ -1,15 +1,14 @@
 #include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/style/filter.hpp>
 #include <mbgl/util/constants.hpp>
 
-namespace mbgl {
+#include <algorithm>
+#include <stdexcept>
 
-VectorTileFeature::VectorTileFeature(const mapbox::vector_tile::layer& layer,
-                                     const protozero::data_view& view)
-    : feature(view, layer) {
-}
+namespace mbgl {
 
-FeatureType VectorTileFeature::getType() const {
-    switch (feature.getType()) {
+static FeatureType toFeatureType(mapbox::vector_tile::GeomType type) {
+    switch (type) {
     case mapbox::vector_tile::GeomType::POINT:
         return FeatureType::Point;
     case mapbox::vector_tile::GeomType::LINESTRING:
@@ -21,12 +20,127 @@ FeatureType VectorTileFeature::getType() const {
     }
 }
 
+VectorTileLayerProperties::VectorTileLayerProperties(const protozero::data_view& view) {
+    protozero::pbf_reader layer(view);
+    while (layer.next()) {
+        switch (layer.tag()) {
+        case 3: // keys
+            keys.emplace_back(layer.get_string());
+            keyIndices.emplace(keys.back(), static_cast<uint32_t>(keys.size() - 1));
+            break;
+        case 4: // values
+            valueViews.emplace_back(layer.get_view());
+            break;
+        default:
+            layer.skip();
+            break;
+        }
+    }
+    values.resize(valueViews.size());
+}
+
+optional<uint32_t> VectorTileLayerProperties::getKeyIndex(const std::string& key) const {
+    auto it = keyIndices.find(key);
+    if (it == keyIndices.end()) {
+        return {};
+    }
+    return it->second;
+}
+
+const std::string& VectorTileLayerProperties::getKey(uint32_t index) const {
+    return keys.at(index);
+}
+
+const Value& VectorTileLayerProperties::getValue(uint32_t index) const {
+    optional<Value>& value = values.at(index);
+    if (!value) {
+        value = Value();
+        protozero::pbf_reader reader(valueViews[index]);
+        while (reader.next()) {
+            switch (reader.tag()) {
+            case 1: // string_value
+                *value = reader.get_string();
+                break;
+            case 2: // float_value
+                *value = static_cast<double>(reader.get_float());
+                break;
+            case 3: // double_value
+                *value = reader.get_double();
+                break;
+            case 4: // int_value
+                *value = reader.get_int64();
+                break;
+            case 5: // uint_value
+                *value = reader.get_uint64();
+                break;
+            case 6: // sint_value
+                *value = reader.get_sint64();
+                break;
+            case 7: // bool_value
+                *value = reader.get_bool();
+                break;
+            default:
+                reader.skip();
+                break;
+            }
+        }
+    }
+    return *value;
+}
+
+VectorTileFeature::VectorTileFeature(const mapbox::vector_tile::layer& layer,
+                                     const VectorTileLayerProperties& properties_,
+                                     const protozero::data_view& view_)
+    : feature(view_, layer),
+      properties(properties_),
+      view(view_) {
+}
+
+FeatureType VectorTileFeature::getType() const {
+    return toFeatureType(feature.getType());
+}
+
 optional<Value> VectorTileFeature::getValue(const std::string& key) const {
-    return feature.getValue(key);
+    const optional<uint32_t> keyIndex = properties.getKeyIndex(key);
+    if (!keyIndex) {
+        return {};
+    }
+    for (const auto& tag : getTags()) {
+        if (tag.first == *keyIndex) {
+            return properties.getValue(tag.second);
+        }
+    }
+    return {};
+}
+
+const VectorTileFeature::Tags& VectorTileFeature::getTags() const {
+    if (!tags) {
+        tags = Tags();
+        protozero::pbf_reader reader(view);
+        while (reader.next(2)) { // tags
+            const auto indices = reader.get_packed_uint32();
+            for (auto it = indices.begin(); it != indices.end(); ++it) {
+                const uint32_t key = *it;
+                if (++it == indices.end()) {
+                    throw std::runtime_error("uneven number of feature tag ids");
+                }
+                const uint32_t value = *it;
+                if (key >= properties.keyCount() || value >= properties.valueCount()) {
+                    throw std::runtime_error("feature referenced out of range key or value");
+                }
+                tags->emplace_back(key, value);
+            }
+        }
+    }
+    return *tags;
 }
 
 std::unordered_map<std::string, Value> VectorTileFeature::getProperties() const {
-    return feature.getProperties();
+    std::unordered_map<std::string, Value> result;
+    for (const auto& tag : getTags()) {
+        result.emplace(properties.getKey(tag.first), properties.getValue(tag.second));
+    }
+    return result;
 }
 
 optional<FeatureIdentifier> VectorTileFeature::getID() const {
@@ -43,9 +157,10 @@ GeometryCollection VectorTileFeature::getGeometries() const {
     }
 }
 
-VectorTileLayer::VectorTileLayer(std::shared_ptr<const std::string> data_,
-                                 const protozero::data_view& view)
-    : data(std::move(data_)), layer(view) {
+VectorTileLayer::VectorTileLayer(Blob data_,
+                                 const protozero::data_view& view,
+                                 std::shared_ptr<const VectorTileLayerProperties> properties_)
+    : data(std::move(data_)), layer(view), properties(std::move(properties_)) {
 }
 
 std::size_t VectorTileLayer::featureCount() const {
@@ -53,37 +168,146 @@ std::size_t VectorTileLayer::featureCount() const {
 }
 
 std::unique_ptr<GeometryTileFeature> VectorTileLayer::getFeature(std::size_t i) const {
-    return std::make_unique<VectorTileFeature>(layer, layer.getFeature(i));
+    return std::make_unique<VectorTileFeature>(layer, *properties, layer.getFeature(i));
 }
 
 std::string VectorTileLayer::getName() const {
     return layer.getName();
 }
 
-VectorTileData::VectorTileData(std::shared_ptr<const std::string> data_) : data(std::move(data_)) {
+std::vector<std::size_t> VectorTileLayer::getFeatureIndices(const style::FilterPredicate& predicate) const {
+    if (predicate.empty()) {
+        return GeometryTileLayer::getFeatureIndices(predicate);
+    }
+
+    std::vector<std::size_t> indices;
+
+    // Resolve the key to its index in this layer, so that features can be checked by reading
+    // their type and tags only. Whether a value passes is decided the first time a feature has
+    // it under the key, so only those values are decoded, and each of them only once.
+    optional<uint32_t> keyIndex;
+    std::vector<optional<bool>> passingValues;
+    if (predicate.key) {
+        keyIndex = properties->getKeyIndex(*predicate.key);
+        if (!keyIndex) {
+            return indices;
+        }
+        if (predicate.values) {
+            passingValues.resize(properties->valueCount());
+        }
+    }
+
+    auto passes = [&] (uint32_t valueIndex) {
+        optional<bool>& passing = passingValues[valueIndex];
+        if (!passing) {
+            const auto value = style::expression::toExpressionValue(properties->getValue(valueIndex));
+            passing = std::find(predicate.values->begin(), predicate.values->end(), value)
+                != predicate.values->end();
+        }
+        return *passing;
+    };
+
+    for (std::size_t i = 0; i < layer.featureCount(); ++i) {
+        protozero::pbf_reader feature(layer.getFeature(i));
+        FeatureType type = FeatureType::Unknown;
+        optional<bool> passingValue;
+        bool malformed = false;
+
+        while (feature.next()) {
+            switch (feature.tag()) {
+            case 2: { // tags
+                if (!keyIndex) {
+                    feature.skip();
+                    break;
+                }
+                const auto tags = feature.get_packed_uint32();
+                for (auto it = tags.begin(); it != tags.end(); ++it) {
+                    const uint32_t key = *it;
+                    if (++it == tags.end() || key >= properties->keyCount() || *it >= properties->valueCount()) {
+                        malformed = true;
+                        break;
+                    }
+                    if (key == *keyIndex && !passingValue) {
+                        passingValue = !predicate.values || passes(*it);
+                    }
+                }
+                break;
+            }
+            case 3: // type
+                type = toFeatureType(static_cast<mapbox::vector_tile::GeomType>(feature.get_enum()));
+                break;
+            default:
+                feature.skip();
+                break;
+            }
+        }
+
+        // Malformed features are kept, so that reading them reports the error as before.
+        const bool passingType = !predicate.types ||
+            std::find(predicate.types->begin(), predicate.types->end(), type) != predicate.types->end();
+        const bool passingKey = !keyIndex || (passingValue && *passingValue);
+        if (malformed || (passingType && passingKey)) {
+            indices.push_back(i);
+        }
+    }
+
+    return indices;
+}
+
+VectorTileData::VectorTileData(Blob data_) : data(std::move(data_)) {
+}
+
+VectorTileData::VectorTileData(Blob data_, std::shared_ptr<const Layers> layers_)
+    : data(std::move(data_)), layers(std::move(layers_)) {
 }
 
 std::unique_ptr<GeometryTileData> VectorTileData::clone() const {
-    return std::make_unique<VectorTileData>(data);
+    // Index the layers first, so that the clone doesn't need to do it again. Clones are made
+    // right before parsing, which needs the index anyway.
+    getLayers();
+    return std::unique_ptr<GeometryTileData>(new VectorTileData(data, layers));
 }
 
-std::unique_ptr<GeometryTileLayer> VectorTileData::getLayer(const std::string& name) const {
-    if (!parsed) {
+const VectorTileData::Layers& VectorTileData::getLayers() const {
+    if (!layers) {
         // We're parsing this lazily so that we can construct VectorTileData objects on the main
-        // thread without incurring the overhead of parsing immediately.
-        layers = mapbox::vector_tile::buffer(*data).getLayers();
-        parsed = true;
+        // thread without incurring the overhead of parsing immediately. The layers are read
+        // straight from the blob, which may be memory mapped, instead of from a string copy.
+        auto result = std::make_shared<Layers>();
+        protozero::pbf_reader tile(data.data(), data.size());
+        while (tile.next(3)) { // layers
+            const auto view = tile.get_view();
+            protozero::pbf_reader layer(view);
+            if (!layer.next(1)) { // name
+                throw std::runtime_error("Layer missing name");
+            }
+            result->emplace(layer.get_string(), view);
+        }
+        layers = std::move(result);
+    }
+    return *layers;
+}
+
+std::unique_ptr<GeometryTileLayer> VectorTileData::getLayer(const std::string& name) const {
+    const Layers& parsed = getLayers();
+    auto it = parsed.find(name);
+    if (it == parsed.end()) {
+        return nullptr;
     }
 
-    auto it = layers.find(name);
-    if (it != layers.end()) {
-        return std::make_unique<VectorTileLayer>(data, it->second);
+    std::shared_ptr<const VectorTileLayerProperties>& properties = layerProperties[name];
+    if (!properties) {
+        properties = std::make_shared<VectorTileLayerProperties>(it->second);
     }
-    return nullptr;
+    return std::make_unique<VectorTileLayer>(data, it->second, properties);
 }
 
 std::vector<std::string> VectorTileData::layerNames() const {
-    return mapbox::vector_tile::buffer(*data).layerNames();
+    std::vector<std::string> names;
+    for (const auto& layer : getLayers()) {
+        names.push_back(layer.first);
+    }
+    return names;
 }
 
 } // namespace mbgl
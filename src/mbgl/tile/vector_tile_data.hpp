@@ -1,17 +1,43 @@
 #include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/util/blob.hpp>
 
 #include <mapbox/vector_tile.hpp>
 #include <protozero/pbf_reader.hpp>
 
+#include <memory>
 #include <unordered_map>
+#include <vector>
 #include <functional>
 #include <utility>
 
 namespace mbgl {
 
+// The property keys and values of a vector tile layer, which its features refer to by index.
+// Keys are resolved to their index once per layer, and each value is decoded at most once, no
+// matter how many features share it or how often it is looked up.
+class VectorTileLayerProperties {
+public:
+    explicit VectorTileLayerProperties(const protozero::data_view&);
+
+    optional<uint32_t> getKeyIndex(const std::string&) const;
+    const std::string& getKey(uint32_t index) const;
+    const Value& getValue(uint32_t index) const;
+
+    std::size_t keyCount() const { return keys.size(); }
+    std::size_t valueCount() const { return valueViews.size(); }
+
+private:
+    std::vector<std::string> keys;
+    std::unordered_map<std::string, uint32_t> keyIndices;
+    std::vector<protozero::data_view> valueViews;
+    mutable std::vector<optional<Value>> values;
+};
+
 class VectorTileFeature : public GeometryTileFeature {
 public:
-    VectorTileFeature(const mapbox::vector_tile::layer&, const protozero::data_view&);
+    VectorTileFeature(const mapbox::vector_tile::layer&,
+                      const VectorTileLayerProperties&,
+                      const protozero::data_view&);
 
     FeatureType getType() const override;
     optional<Value> getValue(const std::string& key) const override;
@@ -20,25 +46,34 @@ public:
     GeometryCollection getGeometries() const override;
 
 private:
+    // Pairs of key and value indices, decoded from the feature's tags on the first lookup.
+    using Tags = std::vector<std::pair<uint32_t, uint32_t>>;
+    const Tags& getTags() const;
+
     mapbox::vector_tile::feature feature;
+    const VectorTileLayerProperties& properties;
+    const protozero::data_view view;
+    mutable optional<Tags> tags;
 };
 
 class VectorTileLayer : public GeometryTileLayer {
 public:
-    VectorTileLayer(std::shared_ptr<const std::string> data, const protozero::data_view&);
+    VectorTileLayer(Blob data, const protozero::data_view&, std::shared_ptr<const VectorTileLayerProperties>);
 
     std::size_t featureCount() const override;
     std::unique_ptr<GeometryTileFeature> getFeature(std::size_t i) const override;
     std::string getName() const override;
+    std::vector<std::size_t> getFeatureIndices(const style::FilterPredicate&) const override;
 
 private:
-    std::shared_ptr<const std::string> data;
+    Blob data;
     mapbox::vector_tile::layer layer;
+    std::shared_ptr<const VectorTileLayerProperties> properties;
 };
 
 class VectorTileData : public GeometryTileData {
 public:
-    VectorTileData(std::shared_ptr<const std::string> data);
+    VectorTileData(Blob data);
 
     std::unique_ptr<GeometryTileData> clone() const override;
     std::unique_ptr<GeometryTileLayer> getLayer(const std::string& name) const override;
@@ -46,9 +81,21 @@ public:
     std::vector<std::string> layerNames() const;
 
 private:
-    std::shared_ptr<const std::string> data;
-    mutable bool parsed = false;
-    mutable std::map<std::string, const protozero::data_view> layers;
+    using Layers = std::map<std::string, const protozero::data_view>;
+
+    VectorTileData(Blob data, std::shared_ptr<const Layers>);
+
+    const Layers& getLayers() const;
+
+    Blob data;
+
+    // Views into `data`, shared with clones so that the tile is only indexed once.
+    mutable std::shared_ptr<const Layers> layers;
+
+    // The properties of the layers read so far, so that getLayer() resolves them once per layer.
+    // They decode values lazily, so unlike `layers` they aren't shared with clones, which may be
+    // used on other threads.
+    mutable std::unordered_map<std::string, std::shared_ptr<const VectorTileLayerProperties>> layerProperties;
 };
 
 } // namespace mbgl
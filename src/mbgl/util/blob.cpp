@@ -0,0 +1,65 @@
+#include <mbgl/util/blob.hpp>
+
+#include <cassert>
+#include <mutex>
+
+namespace mbgl {
+
+class Blob::Storage {
+public:
+    Storage(std::shared_ptr<const std::string> string_)
+        : data(string_->data()), size(string_->size()), string(std::move(string_)) {
+        // Already a string, nothing to materialize.
+        std::call_once(materialized, [] {});
+    }
+
+    Storage(const char* data_, std::size_t size_, std::shared_ptr<const void> owner_)
+        : data(data_), size(size_), owner(std::move(owner_)) {
+    }
+
+    const std::shared_ptr<const std::string>& getString() {
+        std::call_once(materialized, [this] {
+            string = std::make_shared<const std::string>(data, size);
+        });
+        return string;
+    }
+
+    const char* const data;
+    const std::size_t size;
+
+private:
+    const std::shared_ptr<const void> owner;
+
+    // Either the string that owns the bytes, or a copy created on demand.
+    std::shared_ptr<const std::string> string;
+    std::once_flag materialized;
+};
+
+Blob::Blob(std::shared_ptr<const std::string> string) {
+    if (string) {
+        storage = std::make_shared<Storage>(std::move(string));
+    }
+}
+
+Blob::Blob(std::shared_ptr<std::string> string)
+    : Blob(std::shared_ptr<const std::string>(std::move(string))) {
+}
+
+Blob::Blob(const char* data, std::size_t size, std::shared_ptr<const void> owner)
+    : storage(std::make_shared<Storage>(data ? data : "", size, std::move(owner))) {
+    assert(data || size == 0);
+}
+
+const char* Blob::data() const {
+    return storage ? storage->data : nullptr;
+}
+
+std::size_t Blob::size() const {
+    return storage ? storage->size : 0;
+}
+
+std::shared_ptr<const std::string> Blob::string() const {
+    return storage ? storage->getString() : nullptr;
+}
+
+} // namespace mbgl
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <atomic>
+
+namespace mbgl {
+
+// A read-only view of a cancellation flag that is owned elsewhere, e.g. by the tile that a worker
+// is parsing. Long-running work polls it and bails out early once it is set. A default-constructed
+// token is never cancelled.
+class CancellationToken {
+public:
+    CancellationToken() = default;
+    CancellationToken(const std::atomic<bool>& flag_) : flag(&flag_) {}
+
+    bool isCancelled() const {
+        return flag && flag->load(std::memory_order_relaxed);
+    }
+
+private:
+    const std::atomic<bool>* flag = nullptr;
+};
+
+} // namespace mbgl
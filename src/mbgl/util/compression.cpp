@@ -6,6 +6,8 @@
 #include <zlib.h>
 #endif
 
+#include <algorithm>
+#include <cstdint>
 #include <cstdio>
 #include <cstring>
 #include <stdexcept>
@@ -66,39 +68,86 @@ std::string compress(const std::string &raw) {
     return result;
 }
 
-std::string decompress(const std::string &raw) {
-    z_stream inflate_stream;
-    memset(&inflate_stream, 0, sizeof(inflate_stream));
+namespace {
 
-    // TODO: reuse z_streams
-    if (inflateInit(&inflate_stream) != Z_OK) {
-        throw std::runtime_error("failed to initialize inflate");
+class InflateStream {
+public:
+    InflateStream() {
+        memset(&inflate_stream, 0, sizeof(inflate_stream));
+
+        // Adding 32 to the window size enables detection of gzip as well as zlib headers.
+        if (inflateInit2(&inflate_stream, MAX_WBITS + 32) != Z_OK) {
+            throw std::runtime_error("failed to initialize inflate");
+        }
     }
 
-    inflate_stream.next_in = (Bytef *)raw.data();
-    inflate_stream.avail_in = uInt(raw.size());
+    ~InflateStream() {
+        inflateEnd(&inflate_stream);
+    }
 
-    std::string result;
-    char out[15384];
+    z_stream inflate_stream;
+};
+
+// Inflates all of the data into `out`, which is grown as needed and trimmed to the inflated size.
+void inflateInto(z_stream& inflate_stream, const char* data, std::size_t size, std::string& out) {
+    inflate_stream.next_in = (Bytef *)data;
+    inflate_stream.avail_in = uInt(size);
+
+    // Gzip streams end with the inflated size modulo 2^32, so their output rarely needs to grow.
+    // The trailer isn't trusted beyond the maximum compression ratio of deflate. One extra byte
+    // lets inflate() see the end of the stream without running out of output space first.
+    std::size_t capacity = size * 4;
+    if (size >= 18 && uint8_t(data[0]) == 0x1f && uint8_t(data[1]) == 0x8b) {
+        uint32_t inflatedSize;
+        std::memcpy(&inflatedSize, data + size - 4, sizeof(inflatedSize));
+        capacity = std::min<std::size_t>(std::size_t(inflatedSize) + 1, size * 1032);
+    }
+    out.resize(std::max<std::size_t>(capacity, 1024));
 
+    std::size_t used = 0;
     int code;
     do {
-        inflate_stream.next_out = reinterpret_cast<Bytef *>(out);
-        inflate_stream.avail_out = sizeof(out);
-        code = inflate(&inflate_stream, 0);
-        // result.append(out, sizeof(out) - inflate_stream.avail_out);
-        if (result.size() < inflate_stream.total_out) {
-            result.append(out, inflate_stream.total_out - result.size());
+        if (used == out.size()) {
+            out.resize(out.size() * 2);
         }
+        inflate_stream.next_out = reinterpret_cast<Bytef *>(&out[used]);
+        inflate_stream.avail_out = uInt(out.size() - used);
+        code = inflate(&inflate_stream, Z_NO_FLUSH);
+        used = out.size() - inflate_stream.avail_out;
     } while (code == Z_OK);
 
-    inflateEnd(&inflate_stream);
-
     if (code != Z_STREAM_END) {
         throw std::runtime_error(inflate_stream.msg ? inflate_stream.msg : "decompression error");
     }
 
+    out.resize(used);
+}
+
+} // namespace
+
+class Decompressor::Stream : public InflateStream {};
+
+std::string decompress(const std::string &raw) {
+    InflateStream stream;
+    std::string result;
+    inflateInto(stream.inflate_stream, raw.data(), raw.size(), result);
     return result;
 }
+
+Decompressor::Decompressor() = default;
+Decompressor::~Decompressor() = default;
+
+Blob Decompressor::decompress(const char* data, std::size_t size) {
+    if (!stream) {
+        stream = std::make_unique<Stream>();
+    } else if (inflateReset(&stream->inflate_stream) != Z_OK) {
+        throw std::runtime_error("failed to reset inflate");
+    }
+
+    auto result = std::make_shared<std::string>();
+    inflateInto(stream->inflate_stream, data, size, *result);
+    return Blob(std::move(result));
+}
+
 } // namespace util
 } // namespace mbgl
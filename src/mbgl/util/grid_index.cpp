@@ -2,11 +2,150 @@
 #include <mbgl/geometry/feature_index.hpp>
 #include <mbgl/math/minmax.hpp>
 
-#include <unordered_set>
+#include <algorithm>
 #include <cmath>
+#include <limits>
 
 namespace mbgl {
 
+namespace {
+
+constexpr uint32_t noPending = std::numeric_limits<uint32_t>::max();
+
+// Entries of a cell are tested in blocks of this size without branching, so that the loop
+// over a block can be vectorized, and only the hits of a block are branched on.
+constexpr uint32_t blockSize = 8;
+
+// The collision tests below avoid branches for the same reason.
+
+inline bool boxesCollide(float ax1, float ay1, float ax2, float ay2,
+                         float bx1, float by1, float bx2, float by2) {
+    return (ax1 <= bx2) & (ay1 <= by2) & (ax2 >= bx1) & (ay2 >= by1);
+}
+
+inline bool circlesCollide(float ax, float ay, float ar, float bx, float by, float br) {
+    const float dx = bx - ax;
+    const float dy = by - ay;
+    const float bothRadii = ar + br;
+    return (bothRadii * bothRadii) > (dx * dx + dy * dy);
+}
+
+inline bool circleAndBoxCollide(float cx, float cy, float radius,
+                                float x1, float y1, float x2, float y2) {
+    const float halfRectWidth = (x2 - x1) / 2;
+    const float halfRectHeight = (y2 - y1) / 2;
+    const float dx = std::max(std::fabs(cx - (x1 + halfRectWidth)) - halfRectWidth, 0.0f);
+    const float dy = std::max(std::fabs(cy - (y1 + halfRectHeight)) - halfRectHeight, 0.0f);
+    return (dx * dx + dy * dy) <= (radius * radius);
+}
+
+} // namespace
+
+template <class T>
+template <std::size_t N>
+GridIndex<T>::Cells<N>::Cells(std::size_t cellCount)
+    : offsets(cellCount + 1, 0),
+      pendingHeads(cellCount, noPending) {
+}
+
+template <class T>
+template <std::size_t N>
+void GridIndex<T>::Cells<N>::insert(uint32_t uid, const Coordinates& coords, std::size_t cell) {
+    pending.push_back({ coords, uid, static_cast<uint32_t>(cell), pendingHeads[cell] });
+    pendingHeads[cell] = static_cast<uint32_t>(pending.size() - 1);
+
+    if (pending.size() >= std::max<std::size_t>(256, uids.size() / 2)) {
+        compact();
+    }
+}
+
+template <class T>
+template <std::size_t N>
+void GridIndex<T>::Cells<N>::compact() {
+    const std::size_t cellCount = pendingHeads.size();
+
+    std::vector<uint32_t> newOffsets(cellCount + 1, 0);
+    for (const auto& entry : pending) {
+        newOffsets[entry.cell + 1]++;
+    }
+    for (std::size_t cell = 0; cell < cellCount; ++cell) {
+        newOffsets[cell + 1] += newOffsets[cell] + (offsets[cell + 1] - offsets[cell]);
+    }
+
+    const std::size_t total = newOffsets[cellCount];
+    std::array<std::vector<float>, N> newCoordinates;
+    for (auto& column : newCoordinates) {
+        column.resize(total);
+    }
+    std::vector<uint32_t> newUids(total);
+
+    // Each cell keeps its compacted entries first, followed by its pending ones in insertion order.
+    std::vector<uint32_t> cursors(cellCount);
+    for (std::size_t cell = 0; cell < cellCount; ++cell) {
+        uint32_t cursor = newOffsets[cell];
+        for (uint32_t i = offsets[cell]; i < offsets[cell + 1]; ++i, ++cursor) {
+            for (std::size_t k = 0; k < N; ++k) {
+                newCoordinates[k][cursor] = coordinates[k][i];
+            }
+            newUids[cursor] = uids[i];
+        }
+        cursors[cell] = cursor;
+    }
+    for (const auto& entry : pending) {
+        const uint32_t cursor = cursors[entry.cell]++;
+        for (std::size_t k = 0; k < N; ++k) {
+            newCoordinates[k][cursor] = entry.coordinates[k];
+        }
+        newUids[cursor] = entry.uid;
+    }
+
+    offsets = std::move(newOffsets);
+    coordinates = std::move(newCoordinates);
+    uids = std::move(newUids);
+    pending.clear();
+    std::fill(pendingHeads.begin(), pendingHeads.end(), noPending);
+}
+
+template <class T>
+template <std::size_t N>
+template <class Collides, class Fn>
+bool GridIndex<T>::Cells<N>::visit(std::size_t cell, const Collides& collides, const Fn& fn) const {
+    std::array<const float*, N> columns;
+    for (std::size_t k = 0; k < N; ++k) {
+        columns[k] = coordinates[k].data();
+    }
+
+    const uint32_t end = offsets[cell + 1];
+    uint32_t i = offsets[cell];
+    for (; i + blockSize <= end; i += blockSize) {
+        uint32_t hits = 0;
+        for (uint32_t j = 0; j < blockSize; ++j) {
+            hits |= uint32_t(collides(columns, i + j)) << j;
+        }
+        for (uint32_t j = 0; hits; ++j, hits >>= 1) {
+            if ((hits & 1) && fn(uids[i + j])) {
+                return true;
+            }
+        }
+    }
+    for (; i < end; ++i) {
+        if (collides(columns, i) && fn(uids[i])) {
+            return true;
+        }
+    }
+
+    for (uint32_t index = pendingHeads[cell]; index != noPending; index = pending[index].next) {
+        const Pending& entry = pending[index];
+        for (std::size_t k = 0; k < N; ++k) {
+            columns[k] = &entry.coordinates[k];
+        }
+        if (collides(columns, 0) && fn(entry.uid)) {
+            return true;
+        }
+    }
+
+    return false;
+}
 
 template <class T>
 GridIndex<T>::GridIndex(const float width_, const float height_, const int16_t cellSize_) :
@@ -15,76 +154,95 @@ GridIndex<T>::GridIndex(const float width_, const float height_, const int16_t c
     xCellCount(std::ceil(width_ / cellSize_)),
     yCellCount(std::ceil(height_ / cellSize_)),
     xScale(xCellCount / width_),
-    yScale(yCellCount / height_)
-    {
-        boxCells.resize(xCellCount * yCellCount);
-        circleCells.resize(xCellCount * yCellCount);
-    }
+    yScale(yCellCount / height_),
+    boxCells(xCellCount * yCellCount),
+    circleCells(xCellCount * yCellCount)
+    {}
 
 template <class T>
 void GridIndex<T>::insert(T&& t, const BBox& bbox) {
-    size_t uid = boxElements.size();
-
-    auto cx1 = convertToXCellCoord(bbox.min.x);
-    auto cy1 = convertToYCellCoord(bbox.min.y);
-    auto cx2 = convertToXCellCoord(bbox.max.x);
-    auto cy2 = convertToYCellCoord(bbox.max.y);
-
-    int16_t x, y, cellIndex;
-    for (x = cx1; x <= cx2; ++x) {
-        for (y = cy1; y <= cy2; ++y) {
-            cellIndex = xCellCount * y + x;
-            boxCells[cellIndex].push_back(uid);
+    const uint32_t uid = boxes.size();
+    const CellRange range = convertToCellRange(bbox);
+
+    for (int16_t x = range.x1; x <= range.x2; ++x) {
+        for (int16_t y = range.y1; y <= range.y2; ++y) {
+            boxCells.insert(uid, {{ bbox.min.x, bbox.min.y, bbox.max.x, bbox.max.y }},
+                            std::size_t(xCellCount) * y + x);
         }
     }
 
-    boxElements.emplace_back(t, bbox);
+    boxPayloads.push_back(std::move(t));
+    boxes.push_back(bbox);
+    boxFirstCells.emplace_back(range.x1, range.y1);
 }
 
 template <class T>
 void GridIndex<T>::insert(T&& t, const BCircle& bcircle) {
-    size_t uid = circleElements.size();
-
-    auto cx1 = convertToXCellCoord(bcircle.center.x - bcircle.radius);
-    auto cy1 = convertToYCellCoord(bcircle.center.y - bcircle.radius);
-    auto cx2 = convertToXCellCoord(bcircle.center.x + bcircle.radius);
-    auto cy2 = convertToYCellCoord(bcircle.center.y + bcircle.radius);
-
-    int16_t x, y, cellIndex;
-    for (x = cx1; x <= cx2; ++x) {
-        for (y = cy1; y <= cy2; ++y) {
-            cellIndex = xCellCount * y + x;
-            circleCells[cellIndex].push_back(uid);
+    const uint32_t uid = circles.size();
+    const CellRange range = convertToCellRange(convertToBox(bcircle));
+
+    for (int16_t x = range.x1; x <= range.x2; ++x) {
+        for (int16_t y = range.y1; y <= range.y2; ++y) {
+            circleCells.insert(uid, {{ bcircle.center.x, bcircle.center.y, bcircle.radius }},
+                               std::size_t(xCellCount) * y + x);
         }
     }
 
-    circleElements.emplace_back(t, bcircle);
+    circlePayloads.push_back(std::move(t));
+    circles.push_back(bcircle);
+    circleFirstCells.emplace_back(range.x1, range.y1);
 }
 
 template <class T>
 std::vector<T> GridIndex<T>::query(const BBox& queryBBox) const {
-    std::vector<T> result;
-    query(queryBBox, [&](const T& t, const BBox&) -> bool {
-        result.push_back(t);
+    std::vector<uint32_t> boxUids;
+    std::vector<uint32_t> circleUids;
+    visit(queryBBox, [&](bool isBox, uint32_t uid) -> bool {
+        (isBox ? boxUids : circleUids).push_back(uid);
         return false;
     });
+
+    std::sort(boxUids.begin(), boxUids.end());
+    std::sort(circleUids.begin(), circleUids.end());
+
+    std::vector<T> result;
+    result.reserve(boxUids.size() + circleUids.size());
+    for (auto uid : boxUids) {
+        result.push_back(boxPayloads[uid]);
+    }
+    for (auto uid : circleUids) {
+        result.push_back(circlePayloads[uid]);
+    }
     return result;
 }
 
 template <class T>
 std::vector<std::pair<T, typename GridIndex<T>::BBox>> GridIndex<T>::queryWithBoxes(const BBox& queryBBox) const {
-    std::vector<std::pair<T, BBox>> result;
-    query(queryBBox, [&](const T& t, const BBox& bbox) -> bool {
-        result.push_back(std::make_pair(t, bbox));
+    std::vector<uint32_t> boxUids;
+    std::vector<uint32_t> circleUids;
+    visit(queryBBox, [&](bool isBox, uint32_t uid) -> bool {
+        (isBox ? boxUids : circleUids).push_back(uid);
         return false;
     });
+
+    std::sort(boxUids.begin(), boxUids.end());
+    std::sort(circleUids.begin(), circleUids.end());
+
+    std::vector<std::pair<T, BBox>> result;
+    result.reserve(boxUids.size() + circleUids.size());
+    for (auto uid : boxUids) {
+        result.emplace_back(boxPayloads[uid], boxes[uid]);
+    }
+    for (auto uid : circleUids) {
+        result.emplace_back(circlePayloads[uid], convertToBox(circles[uid]));
+    }
     return result;
 }
 
 template <class T>
 bool GridIndex<T>::hitTest(const BBox& queryBBox) const {
     bool hit = false;
-    query(queryBBox, [&](const T&, const BBox&) -> bool {
+    visit(queryBBox, [&](bool, uint32_t) -> bool {
         hit = true;
         return true;
     });
@@ -94,7 +252,7 @@ bool GridIndex<T>::hitTest(const BBox& queryBBox) const {
 template <class T>
 bool GridIndex<T>::hitTest(const BCircle& queryBCircle) const {
     bool hit = false;
-    query(queryBCircle, [&](const T&, const BBox&) -> bool {
+    visit(queryBCircle, [&](bool, uint32_t) -> bool {
         hit = true;
         return true;
     });
@@ -118,126 +276,88 @@ typename GridIndex<T>::BBox GridIndex<T>::convertToBox(const BCircle& circle) co
 }
 
 template <class T>
-void GridIndex<T>::query(const BBox& queryBBox, std::function<bool (const T&, const BBox&)> resultFn) const {
-    std::unordered_set<size_t> seenBoxes;
-    std::unordered_set<size_t> seenCircles;
-    
-    if (noIntersection(queryBBox)) {
-        return;
-    } else if (completeIntersection(queryBBox)) {
-        for (auto& element : boxElements) {
-            if (resultFn(element.first, element.second)) {
-                return;
-            }
-        }
-        for (auto& element : circleElements) {
-            if (resultFn(element.first, convertToBox(element.second))) {
-                return;
-            }
-        }
-        return;
-    }
+typename GridIndex<T>::CellRange GridIndex<T>::convertToCellRange(const BBox& bbox) const {
+    return CellRange{ convertToXCellCoord(bbox.min.x), convertToYCellCoord(bbox.min.y),
+                      convertToXCellCoord(bbox.max.x), convertToYCellCoord(bbox.max.y) };
+}
 
-    auto cx1 = convertToXCellCoord(queryBBox.min.x);
-    auto cy1 = convertToYCellCoord(queryBBox.min.y);
-    auto cx2 = convertToXCellCoord(queryBBox.max.x);
-    auto cy2 = convertToYCellCoord(queryBBox.max.y);
-
-    int16_t x, y, cellIndex;
-    for (x = cx1; x <= cx2; ++x) {
-        for (y = cy1; y <= cy2; ++y) {
-            cellIndex = xCellCount * y + x;
-            // Look up other boxes
-            for (auto uid : boxCells[cellIndex]) {
-                if (seenBoxes.count(uid) == 0) {
-                    seenBoxes.insert(uid);
-
-                    auto& pair = boxElements.at(uid);
-                    auto& bbox = pair.second;
-                    if (boxesCollide(queryBBox, bbox)) {
-                        if (resultFn(pair.first, bbox)) {
-                            return;
-                        }
-                    }
-                }
-            }
-            
-            // Look up circles
-            for (auto uid : circleCells[cellIndex]) {
-                if (seenCircles.count(uid) == 0) {
-                    seenCircles.insert(uid);
-
-                    auto& pair = circleElements.at(uid);
-                    auto& bcircle = pair.second;
-                    if (circleAndBoxCollide(bcircle, queryBBox)) {
-                        if (resultFn(pair.first, convertToBox(bcircle))) {
-                            return;
-                        }
-                    }
-                }
-            }
-        }
-    }
+template <class T>
+template <class Fn>
+void GridIndex<T>::visit(const BBox& queryBBox, const Fn& fn) const {
+    const float x1 = queryBBox.min.x;
+    const float y1 = queryBBox.min.y;
+    const float x2 = queryBBox.max.x;
+    const float y2 = queryBBox.max.y;
+
+    visit(queryBBox,
+        [&](const std::array<const float*, 4>& box, uint32_t i) {
+            return boxesCollide(x1, y1, x2, y2, box[0][i], box[1][i], box[2][i], box[3][i]);
+        },
+        [&](const std::array<const float*, 3>& circle, uint32_t i) {
+            return circleAndBoxCollide(circle[0][i], circle[1][i], circle[2][i], x1, y1, x2, y2);
+        },
+        fn);
 }
 
 template <class T>
-void GridIndex<T>::query(const BCircle& queryBCircle, std::function<bool (const T&, const BBox&)> resultFn) const {
-    std::unordered_set<size_t> seenBoxes;
-    std::unordered_set<size_t> seenCircles;
+template <class Fn>
+void GridIndex<T>::visit(const BCircle& queryBCircle, const Fn& fn) const {
+    const float cx = queryBCircle.center.x;
+    const float cy = queryBCircle.center.y;
+    const float radius = queryBCircle.radius;
+
+    visit(convertToBox(queryBCircle),
+        [&](const std::array<const float*, 4>& box, uint32_t i) {
+            return circleAndBoxCollide(cx, cy, radius, box[0][i], box[1][i], box[2][i], box[3][i]);
+        },
+        [&](const std::array<const float*, 3>& circle, uint32_t i) {
+            return circlesCollide(cx, cy, radius, circle[0][i], circle[1][i], circle[2][i]);
+        },
+        fn);
+}
 
-    BBox queryBBox = convertToBox(queryBCircle);
+template <class T>
+template <class BoxCollides, class CircleCollides, class Fn>
+void GridIndex<T>::visit(const BBox& queryBBox,
+                         const BoxCollides& boxCollides,
+                         const CircleCollides& circleCollides,
+                         const Fn& fn) const {
     if (noIntersection(queryBBox)) {
         return;
     } else if (completeIntersection(queryBBox)) {
-        for (auto& element : boxElements) {
-            if (resultFn(element.first, element.second)) {
+        for (uint32_t uid = 0; uid < boxes.size(); ++uid) {
+            if (fn(true, uid)) {
                 return;
             }
         }
-        for (auto& element : circleElements) {
-            if (resultFn(element.first, convertToBox(element.second))) {
+        for (uint32_t uid = 0; uid < circles.size(); ++uid) {
+            if (fn(false, uid)) {
                 return;
             }
         }
+        return;
     }
 
-    auto cx1 = convertToXCellCoord(queryBCircle.center.x - queryBCircle.radius);
-    auto cy1 = convertToYCellCoord(queryBCircle.center.y - queryBCircle.radius);
-    auto cx2 = convertToXCellCoord(queryBCircle.center.x + queryBCircle.radius);
-    auto cy2 = convertToYCellCoord(queryBCircle.center.y + queryBCircle.radius);
-
-    int16_t x, y, cellIndex;
-    for (x = cx1; x <= cx2; ++x) {
-        for (y = cy1; y <= cy2; ++y) {
-            cellIndex = xCellCount * y + x;
-            // Look up boxes
-            for (auto uid : boxCells[cellIndex]) {
-                if (seenBoxes.count(uid) == 0) {
-                    seenBoxes.insert(uid);
-
-                    auto& pair = boxElements.at(uid);
-                    auto& bbox = pair.second;
-                    if (circleAndBoxCollide(queryBCircle, bbox)) {
-                        if (resultFn(pair.first, bbox)) {
-                            return;
-                        }
-                    }
-                }
+    const CellRange range = convertToCellRange(queryBBox);
+
+    // A geometry is in every cell it overlaps, so it is only reported from the first of
+    // them that the query overlaps too.
+    auto firstVisit = [&](const std::pair<int16_t, int16_t>& firstCell, int16_t x, int16_t y) {
+        return std::max(firstCell.first, range.x1) == x && std::max(firstCell.second, range.y1) == y;
+    };
+
+    for (int16_t x = range.x1; x <= range.x2; ++x) {
+        for (int16_t y = range.y1; y <= range.y2; ++y) {
+            const std::size_t cellIndex = std::size_t(xCellCount) * y + x;
+            if (boxCells.visit(cellIndex, boxCollides, [&](uint32_t uid) {
+                    return firstVisit(boxFirstCells[uid], x, y) && fn(true, uid);
+                })) {
+                return;
             }
-            
-            // Look up other circles
-            for (auto uid : circleCells[cellIndex]) {
-                if (seenCircles.count(uid) == 0) {
-                    seenCircles.insert(uid);
-
-                    auto& pair = circleElements.at(uid);
-                    auto& bcircle = pair.second;
-                    if (circlesCollide(queryBCircle, bcircle)) {
-                        if (resultFn(pair.first, convertToBox(bcircle))) {
-                            return;
-                        }
-                    }
-                }
+            if (circleCells.visit(cellIndex, circleCollides, [&](uint32_t uid) {
+                    return firstVisit(circleFirstCells[uid], x, y) && fn(false, uid);
+                })) {
+                return;
             }
         }
     }
@@ -253,48 +373,9 @@ int16_t GridIndex<T>::convertToYCellCoord(const float y) const {
     return util::max(0.0, util::min(yCellCount - 1.0, std::floor(y * yScale)));
 }
 
-template <class T>
-bool GridIndex<T>::boxesCollide(const BBox& first, const BBox& second) const {
-	return first.min.x <= second.max.x &&
-           first.min.y <= second.max.y &&
-           first.max.x >= second.min.x &&
-           first.max.y >= second.min.y;
-}
-
-template <class T>
-bool GridIndex<T>::circlesCollide(const BCircle& first, const BCircle& second) const {
-    auto dx = second.center.x - first.center.x;
-    auto dy = second.center.y - first.center.y;
-    auto bothRadii = first.radius + second.radius;
-    return (bothRadii * bothRadii) > (dx * dx + dy * dy);
-}
-
-template <class T>
-bool GridIndex<T>::circleAndBoxCollide(const BCircle& circle, const BBox& box) const {
-    auto halfRectWidth = (box.max.x - box.min.x) / 2;
-    auto distX = std::abs(circle.center.x - (box.min.x + halfRectWidth));
-    if (distX > (halfRectWidth + circle.radius)) {
-        return false;
-    }
-
-    auto halfRectHeight = (box.max.y - box.min.y) / 2;
-    auto distY = std::abs(circle.center.y - (box.min.y + halfRectHeight));
-    if (distY > (halfRectHeight + circle.radius)) {
-        return false;
-    }
-
-    if (distX <= halfRectWidth || distY <= halfRectHeight) {
-        return true;
-    }
-
-    auto dx = distX - halfRectWidth;
-    auto dy = distY - halfRectHeight;
-    return (dx * dx + dy * dy) <= (circle.radius * circle.radius);
-}
-
 template <class T>
 bool GridIndex<T>::empty() const {
-    return boxElements.empty() && circleElements.empty();
+    return boxes.empty() && circles.empty();
 }
 
 
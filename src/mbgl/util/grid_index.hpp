@@ -3,10 +3,10 @@
 #include <mapbox/geometry/point.hpp>
 #include <mapbox/geometry/box.hpp>
 
+#include <array>
 #include <cstdint>
 #include <cstddef>
 #include <vector>
-#include <functional>
 
 namespace mbgl {
 
@@ -50,6 +50,11 @@ constexpr bool operator!=(circle<T> const& lhs, circle<T> const& rhs)
  at least one cell. As long as the geometries are relatively
  uniformly distributed across the plane, this greatly reduces
  the number of comparisons necessary.
+
+ The coordinates of the geometries are stored apart from their
+ payloads, and each cell stores copies of the coordinates of its
+ geometries in contiguous arrays, so that testing the geometries
+ of a cell doesn't chase pointers and can be vectorized.
 */
 
 template <class T>
@@ -64,6 +69,7 @@ public:
     void insert(T&& t, const BBox&);
     void insert(T&& t, const BCircle&);
     
+    // Results are ordered by insertion, boxes first.
     std::vector<T> query(const BBox&) const;
     std::vector<std::pair<T,BBox>> queryWithBoxes(const BBox&) const;
     
@@ -73,19 +79,64 @@ public:
     bool empty() const;
 
 private:
+    // Per cell lists of the geometries of one kind, each stored as N coordinates, e.g.
+    // x1, y1, x2, y2 for boxes. Most of them are kept in compressed sparse row form: cell i
+    // holds entries offsets[i] to offsets[i + 1], whose coordinates and uids are stored in
+    // one array per coordinate. Geometries inserted since the last compaction are kept in
+    // per cell linked lists instead, until there are enough of them to be worth merging in.
+    template <std::size_t N>
+    class Cells {
+    public:
+        using Coordinates = std::array<float, N>;
+
+        explicit Cells(std::size_t cellCount);
+
+        void insert(uint32_t uid, const Coordinates&, std::size_t cell);
+
+        // Calls fn(uid) for each geometry in the cell that collides(coordinates) is true for,
+        // until fn returns true. Returns whether it did.
+        template <class Collides, class Fn>
+        bool visit(std::size_t cell, const Collides& collides, const Fn& fn) const;
+
+    private:
+        void compact();
+
+        std::vector<uint32_t> offsets;
+        std::array<std::vector<float>, N> coordinates;
+        std::vector<uint32_t> uids;
+
+        struct Pending {
+            Coordinates coordinates;
+            uint32_t uid;
+            uint32_t cell;
+            uint32_t next;
+        };
+        std::vector<uint32_t> pendingHeads;
+        std::vector<Pending> pending;
+    };
+
+    struct CellRange {
+        int16_t x1;
+        int16_t y1;
+        int16_t x2;
+        int16_t y2;
+    };
+
     bool noIntersection(const BBox& queryBBox) const;
     bool completeIntersection(const BBox& queryBBox) const;
     BBox convertToBox(const BCircle& circle) const;
+    CellRange convertToCellRange(const BBox&) const;
 
-    void query(const BBox&, std::function<bool (const T&, const BBox&)>) const;
-    void query(const BCircle&, std::function<bool (const T&, const BBox&)>) const;
+    // Calls fn(isBox, uid) once for each geometry colliding with the query, until fn returns true.
+    template <class Fn>
+    void visit(const BBox&, const Fn&) const;
+    template <class Fn>
+    void visit(const BCircle&, const Fn&) const;
+    template <class BoxCollides, class CircleCollides, class Fn>
+    void visit(const BBox& queryBBox, const BoxCollides&, const CircleCollides&, const Fn&) const;
 
     int16_t convertToXCellCoord(const float x) const;
     int16_t convertToYCellCoord(const float y) const;
-    
-    bool boxesCollide(const BBox&, const BBox&) const;
-    bool circlesCollide(const BCircle&, const BCircle&) const;
-    bool circleAndBoxCollide(const BCircle&, const BBox&) const;
 
     const float width;
     const float height;
@@ -95,12 +146,17 @@ private:
     const double xScale;
     const double yScale;
 
-    std::vector<std::pair<T, BBox>> boxElements;
-    std::vector<std::pair<T, BCircle>> circleElements;
-    
-    std::vector<std::vector<size_t>> boxCells;
-    std::vector<std::vector<size_t>> circleCells;
+    std::vector<T> boxPayloads;
+    std::vector<BBox> boxes;
+    std::vector<T> circlePayloads;
+    std::vector<BCircle> circles;
+
+    // The first cell of each geometry, to report geometries spanning several cells once.
+    std::vector<std::pair<int16_t, int16_t>> boxFirstCells;
+    std::vector<std::pair<int16_t, int16_t>> circleFirstCells;
 
+    Cells<4> boxCells;
+    Cells<3> circleCells;
 };
 
 } // namespace mbgl
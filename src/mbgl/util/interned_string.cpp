@@ -0,0 +1,16 @@
+#include <mbgl/util/interned_string.hpp>
+
+namespace mbgl {
+
+InternedString StringTable::intern(const std::string& string) {
+    auto it = indices.find(string);
+    if (it != indices.end()) {
+        return InternedString(it->second);
+    }
+    const auto index = static_cast<uint32_t>(strings.size());
+    strings.push_back(string);
+    indices.emplace(string, index);
+    return InternedString(index);
+}
+
+} // namespace mbgl
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+namespace mbgl {
+
+// A string stored once in a StringTable, and passed around as its index in the table. It can
+// only be resolved against, and compared with strings from, the table that interned it.
+class InternedString {
+public:
+    uint32_t id() const {
+        return index;
+    }
+
+    friend bool operator==(InternedString lhs, InternedString rhs) {
+        return lhs.index == rhs.index;
+    }
+
+    friend bool operator!=(InternedString lhs, InternedString rhs) {
+        return lhs.index != rhs.index;
+    }
+
+private:
+    friend class StringTable;
+    explicit InternedString(uint32_t index_) : index(index_) {}
+
+    uint32_t index;
+};
+
+// Stores the few distinct names that many objects refer to, like the layer IDs and source layer
+// names of a tile's indexed features. Strings live as long as the table, so a table belongs to
+// the objects that use it rather than to the process.
+class StringTable {
+public:
+    InternedString intern(const std::string&);
+
+    // Strings in a deque don't move when more are added, so the reference stays valid.
+    const std::string& get(InternedString interned) const {
+        return strings[interned.id()];
+    }
+
+private:
+    std::deque<std::string> strings;
+    std::unordered_map<std::string, uint32_t> indices;
+};
+
+} // namespace mbgl
+
+namespace std {
+
+template <>
+struct hash<mbgl::InternedString> {
+    size_t operator()(mbgl::InternedString interned) const {
+        return interned.id();
+    }
+};
+
+} // namespace std
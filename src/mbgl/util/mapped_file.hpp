@@ -0,0 +1,29 @@
+#pragma once
+
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace mbgl {
+namespace util {
+
+// A read-only memory mapping of a whole file. The mapping is implemented per platform.
+// Throws an IOException if the file can't be opened or mapped.
+class MappedFile : private noncopyable {
+public:
+    MappedFile(const std::string& path);
+    ~MappedFile();
+
+    // The mapped bytes, or nullptr if the file is empty.
+    const char* data() const;
+    std::size_t size() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+} // namespace util
+} // namespace mbgl
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <mbgl/util/optional.hpp>
+
+#include <cstddef>
+
+namespace mbgl {
+
+// Approximate memory footprint of render data, e.g. of a bucket or a tile. "cpu" counts client
+// side copies of vertices, indices and images, "gpu" the buffers and textures created from them.
+class MemoryUsage {
+public:
+    std::size_t cpu = 0;
+    std::size_t gpu = 0;
+
+    std::size_t total() const {
+        return cpu + gpu;
+    }
+
+    MemoryUsage& operator+=(const MemoryUsage& other) {
+        cpu += other.cpu;
+        gpu += other.gpu;
+        return *this;
+    }
+};
+
+// Size of a GL buffer that may not have been uploaded yet.
+template <class Buffer>
+std::size_t uploadedByteSize(const optional<Buffer>& buffer) {
+    return buffer ? buffer->byteSize() : 0;
+}
+
+} // namespace mbgl
@@ -0,0 +1,65 @@
+#include <mbgl/util/parallel_for.hpp>
+#include <mbgl/actor/mailbox.hpp>
+#include <mbgl/actor/message.hpp>
+#include <mbgl/actor/scheduler.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace mbgl {
+namespace util {
+
+namespace {
+
+class WorkMessage : public Message {
+public:
+    explicit WorkMessage(const std::function<void()>& work_) : work(work_) {}
+
+    void operator()() override {
+        work();
+    }
+
+private:
+    const std::function<void()>& work;
+};
+
+} // namespace
+
+void parallelFor(Scheduler* scheduler,
+                 std::size_t count,
+                 std::size_t grain,
+                 const std::function<void(std::size_t, std::size_t)>& fn) {
+    const std::size_t ranges = (count + grain - 1) / grain;
+
+    std::atomic<std::size_t> next { 0 };
+    const std::function<void()> work = [&] {
+        for (std::size_t range = next++; range < ranges; range = next++) {
+            const std::size_t begin = range * grain;
+            fn(begin, std::min(begin + grain, count));
+        }
+    };
+
+    std::vector<std::shared_ptr<Mailbox>> mailboxes;
+    if (scheduler && ranges > 1) {
+        const std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+        const std::size_t tasks = std::min(ranges - 1, threads - 1);
+        for (std::size_t i = 0; i < tasks; ++i) {
+            mailboxes.push_back(std::make_shared<Mailbox>(*scheduler));
+            mailboxes.back()->push(std::make_unique<WorkMessage>(work));
+        }
+    }
+
+    work();
+
+    // Closing a mailbox waits for its task if it is running, and keeps it from running later,
+    // so that no task outlives `work`.
+    for (auto& mailbox : mailboxes) {
+        mailbox->close();
+    }
+}
+
+} // namespace util
+} // namespace mbgl
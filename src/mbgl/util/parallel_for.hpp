@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace mbgl {
+
+class Scheduler;
+
+namespace util {
+
+// Calls fn(begin, end) for consecutive ranges of at most `grain` indices covering [0, count),
+// on the calling thread and on tasks scheduled on `scheduler`, and returns once all of them
+// have been processed. The calling thread processes ranges itself rather than waiting for
+// the tasks to start, so it's safe to call this while the scheduler is busy, or when it
+// runs on the calling thread. fn must not throw.
+void parallelFor(Scheduler* scheduler,
+                 std::size_t count,
+                 std::size_t grain,
+                 const std::function<void(std::size_t begin, std::size_t end)>& fn);
+
+} // namespace util
+} // namespace mbgl
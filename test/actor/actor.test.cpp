@@ -9,6 +9,7 @@
 #include <future>
 #include <memory>
 #include <thread>
+#include <vector>
 
 using namespace mbgl;
 using namespace std::chrono_literals;
@@ -301,6 +302,101 @@ TEST(Actor, NonConcurrentMailbox) {
     endedFuture.wait();
 }
 
+TEST(Actor, OrderedMailboxesWithWorkStealing) {
+    // Messages are processed in order for every mailbox, even when mailboxes
+    // are scheduled from within the pool and stolen by other workers.
+
+    struct Test {
+        int last = 0;
+        std::atomic<int>& remaining;
+        ActorRef<Test> self;
+
+        Test(ActorRef<Test> self_, std::atomic<int>& remaining_)
+            : remaining(remaining_), self(std::move(self_)) {
+        }
+
+        void receive(int i, int forwards) {
+            EXPECT_EQ(i, last + 1);
+            last = i;
+            if (forwards > 0) {
+                self.invoke(&Test::receive, i + 1, forwards - 1);
+            } else {
+                --remaining;
+            }
+        }
+    };
+
+    ThreadPool pool { 4 };
+
+    const int actorCount = 16;
+    std::atomic<int> remaining { actorCount };
+
+    std::vector<std::unique_ptr<Actor<Test>>> actors;
+    for (int i = 0; i < actorCount; ++i) {
+        actors.emplace_back(std::make_unique<Actor<Test>>(pool, std::ref(remaining)));
+    }
+
+    for (auto& actor : actors) {
+        actor->self().invoke(&Test::receive, 1, 1000);
+    }
+
+    while (remaining > 0) {
+        std::this_thread::yield();
+    }
+}
+
+TEST(Actor, MailboxPriority) {
+    // Mailboxes with a lower priority value are received first.
+
+    struct Test {
+        Test(ActorRef<Test>) {}
+
+        void block(std::promise<void> entered, std::shared_future<void> released) {
+            entered.set_value();
+            released.wait();
+        }
+
+        void receive(std::vector<int>* order, int value) {
+            order->push_back(value);
+        }
+
+        void sync() {}
+    };
+
+    ThreadPool pool { 1 };
+
+    std::promise<void> entered;
+    std::future<void> enteredFuture = entered.get_future();
+    std::promise<void> released;
+
+    Actor<Test> blocker(pool);
+    blocker.self().invoke(&Test::block, std::move(entered), released.get_future().share());
+
+    std::vector<std::unique_ptr<Actor<Test>>> actors;
+    for (int i = 0; i < 3; ++i) {
+        actors.emplace_back(std::make_unique<Actor<Test>>(pool));
+    }
+
+    actors[0]->setPriority(3);
+    actors[1]->setPriority(1);
+    actors[2]->setPriority(2);
+
+    // The only worker is busy until we release it, so all three mailboxes end up in its queue.
+    enteredFuture.wait();
+
+    std::vector<int> order;
+    actors[0]->self().invoke(&Test::receive, &order, 3);
+    actors[1]->self().invoke(&Test::receive, &order, 1);
+    actors[2]->self().invoke(&Test::receive, &order, 2);
+
+    released.set_value();
+    for (auto& actor : actors) {
+        actor->self().ask(&Test::sync).wait();
+    }
+
+    EXPECT_EQ((std::vector<int>{ 1, 2, 3 }), order);
+}
+
 TEST(Actor, Ask) {
     // Asking for a result
 
@@ -0,0 +1,161 @@
+#include <mbgl/actor/mailbox.hpp>
+#include <mbgl/actor/message.hpp>
+#include <mbgl/actor/scheduler.hpp>
+
+#include <mbgl/test/util.hpp>
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+// Receives scheduled mailboxes only when asked to, on the calling thread.
+class ManualScheduler : public Scheduler {
+public:
+    void schedule(std::weak_ptr<Mailbox> mailbox) override {
+        scheduled.push_back(std::move(mailbox));
+    }
+
+    void runAll() {
+        while (!scheduled.empty()) {
+            auto mailbox = std::move(scheduled.front());
+            scheduled.pop_front();
+            Mailbox::maybeReceive(mailbox);
+        }
+    }
+
+    std::deque<std::weak_ptr<Mailbox>> scheduled;
+};
+
+class TestMessage : public Message {
+public:
+    TestMessage(std::function<void(const Message&)> fn_, std::atomic<int>* destroyed_ = nullptr)
+        : fn(std::move(fn_)), destroyed(destroyed_) {
+    }
+
+    ~TestMessage() override {
+        if (destroyed) {
+            ++*destroyed;
+        }
+    }
+
+    void operator()() override {
+        fn(*this);
+    }
+
+    std::function<void(const Message&)> fn;
+    std::atomic<int>* destroyed;
+};
+
+std::unique_ptr<Message> makeTestMessage(Mailbox& mailbox,
+                                         std::function<void(const Message&)> fn,
+                                         std::atomic<int>* destroyed = nullptr) {
+    return std::unique_ptr<Message>(new (mailbox) TestMessage(std::move(fn), destroyed));
+}
+
+} // namespace
+
+TEST(Mailbox, HoldingMailboxReceivesOnOpen) {
+    auto mailbox = std::make_shared<Mailbox>();
+    std::vector<int> received;
+
+    for (int i = 0; i < 3; ++i) {
+        mailbox->push(makeTestMessage(*mailbox, [&, i] (const Message&) { received.push_back(i); }));
+    }
+
+    ManualScheduler scheduler;
+    mailbox->open(scheduler);
+    scheduler.runAll();
+
+    EXPECT_EQ((std::vector<int> { 0, 1, 2 }), received);
+}
+
+TEST(Mailbox, ClosedMailboxDropsMessages) {
+    ManualScheduler scheduler;
+    auto mailbox = std::make_shared<Mailbox>(scheduler);
+    std::atomic<int> destroyed { 0 };
+    bool received = false;
+
+    mailbox->push(makeTestMessage(*mailbox, [&] (const Message&) { received = true; }, &destroyed));
+    mailbox->close();
+    scheduler.runAll();
+    EXPECT_FALSE(received);
+
+    // Messages pushed after closing are destroyed right away.
+    mailbox->push(makeTestMessage(*mailbox, [&] (const Message&) { received = true; }, &destroyed));
+    EXPECT_EQ(1, destroyed.load());
+    scheduler.runAll();
+    EXPECT_FALSE(received);
+
+    mailbox.reset();
+    EXPECT_EQ(2, destroyed.load());
+}
+
+TEST(Mailbox, PushDuringReceive) {
+    ManualScheduler scheduler;
+    auto mailbox = std::make_shared<Mailbox>(scheduler);
+    std::vector<int> received;
+
+    mailbox->push(makeTestMessage(*mailbox, [&] (const Message&) {
+        received.push_back(0);
+        mailbox->push(makeTestMessage(*mailbox, [&] (const Message&) { received.push_back(2); }));
+    }));
+    mailbox->push(makeTestMessage(*mailbox, [&] (const Message&) { received.push_back(1); }));
+
+    scheduler.runAll();
+
+    EXPECT_EQ((std::vector<int> { 0, 1, 2 }), received);
+}
+
+TEST(Mailbox, MultipleProducers) {
+    // Messages from each producer are received in the order they were pushed.
+    ManualScheduler scheduler;
+    auto mailbox = std::make_shared<Mailbox>();
+
+    constexpr int producers = 4;
+    constexpr int messages = 10000;
+    std::vector<int> next(producers, 0);
+    bool ordered = true;
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < messages; ++i) {
+                mailbox->push(makeTestMessage(*mailbox, [&, p, i] (const Message&) {
+                    ordered = ordered && next[p] == i;
+                    next[p] = i + 1;
+                }));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    mailbox->open(scheduler);
+    scheduler.runAll();
+
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(std::vector<int>(producers, messages), next);
+}
+
+TEST(Mailbox, ReusesMessageNodes) {
+    ManualScheduler scheduler;
+    auto mailbox = std::make_shared<Mailbox>(scheduler);
+    std::vector<const Message*> addresses;
+    auto record = [&] (const Message& message) { addresses.push_back(&message); };
+
+    mailbox->push(makeTestMessage(*mailbox, record));
+    scheduler.runAll();
+    mailbox->push(makeTestMessage(*mailbox, record));
+    scheduler.runAll();
+
+    ASSERT_EQ(2u, addresses.size());
+    EXPECT_EQ(addresses[0], addresses[1]);
+}
@@ -1,10 +1,12 @@
 #include <mbgl/map/map.hpp>
 #include <mbgl/util/default_thread_pool.hpp>
 #include <mbgl/test/stub_file_source.hpp>
+#include <mbgl/test/stub_map_observer.hpp>
 #include <mbgl/test/util.hpp>
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/io.hpp>
 #include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/timer.hpp>
 #include <mbgl/style/style.hpp>
 #include <mbgl/style/image.hpp>
 #include <mbgl/style/source.hpp>
@@ -86,6 +88,43 @@ TEST(Query, QueryRenderedFeaturesFilter) {
     EXPECT_EQ(features3.size(), 1u);
 }
 
+TEST(Query, QueryRenderedFeaturesWithPlacementBudget) {
+    using namespace std::chrono_literals;
+
+    util::RunLoop loop;
+    StubFileSource fileSource;
+    ThreadPool threadPool { 4 };
+    HeadlessFrontend frontend { 1, fileSource, threadPool };
+    StubMapObserver observer;
+    Map map { frontend, observer, frontend.getSize(), 1, fileSource, threadPool, MapMode::Continuous };
+
+    // Placing takes several frames, during which the symbols can't be queried yet.
+    frontend.getRenderer()->setPlacementBudget(Duration::zero());
+
+    std::size_t features = 0;
+    observer.didFinishRenderingFrameCallback = [&] (MapObserver::RenderMode mode) {
+        if (mode == MapObserver::RenderMode::Full) {
+            features = frontend.getRenderer()->queryRenderedFeatures(map.pixelForLatLng({ 0, 0 })).size();
+            if (features == 4) {
+                loop.stop();
+            }
+        }
+    };
+
+    util::Timer emergencyShutoff;
+    emergencyShutoff.start(10s, 0s, [&] {
+        loop.stop();
+        FAIL() << "Did not finish placing symbols";
+    });
+
+    map.getStyle().loadJSON(util::read_file("test/fixtures/api/query_style.json"));
+    map.getStyle().addImage(std::make_unique<style::Image>("test-icon",
+        decodeImage(util::read_file("test/fixtures/sprites/default_marker.png")), 1.0));
+
+    loop.run();
+    EXPECT_EQ(features, 4u);
+}
+
 TEST(Query, QuerySourceFeatures) {
     QueryTest test;
 
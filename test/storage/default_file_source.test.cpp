@@ -2,7 +2,11 @@
 #include <mbgl/test/util.hpp>
 #include <mbgl/storage/default_file_source.hpp>
 #include <mbgl/storage/resource_transform.hpp>
+#include <mbgl/util/io.hpp>
 #include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/timer.hpp>
+
+#include <sqlite3.hpp>
 
 using namespace mbgl;
 
@@ -649,3 +653,50 @@ TEST(DefaultFileSource, TEST_REQUIRES_SERVER(RespondToStaleMustRevalidate)) {
 
     loop.run();
 }
+
+TEST(DefaultFileSource, TEST_REQUIRES_WRITE(AmbientBatchFlush)) {
+    using namespace std::chrono_literals;
+
+    static constexpr const char* filename = "test/fixtures/offline_database/ambient_batch.db";
+    util::deleteFile(filename);
+
+    // Counts the resources that are visible to other connections.
+    auto committedCount = [] {
+        mapbox::sqlite::Database db = mapbox::sqlite::Database::open(filename, mapbox::sqlite::ReadOnly);
+        mapbox::sqlite::Statement stmt{ db, "SELECT COUNT(*) FROM resources" };
+        mapbox::sqlite::Query query{ stmt };
+        query.run();
+        return query.get<int>(0);
+    };
+
+    util::RunLoop loop;
+    DefaultFileSource fs(filename, ".", util::DEFAULT_MAX_CACHE_SIZE, true);
+    fs.setAmbientBatchSize(10);
+
+    Response response;
+    response.data = std::make_shared<std::string>("data");
+    fs.put(Resource::style("http://example.com/1"), response);
+    fs.put(Resource::style("http://example.com/2"), response);
+
+    // The batch isn't full, but the file source thread commits it shortly after.
+    // Responses are served from the open batch meanwhile.
+    const Resource cacheOnly { Resource::Unknown, "http://example.com/2", {}, Resource::LoadingMethod::CacheOnly };
+    util::Timer timer;
+    std::unique_ptr<AsyncRequest> req;
+    req = fs.request(cacheOnly, [&](Response res) {
+        req.reset();
+        EXPECT_EQ(nullptr, res.error);
+        EXPECT_EQ(0, committedCount());
+
+        auto start = util::now();
+        timer.start(10ms, 10ms, [&, start] {
+            if (committedCount() == 2 || util::now() - start > 5s) {
+                loop.stop();
+            }
+        });
+    });
+
+    loop.run();
+
+    EXPECT_EQ(2, committedCount());
+}
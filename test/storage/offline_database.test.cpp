@@ -439,6 +439,39 @@ TEST(OfflineDatabase, PutFailsWhenEvictionInsuffices) {
     EXPECT_EQ(0u, log.uncheckedCount());
 }
 
+TEST(OfflineDatabase, PutEvictsLimitedNumberOfChunks) {
+    FixtureLog log;
+    OfflineDatabase db(":memory:", 1024 * 1024);
+
+    Response small;
+    small.data = randomString(1024);
+
+    for (uint32_t i = 1; i <= 700; i++) {
+        db.put(Resource::style("http://example.com/"s + util::toString(i)), small);
+    }
+    EXPECT_FALSE(db.needsEviction());
+
+    // Making room for this one takes eight chunks of 50 resources, more than put() evicts.
+    Response big;
+    big.data = randomString(1024 * 600);
+    EXPECT_TRUE(db.put(Resource::style("http://example.com/big"), big).first);
+    EXPECT_TRUE(db.needsEviction());
+
+    EXPECT_TRUE(db.evictChunk());
+    while (db.evictChunk()) {
+    }
+    EXPECT_FALSE(db.needsEviction());
+
+    // Checked only now, since reading a resource makes it the most recently used.
+    EXPECT_FALSE(bool(db.get(Resource::style("http://example.com/1"))));
+    EXPECT_FALSE(bool(db.get(Resource::style("http://example.com/400"))));
+    EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/401"))));
+    EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/700"))));
+    EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/big"))));
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
 TEST(OfflineDatabase, GetRegionCompletedStatus) {
     FixtureLog log;
     OfflineDatabase db(":memory:");
@@ -687,6 +720,26 @@ static std::vector<std::string> databaseTableColumns(const std::string& path, co
     return columns;
 }
 
+// Returns the running total of data size kept in the database, and the actual total.
+static std::pair<int64_t, int64_t> databaseDataSize(const std::string& path) {
+    mapbox::sqlite::Database db = mapbox::sqlite::Database::open(path, mapbox::sqlite::ReadOnly);
+    mapbox::sqlite::Statement stmt{ db,
+        "SELECT (SELECT size FROM cache_usage), "
+        "       (SELECT IFNULL(SUM(length(data)), 0) FROM resources) + "
+        "       (SELECT IFNULL(SUM(length(data)), 0) FROM tiles)" };
+    mapbox::sqlite::Query query{ stmt };
+    query.run();
+    return { query.get<int64_t>(0), query.get<int64_t>(1) };
+}
+
+static int databaseResourceCount(const std::string& path) {
+    mapbox::sqlite::Database db = mapbox::sqlite::Database::open(path, mapbox::sqlite::ReadOnly);
+    mapbox::sqlite::Statement stmt{ db, "SELECT COUNT(*) FROM resources" };
+    mapbox::sqlite::Query query{ stmt };
+    query.run();
+    return query.get<int>(0);
+}
+
 TEST(OfflineDatabase, MigrateFromV2Schema) {
     // v2.db is a v2 database containing a single offline region with a small number of resources.
     FixtureLog log;
@@ -701,7 +754,7 @@ TEST(OfflineDatabase, MigrateFromV2Schema) {
         }
     }
 
-    EXPECT_EQ(6, databaseUserVersion(filename));
+    EXPECT_EQ(7, databaseUserVersion(filename));
     EXPECT_LT(databasePageCount(filename),
               databasePageCount("test/fixtures/offline_database/v2.db"));
 
@@ -722,7 +775,7 @@ TEST(OfflineDatabase, MigrateFromV3Schema) {
         }
     }
 
-    EXPECT_EQ(6, databaseUserVersion(filename));
+    EXPECT_EQ(7, databaseUserVersion(filename));
 
     EXPECT_EQ(0u, log.uncheckedCount());
 }
@@ -741,7 +794,7 @@ TEST(OfflineDatabase, MigrateFromV4Schema) {
         }
     }
 
-    EXPECT_EQ(6, databaseUserVersion(filename));
+    EXPECT_EQ(7, databaseUserVersion(filename));
 
     // Journal mode should be DELETE after migration to v5.
     EXPECT_EQ("delete", databaseJournalMode(filename));
@@ -767,7 +820,7 @@ TEST(OfflineDatabase, MigrateFromV5Schema) {
         }
     }
 
-    EXPECT_EQ(6, databaseUserVersion(filename));
+    EXPECT_EQ(7, databaseUserVersion(filename));
 
     EXPECT_EQ((std::vector<std::string>{ "id", "url_template", "pixel_ratio", "z", "x", "y",
                                          "expires", "modified", "etag", "data", "compressed",
@@ -777,6 +830,9 @@ TEST(OfflineDatabase, MigrateFromV5Schema) {
                                          "compressed", "accessed", "must_revalidate" }),
               databaseTableColumns(filename, "resources"));
 
+    const auto dataSize = databaseDataSize(filename);
+    EXPECT_EQ(dataSize.second, dataSize.first);
+
     EXPECT_EQ(0u, log.uncheckedCount());
 }
 
@@ -791,7 +847,7 @@ TEST(OfflineDatabase, DowngradeSchema) {
         OfflineDatabase db(filename, 0);
     }
 
-    EXPECT_EQ(6, databaseUserVersion(filename));
+    EXPECT_EQ(7, databaseUserVersion(filename));
 
     EXPECT_EQ((std::vector<std::string>{ "id", "url_template", "pixel_ratio", "z", "x", "y",
                                          "expires", "modified", "etag", "data", "compressed",
@@ -804,3 +860,140 @@ TEST(OfflineDatabase, DowngradeSchema) {
     EXPECT_EQ(1u, log.count({ EventSeverity::Warning, Event::Database, -1, "Removing existing incompatible offline database" }));
     EXPECT_EQ(0u, log.uncheckedCount());
 }
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(WriteAheadLog)) {
+    FixtureLog log;
+    util::deleteFile(filename);
+
+    auto journalMode = [] {
+        mapbox::sqlite::Database db = mapbox::sqlite::Database::open(filename, mapbox::sqlite::ReadWriteCreate);
+        mapbox::sqlite::Statement stmt{ db, "pragma journal_mode" };
+        mapbox::sqlite::Query query{ stmt };
+        query.run();
+        return query.get<std::string>(0);
+    };
+
+    Response response;
+    response.noContent = true;
+
+    {
+        OfflineDatabase db(filename, util::DEFAULT_MAX_CACHE_SIZE, true);
+        db.put(Resource::style("http://example.com/"), response);
+    }
+
+    EXPECT_EQ("wal", journalMode());
+
+    {
+        // Opting out switches the database back to a rollback journal.
+        OfflineDatabase db(filename);
+        EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/"))));
+    }
+
+    EXPECT_EQ("delete", journalMode());
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(AmbientBatch)) {
+    FixtureLog log;
+    util::deleteFile(filename);
+
+    // Counts the resources that are visible to other connections.
+    auto committedCount = [] {
+        mapbox::sqlite::Database db = mapbox::sqlite::Database::open(filename, mapbox::sqlite::ReadOnly);
+        mapbox::sqlite::Statement stmt{ db, "SELECT COUNT(*) FROM resources" };
+        mapbox::sqlite::Query query{ stmt };
+        query.run();
+        return query.get<int>(0);
+    };
+
+    OfflineDatabase db(filename);
+    db.setAmbientBatchSize(10);
+
+    Response response;
+    response.data = std::make_shared<std::string>("data");
+
+    for (uint32_t i = 1; i < 10; i++) {
+        Resource resource = Resource::style("http://example.com/"s + util::toString(i));
+        EXPECT_TRUE(db.put(resource, response).first);
+        EXPECT_TRUE(bool(db.get(resource)));
+    }
+    EXPECT_EQ(0, committedCount());
+
+    db.put(Resource::style("http://example.com/10"), response);
+    EXPECT_EQ(10, committedCount());
+
+    db.put(Resource::style("http://example.com/11"), response);
+    EXPECT_EQ(10, committedCount());
+    db.flush();
+    EXPECT_EQ(11, committedCount());
+
+    // Region operations commit the open batch first.
+    db.put(Resource::style("http://example.com/12"), response);
+    OfflineRegionDefinition definition { "", LatLngBounds::world(), 0, INFINITY, 1.0 };
+    db.createRegion(definition, OfflineRegionMetadata());
+    EXPECT_EQ(12, committedCount());
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(DataSize)) {
+    FixtureLog log;
+    util::deleteFile(filename);
+
+    Response response;
+    response.data = randomString(1024);
+
+    Response noContent;
+    noContent.noContent = true;
+
+    {
+        OfflineDatabase db(filename);
+        const Resource tile = Resource::tile("http://example.com/", 1.0, 0, 0, 0, Tileset::Scheme::XYZ);
+        db.put(Resource::style("http://example.com/1"), response);
+        db.put(Resource::style("http://example.com/2"), response);
+        db.put(Resource::style("http://example.com/2"), noContent);
+        db.put(tile, response);
+        db.put(tile, response);
+    }
+
+    EXPECT_EQ(std::make_pair(int64_t(2048), int64_t(2048)), databaseDataSize(filename));
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(IncrementalEviction)) {
+    FixtureLog log;
+    util::deleteFile(filename);
+
+    Response response;
+    response.data = randomString(1024);
+
+    {
+        OfflineDatabase db(filename);
+        db.setAmbientBatchSize(1000);
+        for (uint32_t i = 1; i <= 1000; i++) {
+            db.put(Resource::style("http://example.com/"s + util::toString(i)), response);
+        }
+    }
+
+    // Shrinking the cache leaves far more to evict than a single put() does.
+    OfflineDatabase db(filename, 1024 * 100);
+    EXPECT_TRUE(db.put(Resource::style("http://example.com/new"), response).first);
+    EXPECT_TRUE(db.needsEviction());
+    EXPECT_EQ(801, databaseResourceCount(filename));
+
+    while (db.evictChunk()) {
+    }
+    EXPECT_FALSE(db.needsEviction());
+    EXPECT_GT(80, databaseResourceCount(filename));
+
+    EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/new"))));
+    EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/1000"))));
+    EXPECT_FALSE(bool(db.get(Resource::style("http://example.com/900"))));
+
+    const auto dataSize = databaseDataSize(filename);
+    EXPECT_EQ(dataSize.second, dataSize.first);
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
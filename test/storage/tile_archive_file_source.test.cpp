@@ -0,0 +1,150 @@
+#include <mbgl/storage/tile_archive_file_source.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/style/conversion/json.hpp>
+#include <mbgl/style/conversion/tileset.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <unistd.h>
+#include <climits>
+#include <gtest/gtest.h>
+
+namespace {
+
+std::string toAbsoluteURL(const std::string& protocol, const std::string& fileName) {
+    char buff[PATH_MAX + 1];
+    char* cwd = getcwd( buff, PATH_MAX + 1 );
+    std::string url = { protocol + std::string(cwd) + "/test/fixtures/storage/archives/" + fileName };
+    assert(url.size() <= PATH_MAX);
+    return url;
+}
+
+// Both fixtures contain the same two tiles: 0/0/0, stored gzip compressed, and 1/1/0.
+std::vector<std::string> archiveURLs() {
+    return { toAbsoluteURL("mbtiles://", "test.mbtiles"), toAbsoluteURL("tilepack://", "test.tilepack") };
+}
+
+mbgl::Response request(mbgl::FileSource& fs, const mbgl::Resource& resource) {
+    mbgl::util::RunLoop loop;
+    mbgl::Response result;
+    std::unique_ptr<mbgl::AsyncRequest> req = fs.request(resource, [&](mbgl::Response res) {
+        req.reset();
+        result = res;
+        loop.stop();
+    });
+    loop.run();
+    return result;
+}
+
+mbgl::Resource tile(const std::string& archiveURL, uint8_t z, int32_t x, int32_t y) {
+    return mbgl::Resource::tile(archiveURL + "?tile={z}/{x}/{y}", 1.0, x, y, z, mbgl::Tileset::Scheme::XYZ);
+}
+
+} // namespace
+
+using namespace mbgl;
+
+TEST(TileArchiveFileSource, AcceptsURL) {
+    EXPECT_TRUE(TileArchiveFileSource::acceptsURL("mbtiles:///test.mbtiles"));
+    EXPECT_TRUE(TileArchiveFileSource::acceptsURL("tilepack:///test.tilepack?tile=0/0/0"));
+    EXPECT_FALSE(TileArchiveFileSource::acceptsURL("file:///test.mbtiles"));
+    EXPECT_FALSE(TileArchiveFileSource::acceptsURL("mbtiles:"));
+    EXPECT_FALSE(TileArchiveFileSource::acceptsURL(""));
+}
+
+TEST(TileArchiveFileSource, TileJSON) {
+    TileArchiveFileSource fs;
+
+    for (const auto& url : archiveURLs()) {
+        SCOPED_TRACE(url);
+
+        Response res = request(fs, { Resource::Source, url });
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+
+        style::conversion::Error error;
+        optional<Tileset> tileset = style::conversion::convertJSON<Tileset>(*res.data, error);
+        ASSERT_TRUE(bool(tileset)) << error.message;
+        EXPECT_EQ(std::vector<std::string>{ url + "?tile={z}/{x}/{y}" }, tileset->tiles);
+        EXPECT_EQ(Tileset::Scheme::XYZ, tileset->scheme);
+        EXPECT_EQ(0, tileset->zoomRange.min);
+        EXPECT_EQ(1, tileset->zoomRange.max);
+        EXPECT_NE(std::string::npos, res.data->find("\"vector_layers\":[{\"id\":\"water\"}]"));
+    }
+}
+
+TEST(TileArchiveFileSource, Tile) {
+    TileArchiveFileSource fs;
+
+    for (const auto& url : archiveURLs()) {
+        SCOPED_TRACE(url);
+
+        Response res = request(fs, tile(url, 1, 1, 0));
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ("tile 1/1/0", *res.data);
+    }
+}
+
+TEST(TileArchiveFileSource, CompressedTile) {
+    TileArchiveFileSource fs;
+
+    for (const auto& url : archiveURLs()) {
+        SCOPED_TRACE(url);
+
+        Response res = request(fs, tile(url, 0, 0, 0));
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ("tile 0/0/0", *res.data);
+    }
+}
+
+TEST(TileArchiveFileSource, TilePackTileIsNotCopied) {
+    TileArchiveFileSource fs;
+    const std::string url = toAbsoluteURL("tilepack://", "test.tilepack");
+
+    // Uncompressed tiles refer to the mapped file, so both responses point at the same bytes.
+    Response first = request(fs, tile(url, 1, 1, 0));
+    Response second = request(fs, tile(url, 1, 1, 0));
+    ASSERT_TRUE(first.data && second.data);
+    EXPECT_EQ(first.data.data(), second.data.data());
+    EXPECT_EQ(std::string("tile 1/1/0"), std::string(first.data.data(), first.data.size()));
+}
+
+TEST(TileArchiveFileSource, MissingTile) {
+    TileArchiveFileSource fs;
+
+    for (const auto& url : archiveURLs()) {
+        SCOPED_TRACE(url);
+
+        Response res = request(fs, tile(url, 1, 0, 0));
+        EXPECT_EQ(nullptr, res.error);
+        EXPECT_TRUE(res.noContent);
+        EXPECT_FALSE(res.data.get());
+    }
+}
+
+TEST(TileArchiveFileSource, InvalidTile) {
+    TileArchiveFileSource fs;
+
+    for (const auto& url : archiveURLs()) {
+        SCOPED_TRACE(url);
+
+        Response res = request(fs, { Resource::Tile, url + "?tile=1/2/0" });
+        ASSERT_NE(nullptr, res.error);
+        EXPECT_EQ(Response::Error::Reason::Other, res.error->reason);
+        EXPECT_EQ("Invalid tile URL", res.error->message);
+    }
+}
+
+TEST(TileArchiveFileSource, NonExistentArchive) {
+    TileArchiveFileSource fs;
+
+    for (const auto& protocol : { "mbtiles://", "tilepack://" }) {
+        SCOPED_TRACE(protocol);
+
+        Response res = request(fs, { Resource::Source, toAbsoluteURL(protocol, "does_not_exist") });
+        ASSERT_NE(nullptr, res.error);
+        EXPECT_EQ(Response::Error::Reason::NotFound, res.error->reason);
+        EXPECT_FALSE(res.data.get());
+    }
+}
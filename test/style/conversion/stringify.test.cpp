@@ -2,6 +2,8 @@
 
 #include <mbgl/style/expression/literal.hpp>
 #include <mbgl/style/conversion/stringify.hpp>
+#include <mbgl/style/conversion/filter.hpp>
+#include <mbgl/style/conversion/json.hpp>
 #include <mbgl/style/types.hpp>
 #include <mbgl/style/layers/symbol_layer_properties.hpp>
 #include <mbgl/style/expression/dsl.hpp>
@@ -82,6 +84,39 @@ TEST(Stringify, Filter) {
     ASSERT_EQ(stringify(Filter(eq(literal("a"), literal("b")))), "[\"==\",\"a\",\"b\"]");
 }
 
+TEST(Stringify, LegacyFilter) {
+    // Legacy filters serialize as the expressions they convert to, literal inputs included.
+    // Serialized filters parse as expressions, which fold their constant parts, so they parse
+    // back to equal filters only when nothing is left to fold.
+    auto roundTrip = [] (const std::string& json, const std::string& expected, const std::string& folded) {
+        Error error;
+        optional<Filter> filter = convertJSON<Filter>(json, error);
+        ASSERT_TRUE(bool(filter)) << error.message;
+        const std::string serialized = stringify(*filter);
+        EXPECT_EQ(expected, serialized);
+
+        optional<Filter> parsed = convertJSON<Filter>(serialized, error);
+        ASSERT_TRUE(bool(parsed)) << error.message;
+        EXPECT_EQ(folded, stringify(*parsed));
+        if (folded == expected) {
+            EXPECT_EQ(*filter, *parsed);
+        }
+    };
+
+    roundTrip(R"(["all", ["has", "$type"], ["==", "class", "park"]])",
+              R"(["all",true,["filter-==","class","park"]])",
+              R"(["all",true,["filter-==","class","park"]])");
+    roundTrip(R"(["any", ["!has", "$type"], ["==", "class", "park"]])",
+              R"(["any",["!",true],["filter-==","class","park"]])",
+              R"(["any",false,["filter-==","class","park"]])");
+
+    // This one folds to a bare `false`, which isn't a filter that can be parsed again.
+    Error error;
+    optional<Filter> none = convertJSON<Filter>(R"(["none", ["has", "$type"]])", error);
+    ASSERT_TRUE(bool(none)) << error.message;
+    EXPECT_EQ(R"(["!",["any",true]])", stringify(*none));
+}
+
 TEST(Stringify, CameraFunction) {
     using namespace mbgl::style::expression::dsl;
     ASSERT_EQ(stringify(CameraFunction<float>(
@@ -1,9 +1,13 @@
 #include <mbgl/test/util.hpp>
+#include <mbgl/test/stub_geometry_tile_feature.hpp>
 #include <mbgl/util/io.hpp>
 #include <mbgl/style/conversion.hpp>
 #include <mbgl/util/rapidjson.hpp>
 #include <mbgl/style/rapidjson_conversion.hpp>
+#include <mbgl/style/expression/compound_expression.hpp>
 #include <mbgl/style/expression/is_expression.hpp>
+#include <mbgl/style/expression/literal.hpp>
+#include <mbgl/style/expression/parsing_context.hpp>
 
 #include <rapidjson/document.h>
 
@@ -93,3 +97,119 @@ INSTANTIATE_TEST_CASE_P(Expression, ExpressionEqualityTest, ::testing::ValuesIn(
     EXPECT_GT(names.size(), 0u);
     return names;
 }()));
+
+namespace {
+
+// Evaluates to the value of a literal without being a Literal, so that compound expressions
+// evaluate it each time instead of binding it when they are created.
+class OpaqueLiteral : public expression::Expression {
+public:
+    OpaqueLiteral(const expression::Literal& literal)
+        : Expression(literal.getType()), value(literal.getValue()) {
+    }
+
+    expression::EvaluationResult evaluate(const expression::EvaluationContext&) const override {
+        return value;
+    }
+
+    void eachChild(const std::function<void(const Expression&)>&) const override {}
+
+    bool operator==(const Expression& e) const override {
+        auto rhs = dynamic_cast<const OpaqueLiteral*>(&e);
+        return rhs && value == rhs->value;
+    }
+
+    std::vector<optional<expression::Value>> possibleOutputs() const override {
+        return { optional<expression::Value>(value) };
+    }
+
+    std::string getOperator() const override {
+        return "opaque-literal";
+    }
+
+private:
+    expression::Value value;
+};
+
+// Creates the compound expression `json` with its arguments parsed, wrapping literal arguments
+// in OpaqueLiteral if `opaque` is set.
+std::unique_ptr<expression::Expression> createCompound(const std::string& json, bool opaque) {
+    JSDocument document;
+    document.Parse<0>(json.c_str());
+    assert(!document.HasParseError() && document.IsArray());
+
+    expression::ParsingContext ctx;
+    std::vector<std::unique_ptr<expression::Expression>> args;
+    for (rapidjson::SizeType i = 1; i < document.Size(); i++) {
+        const JSValue* arg = &document[i];
+        expression::ParseResult parsed = ctx.parseExpression(conversion::Convertible(arg));
+        if (!parsed) {
+            return nullptr;
+        }
+        auto literal = dynamic_cast<const expression::Literal*>(parsed->get());
+        if (opaque && literal) {
+            args.push_back(std::make_unique<OpaqueLiteral>(*literal));
+        } else {
+            args.push_back(std::move(*parsed));
+        }
+    }
+
+    expression::ParseResult result = expression::createCompoundExpression(document[0].GetString(), std::move(args), ctx);
+    return result ? std::move(*result) : nullptr;
+}
+
+} // namespace
+
+TEST(Expression, BoundConstantsEvaluateLikeArguments) {
+    const std::vector<std::string> expressions {
+        R"(["get", "name"])",
+        R"(["has", "name"])",
+        R"(["concat", "a", "b"])",
+        R"(["concat", "a", ["to-string", ["get", "name"]]])",
+        R"(["+", 1, ["to-number", ["get", "rank"], 0]])",
+        R"(["error", "failed"])",
+        R"(["filter-==", "class", "park"])",
+        R"(["filter-<", "rank", 3])",
+        R"(["filter-<", "rank", "c"])",
+        R"(["filter->=", "rank", 2])",
+        R"(["filter-id-==", 1])",
+        R"(["filter-has", "name"])",
+        R"(["filter-in", "class", "park", "school"])",
+    };
+
+    const StubGeometryTileFeature park(FeatureIdentifier(uint64_t(1)), FeatureType::Point, {},
+        {{ "class", std::string("park") }, { "rank", uint64_t(2) }, { "name", std::string("A") }});
+    const StubGeometryTileFeature school(FeatureIdentifier(uint64_t(2)), FeatureType::Point, {},
+        {{ "class", std::string("school") }, { "rank", std::string("b") }});
+    const StubGeometryTileFeature empty(PropertyMap {});
+    const std::vector<const GeometryTileFeature*> features { &park, &school, &empty };
+
+    auto expectEqual = [](const expression::EvaluationResult& expected,
+                          const expression::EvaluationResult& actual,
+                          const std::string& json) {
+        ASSERT_EQ(bool(expected), bool(actual)) << json;
+        if (expected) {
+            EXPECT_EQ(*expected, *actual) << json;
+        } else {
+            EXPECT_EQ(expected.error().message, actual.error().message) << json;
+        }
+    };
+
+    for (const auto& json : expressions) {
+        auto bound = createCompound(json, false);
+        auto evaluated = createCompound(json, true);
+        ASSERT_TRUE(bound && evaluated) << json;
+
+        for (const auto* feature : features) {
+            const expression::EvaluationContext params(10.0f, feature);
+            expectEqual(evaluated->evaluate(params), bound->evaluate(params), json);
+        }
+
+        const auto expected = evaluated->evaluateBatch(expression::EvaluationContext(10.0f), features);
+        const auto actual = bound->evaluateBatch(expression::EvaluationContext(10.0f), features);
+        ASSERT_EQ(expected.size(), actual.size()) << json;
+        for (std::size_t i = 0; i < expected.size(); i++) {
+            expectEqual(expected[i], actual[i], json);
+        }
+    }
+}
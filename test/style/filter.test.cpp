@@ -196,3 +196,50 @@ TEST(Filter, ZoomExpressionNested) {
 TEST(Filter, Internal) {
     filter(R"(["filter-==","class","snow"])");
 }
+
+TEST(Filter, ConstantInputs) {
+    ASSERT_TRUE(filter(R"(["all"])"));
+    ASSERT_FALSE(filter(R"(["any"])"));
+    ASSERT_TRUE(filter(R"(["all", ["has", "$type"], ["==", "foo", "bar"]])", {{ "foo", std::string("bar") }}));
+    ASSERT_FALSE(filter(R"(["any", ["!has", "$type"], ["==", "foo", "bar"]])", {{ "foo", std::string("baz") }}));
+    ASSERT_TRUE(filter(R"(["any", ["has", "$type"], ["==", "foo", "bar"]])"));
+    ASSERT_FALSE(filter(R"(["none", ["has", "$type"], ["==", "foo", "bar"]])"));
+}
+
+FilterPredicate predicate(const char * json) {
+    conversion::Error error;
+    optional<Filter> filter = conversion::convertJSON<Filter>(json, error);
+    EXPECT_TRUE(bool(filter));
+    return filter ? filter->getPredicate() : FilterPredicate();
+}
+
+TEST(Filter, Predicate) {
+    FilterPredicate p = predicate(R"(["==", "$type", "Polygon"])");
+    ASSERT_TRUE(bool(p.types));
+    EXPECT_EQ(std::vector<FeatureType> { FeatureType::Polygon }, *p.types);
+    EXPECT_FALSE(bool(p.key));
+
+    p = predicate(R"(["all", ["in", "class", "park", "wood"], ["in", "$type", "Point", "Polygon"], [">", "rank", 2]])");
+    ASSERT_TRUE(bool(p.types));
+    EXPECT_EQ((std::vector<FeatureType> { FeatureType::Point, FeatureType::Polygon }), *p.types);
+    ASSERT_TRUE(bool(p.key));
+    EXPECT_EQ("class", *p.key);
+    ASSERT_TRUE(bool(p.values));
+    EXPECT_EQ((std::vector<expression::Value> { std::string("park"), std::string("wood") }), *p.values);
+
+    p = predicate(R"(["==", ["get", "class"], "park"])");
+    ASSERT_TRUE(bool(p.key));
+    EXPECT_EQ("class", *p.key);
+    ASSERT_TRUE(bool(p.values));
+    EXPECT_EQ(std::vector<expression::Value> { std::string("park") }, *p.values);
+
+    p = predicate(R"(["has", "name"])");
+    ASSERT_TRUE(bool(p.key));
+    EXPECT_EQ("name", *p.key);
+    EXPECT_FALSE(bool(p.values));
+
+    // Conditions that features may meet in other ways than by the values of a single property.
+    EXPECT_TRUE(predicate(R"(["any", ["==", "class", "park"], ["==", "$type", "Polygon"]])").empty());
+    EXPECT_TRUE(predicate(R"(["!=", "class", "park"])").empty());
+    EXPECT_TRUE(predicate(R"(["==", ["get", "class"], null])").empty());
+}
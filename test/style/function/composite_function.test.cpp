@@ -78,3 +78,25 @@ TEST(CompositeFunction, Issue8460) {
     EXPECT_NEAR(600.0f, fn2.evaluate(18.0f, oneInteger, -1.0f), 0.00);
     EXPECT_NEAR(600.0f, fn2.evaluate(19.0f, oneInteger, -1.0f), 0.00);
 }
+
+TEST(CompositeFunction, EvaluateBatch) {
+    CompositeFunction<float> fn(
+        interpolate(linear(), zoom(),
+            0.0, interpolate(linear(), number(get("property")), 1.0, literal(24.0), 3.0, literal(48.0)),
+            2.0, interpolate(linear(), number(get("property")), 1.0, literal(36.0), 3.0, literal(72.0))
+        ), 0.0f);
+
+    StubGeometryTileFeature two { PropertyMap {{ "property", uint64_t(2) }} };
+    const std::vector<const GeometryTileFeature*> features { &oneInteger, &two };
+
+    const std::vector<Range<float>> ranges = fn.evaluate({ 0.0f, 1.0f }, features, -1.0f);
+    ASSERT_EQ(2u, ranges.size());
+    EXPECT_EQ(24.0f, ranges[0].min);
+    EXPECT_EQ(30.0f, ranges[0].max);
+    EXPECT_EQ(36.0f, ranges[1].min);
+    EXPECT_EQ(45.0f, ranges[1].max);
+    for (std::size_t i = 0; i < features.size(); ++i) {
+        EXPECT_EQ(fn.evaluate(0.0f, *features[i], -1.0f), ranges[i].min);
+        EXPECT_EQ(fn.evaluate(1.0f, *features[i], -1.0f), ranges[i].max);
+    }
+}
@@ -33,3 +33,22 @@ TEST(SourceFunction, Defaults) {
     EXPECT_EQ(2.0f, SourceFunction<float>(number(get("property")))
         .evaluate(oneString, 2.0f));
 }
+
+TEST(SourceFunction, EvaluateBatch) {
+    using namespace mbgl::style::expression::dsl;
+
+    SourceFunction<float> function(
+        step(number(get("property")),
+            literal(10.0),
+            2.0, interpolate(linear(), number(get("property")), 2.0, literal(20.0), 4.0, literal(40.0))),
+        0.0);
+
+    StubGeometryTileFeature three { PropertyMap {{ "property", 3.0 }} };
+    const std::vector<const GeometryTileFeature*> features { &oneInteger, &oneDouble, &oneString, &three };
+
+    const std::vector<float> values = function.evaluate(features, 2.0f);
+    EXPECT_EQ(std::vector<float>({ 10.0f, 10.0f, 0.0f, 30.0f }), values);
+    for (std::size_t i = 0; i < features.size(); ++i) {
+        EXPECT_EQ(function.evaluate(*features[i], 2.0f), values[i]);
+    }
+}
@@ -22,6 +22,7 @@
 #include <mbgl/renderer/tile_parameters.hpp>
 
 #include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/constants.hpp>
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/io.hpp>
 #include <mbgl/util/premultiply.hpp>
@@ -68,7 +69,8 @@ public:
         annotationManager,
         imageManager,
         glyphManager,
-        0
+        0,
+        util::DEFAULT_MAX_TILE_CACHE_SIZE
     };
 
     SourceTest() {
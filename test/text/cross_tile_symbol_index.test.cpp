@@ -4,12 +4,16 @@
 
 using namespace mbgl;
 
+namespace {
+StringTable strings;
+} // namespace
+
 SymbolInstance makeSymbolInstance(float x, float y, std::u16string key) {
     GeometryCoordinates line;
     GlyphPositionMap gpm;
     const std::pair<Shaping, Shaping> shaping(Shaping{}, Shaping{});
     style::SymbolLayoutProperties::Evaluated layout_;
-    IndexedSubfeature subfeature(0, "", "", 0);
+    IndexedSubfeature subfeature(0, strings.intern(""), strings.intern(""), 0);
     Anchor anchor(x, y, 0, 0);
     return {anchor, line, shaping, {}, layout_, 0, 0, 0, style::SymbolPlacementType::Point, {{0, 0}}, 0, 0, {{0, 0}}, gpm, subfeature, 0, 0, key, 0 };
 }
@@ -55,11 +55,13 @@ public:
 
 class StubGlyphRequestor : public GlyphRequestor {
 public:
-    void onGlyphsAvailable(GlyphMap glyphs) override {
+    void onGlyphsAvailable(GlyphMap glyphs, optional<GlyphPositions> positions_) override {
+        positions = std::move(positions_);
         if (glyphsAvailable) glyphsAvailable(std::move(glyphs));
     }
 
     std::function<void (GlyphMap)> glyphsAvailable;
+    optional<GlyphPositions> positions;
 };
 
 class GlyphManagerTest {
@@ -223,6 +225,7 @@ TEST(GlyphManager, LoadLocalCJKGlyph) {
     
     test.requestor.glyphsAvailable = [&] (GlyphMap glyphs) {
         EXPECT_EQ(glyphResponses, 0); // Local generation should prevent requesting any glyphs
+        EXPECT_FALSE(test.requestor.positions); // No shared atlas
         
         const auto& testPositions = glyphs.at({{"Test Stack"}});
 
@@ -254,6 +257,33 @@ TEST(GlyphManager, LoadLocalCJKGlyph) {
 }
 
 
+TEST(GlyphManager, SharedAtlas) {
+    util::RunLoop loop;
+    StubFileSource fileSource;
+    GlyphManager glyphManager { fileSource, std::make_unique<StubLocalGlyphRasterizer>(), true };
+    const FontStack fontStack {{"Test Stack"}};
+
+    // Locally rasterized glyphs are provided immediately.
+    StubGlyphRequestor first;
+    StubGlyphRequestor second;
+    glyphManager.getGlyphs(first, GlyphDependencies { { fontStack, { u'中' } } });
+    glyphManager.getGlyphs(second, GlyphDependencies { { fontStack, { u'中' } } });
+
+    ASSERT_TRUE(first.positions);
+    ASSERT_TRUE(second.positions);
+
+    const GlyphPosition& position = first.positions->at(fontStack).at(u'中');
+    EXPECT_EQ(Rect<uint16_t>(0, 0, 32, 32), position.rect);
+    EXPECT_EQ(24u, position.metrics.width);
+    EXPECT_EQ(position.rect, second.positions->at(fontStack).at(u'中').rect);
+
+    const AlphaImage& atlasImage = glyphManager.getSharedAtlas()->getAtlasImage();
+    EXPECT_EQ(sdfBitmap[8], atlasImage.data[atlasImage.stride() + 9]);
+
+    glyphManager.removeRequestor(first);
+    glyphManager.removeRequestor(second);
+}
+
 TEST(GlyphManager, LoadingInvalid) {
     GlyphManagerTest test;
 
@@ -0,0 +1,310 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/test/fake_file_source.hpp>
+
+#include <mbgl/text/placement.hpp>
+#include <mbgl/text/pauseable_placement.hpp>
+#include <mbgl/tile/geometry_tile.hpp>
+#include <mbgl/renderer/tile_parameters.hpp>
+#include <mbgl/renderer/render_tile.hpp>
+#include <mbgl/renderer/layers/render_symbol_layer.hpp>
+#include <mbgl/renderer/buckets/symbol_bucket.hpp>
+#include <mbgl/renderer/image_manager.hpp>
+#include <mbgl/annotation/annotation_manager.hpp>
+#include <mbgl/text/glyph_manager.hpp>
+#include <mbgl/style/style.hpp>
+#include <mbgl/style/layers/symbol_layer.hpp>
+#include <mbgl/map/transform.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
+#include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/constants.hpp>
+
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+using namespace mbgl;
+using namespace mbgl::style;
+
+namespace {
+
+// A loaded tile whose symbol bucket is made up directly, rather than laid out from tile data.
+class StubSymbolTile : public GeometryTile {
+public:
+    StubSymbolTile(const OverscaledTileID& id_, const TileParameters& parameters, std::unique_ptr<SymbolBucket> bucket_)
+        : GeometryTile(id_, "source", parameters), bucket(std::move(bucket_)) {
+        renderable = true;
+    }
+
+    Bucket* getBucket(const Layer::Impl&) const override {
+        return bucket.get();
+    }
+
+    std::unique_ptr<SymbolBucket> bucket;
+};
+
+class PlacementTest {
+public:
+    PlacementTest() {
+        // Four zoom 1 tiles exactly fill the viewport, at 1/16 px per tile unit.
+        transform.resize({ 1024, 1024 });
+        transform.setZoom(1);
+        transform.getState().getProjMatrix(projMatrix);
+        layer = RenderLayer::create(symbolLayer.baseImpl);
+    }
+
+    // Adds a tile with a 40x20 px label at each of `anchors`, in tile units.
+    StubSymbolTile& addTile(const OverscaledTileID& tileID, const std::vector<Point<float>>& anchors) {
+        Shaping shaping;
+        shaping.top = -160;
+        shaping.bottom = 160;
+        shaping.left = -320;
+        shaping.right = 320;
+        const std::pair<Shaping, Shaping> shapedTextOrientations(shaping, Shaping{});
+
+        std::vector<SymbolInstance> instances;
+        for (const auto& point : anchors) {
+            Anchor anchor(point.x, point.y, 0, 0);
+            IndexedSubfeature subfeature(instances.size(), strings.intern(""), strings.intern(""), 0);
+            instances.emplace_back(anchor, GeometryCoordinates(), shapedTextOrientations, optional<PositionedIcon>(),
+                                   SymbolLayoutProperties::Evaluated(), 0, 1, 0, SymbolPlacementType::Point,
+                                   std::array<float, 2>{{ 0, 0 }}, 0, 0, std::array<float, 2>{{ 0, 0 }},
+                                   GlyphPositionMap(), subfeature, 0, 0, u"", 0);
+        }
+
+        auto bucket = std::make_unique<SymbolBucket>(SymbolLayoutProperties::PossiblyEvaluated(),
+            std::map<std::string, std::pair<IconPaintProperties::PossiblyEvaluated, TextPaintProperties::PossiblyEvaluated>>(),
+            16.0f, 1.0f, 0, false, false, false, symbolLayer.getID(), std::move(instances));
+        bucket->bucketInstanceId = ++maxBucketInstanceId;
+        for (auto& instance : bucket->symbolInstances) {
+            instance.crossTileID = ++maxCrossTileID;
+            instance.placedTextIndex = bucket->text.placedSymbols.size();
+            bucket->text.placedSymbols.emplace_back(instance.anchor.point, 0, 0, 0, std::array<float, 2>{{ 0, 0 }},
+                                                    WritingModeType::Horizontal, GeometryCoordinates(), std::vector<float>());
+        }
+
+        tiles.push_back(std::make_unique<StubSymbolTile>(tileID, tileParameters, std::move(bucket)));
+        return *tiles.back();
+    }
+
+    // Makes `renderedTiles` the ones the layer renders, in placement order, as the renderer does each frame.
+    void setRenderTiles(const std::vector<StubSymbolTile*>& renderedTiles) {
+        renderTiles.clear();
+        for (StubSymbolTile* tile : renderedTiles) {
+            renderTiles.emplace_back(tile->id.toUnwrapped(), *tile);
+        }
+        auto& renderSymbolLayer = *layer->as<RenderSymbolLayer>();
+        renderSymbolLayer.renderTiles.assign(renderTiles.begin(), renderTiles.end());
+    }
+
+    RenderSymbolLayer& renderLayer() {
+        return *layer->as<RenderSymbolLayer>();
+    }
+
+    // The buckets with symbols in the collision index.
+    static std::set<uint32_t> placedBuckets(const Placement& placement) {
+        std::set<uint32_t> result;
+        for (const auto& bucket : placement.getCollisionIndex().queryRenderedSymbols(
+                 {{ 0, 0 }, { 1024, 0 }, { 1024, 1024 }, { 0, 1024 }, { 0, 0 }})) {
+            result.insert(bucket.first);
+        }
+        return result;
+    }
+
+    FakeFileSource fileSource;
+    Transform transform;
+    util::RunLoop loop;
+    ThreadPool threadPool { 1 };
+    style::Style style { loop, fileSource, 1 };
+    AnnotationManager annotationManager { style };
+    ImageManager imageManager;
+    GlyphManager glyphManager { fileSource };
+
+    TileParameters tileParameters {
+        1.0,
+        MapDebugOptions(),
+        transform.getState(),
+        threadPool,
+        fileSource,
+        MapMode::Continuous,
+        annotationManager,
+        imageManager,
+        glyphManager,
+        0,
+        util::DEFAULT_MAX_TILE_CACHE_SIZE
+    };
+
+    mat4 projMatrix;
+    StringTable strings;
+    SymbolLayer symbolLayer { "symbols", "source" };
+    std::unique_ptr<RenderLayer> layer;
+    std::vector<std::unique_ptr<StubSymbolTile>> tiles;
+    std::vector<RenderTile> renderTiles;
+    uint32_t maxBucketInstanceId = 0;
+    uint32_t maxCrossTileID = 0;
+};
+
+} // namespace
+
+TEST(Placement, ReuseKeepsPriority) {
+    PlacementTest test;
+
+    // The labels are 24 px apart, so they collide.
+    auto& first = test.addTile(OverscaledTileID(1, 0, 0), {{ 8000, 4096 }});
+    auto& second = test.addTile(OverscaledTileID(1, 1, 0), {{ 200, 4096 }});
+
+    Placement initial(test.transform.getState(), MapMode::Continuous);
+
+    test.setRenderTiles({ &second });
+    Placement previous(test.transform.getState(), MapMode::Continuous);
+    previous.reuse(initial);
+    previous.placeLayer(test.renderLayer(), test.projMatrix, false);
+    previous.commit(initial, Clock::now());
+    EXPECT_EQ(std::set<uint32_t>({ second.bucket->bucketInstanceId }), PlacementTest::placedBuckets(previous));
+
+    // The new tile comes first, so its label wins over the one placed before, even though
+    // the camera didn't move.
+    test.setRenderTiles({ &first, &second });
+    Placement placement(test.transform.getState(), MapMode::Continuous);
+    placement.reuse(previous);
+    placement.placeLayer(test.renderLayer(), test.projMatrix, false);
+    placement.commit(previous, Clock::now());
+    EXPECT_EQ(std::set<uint32_t>({ first.bucket->bucketInstanceId }), PlacementTest::placedBuckets(placement));
+
+    // Reusing that placement keeps the same result.
+    Placement next(test.transform.getState(), MapMode::Continuous);
+    next.reuse(placement);
+    next.placeLayer(test.renderLayer(), test.projMatrix, false);
+    next.commit(placement, Clock::now());
+    EXPECT_EQ(std::set<uint32_t>({ first.bucket->bucketInstanceId }), PlacementTest::placedBuckets(next));
+}
+
+TEST(Placement, ReuseWithinTolerance) {
+    PlacementTest test;
+
+    auto& tile = test.addTile(OverscaledTileID(1, 0, 0), {{ 4096, 4096 }});
+    test.setRenderTiles({ &tile });
+    const CollisionBox& box = tile.bucket->symbolInstances.front().textCollisionFeature.boxes.front();
+
+    Placement initial(test.transform.getState(), MapMode::Continuous);
+    auto previous = std::make_unique<Placement>(test.transform.getState(), MapMode::Continuous);
+    previous->reuse(initial);
+    previous->placeLayer(test.renderLayer(), test.projMatrix, false);
+    previous->commit(initial, Clock::now());
+    const float projectedX = box.px1;
+
+    auto placeAfterMove = [&](double dx) {
+        test.transform.moveBy({ dx, 0 });
+        test.transform.getState().getProjMatrix(test.projMatrix);
+        auto placement = std::make_unique<Placement>(test.transform.getState(), MapMode::Continuous);
+        placement->reuse(*previous);
+        placement->placeLayer(test.renderLayer(), test.projMatrix, false);
+        placement->commit(*previous, Clock::now());
+        previous = std::move(placement);
+        EXPECT_EQ(std::set<uint32_t>({ tile.bucket->bucketInstanceId }), PlacementTest::placedBuckets(*previous));
+    };
+
+    // The boxes are reused while the tile stays within half a pixel of where they were projected,
+    // even across several placements.
+    placeAfterMove(0.2);
+    EXPECT_EQ(projectedX, box.px1);
+    placeAfterMove(0.2);
+    EXPECT_EQ(projectedX, box.px1);
+
+    // Past that, they are projected again.
+    placeAfterMove(0.2);
+    EXPECT_NEAR(0.6, box.px1 - projectedX, 0.01);
+}
+
+TEST(Placement, PauseAndResume) {
+    PlacementTest test;
+
+    auto& a = test.addTile(OverscaledTileID(1, 0, 0), {{ 4096, 4096 }});
+    auto& b = test.addTile(OverscaledTileID(1, 1, 0), {{ 4096, 4096 }});
+    auto& c = test.addTile(OverscaledTileID(1, 0, 1), {{ 4096, 4096 }});
+    test.setRenderTiles({ &a, &b, &c });
+
+    Placement placement(test.transform.getState(), MapMode::Continuous);
+    LayerPlacementProgress progress;
+    auto shouldPause = [] { return true; };
+
+    // Each call places one tile.
+    EXPECT_FALSE(placement.placeLayer(test.renderLayer(), test.projMatrix, false, progress, shouldPause));
+    EXPECT_FALSE(placement.placeLayer(test.renderLayer(), test.projMatrix, false, progress, shouldPause));
+    EXPECT_TRUE(placement.placeLayer(test.renderLayer(), test.projMatrix, false, progress, shouldPause));
+
+    EXPECT_EQ(std::set<uint32_t>({ a.bucket->bucketInstanceId, b.bucket->bucketInstanceId, c.bucket->bucketInstanceId }),
+              PlacementTest::placedBuckets(placement));
+}
+
+TEST(Placement, ResumeAfterTilesChanged) {
+    PlacementTest test;
+
+    auto& a = test.addTile(OverscaledTileID(1, 0, 0), {{ 4096, 4096 }});
+    auto& b = test.addTile(OverscaledTileID(1, 1, 0), {{ 4096, 4096 }});
+    auto& c = test.addTile(OverscaledTileID(1, 0, 1), {{ 4096, 4096 }});
+    auto& d = test.addTile(OverscaledTileID(1, 1, 1), {{ 4096, 4096 }});
+    auto shouldPause = [] { return true; };
+
+    {
+        // A tile placed in the first frame is gone by the next one: the other tiles are still placed.
+        test.setRenderTiles({ &a, &b, &c });
+        Placement placement(test.transform.getState(), MapMode::Continuous);
+        LayerPlacementProgress progress;
+        EXPECT_FALSE(placement.placeLayer(test.renderLayer(), test.projMatrix, false, progress, shouldPause));
+
+        test.setRenderTiles({ &b, &c });
+        while (!placement.placeLayer(test.renderLayer(), test.projMatrix, false, progress, shouldPause)) {}
+
+        EXPECT_EQ(std::set<uint32_t>({ a.bucket->bucketInstanceId, b.bucket->bucketInstanceId, c.bucket->bucketInstanceId }),
+                  PlacementTest::placedBuckets(placement));
+    }
+
+    {
+        // A tile added in front is left to the next placement, and no tile is placed twice.
+        test.setRenderTiles({ &a, &b, &c });
+        Placement placement(test.transform.getState(), MapMode::Continuous);
+        LayerPlacementProgress progress;
+        EXPECT_FALSE(placement.placeLayer(test.renderLayer(), test.projMatrix, false, progress, shouldPause));
+
+        test.setRenderTiles({ &d, &a, &b, &c });
+        EXPECT_FALSE(placement.placeLayer(test.renderLayer(), test.projMatrix, false, progress, shouldPause));
+        EXPECT_TRUE(placement.placeLayer(test.renderLayer(), test.projMatrix, false, progress, shouldPause));
+
+        EXPECT_EQ(std::set<uint32_t>({ a.bucket->bucketInstanceId, b.bucket->bucketInstanceId, c.bucket->bucketInstanceId }),
+                  PlacementTest::placedBuckets(placement));
+    }
+}
+
+TEST(PauseablePlacement, Deadline) {
+    PlacementTest test;
+
+    auto& a = test.addTile(OverscaledTileID(1, 0, 0), {{ 4096, 4096 }});
+    auto& b = test.addTile(OverscaledTileID(1, 1, 0), {{ 4096, 4096 }});
+    test.setRenderTiles({ &a, &b });
+    const std::vector<std::reference_wrapper<RenderSymbolLayer>> layers { test.renderLayer() };
+
+    Placement initial(test.transform.getState(), MapMode::Continuous);
+
+    // Past the deadline, each call places one tile.
+    PauseablePlacement pauseable(test.transform.getState(), MapMode::Continuous, test.projMatrix, false,
+                                 { test.symbolLayer.getID() }, initial, nullptr);
+    pauseable.continuePlacement(layers, Clock::now());
+    EXPECT_FALSE(pauseable.isDone());
+    pauseable.continuePlacement(layers, Clock::now());
+    ASSERT_TRUE(pauseable.isDone());
+
+    auto placement = pauseable.commit(initial, Clock::now());
+    EXPECT_EQ(std::set<uint32_t>({ a.bucket->bucketInstanceId, b.bucket->bucketInstanceId }),
+              PlacementTest::placedBuckets(*placement));
+
+    // Without a deadline, placing completes at once.
+    PauseablePlacement unbounded(test.transform.getState(), MapMode::Continuous, test.projMatrix, false,
+                                 { test.symbolLayer.getID() }, *placement, nullptr);
+    unbounded.continuePlacement(layers, {});
+    ASSERT_TRUE(unbounded.isDone());
+
+    auto next = unbounded.commit(*placement, Clock::now());
+    EXPECT_EQ(std::set<uint32_t>({ a.bucket->bucketInstanceId, b.bucket->bucketInstanceId }),
+              PlacementTest::placedBuckets(*next));
+}
@@ -0,0 +1,102 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/text/bidi.hpp>
+#include <mbgl/text/shaping.hpp>
+#include <mbgl/text/shaping_cache.hpp>
+
+using namespace mbgl;
+using namespace mbgl::style;
+
+namespace {
+
+Glyphs makeGlyphs(const std::u16string& string) {
+    Glyphs glyphs;
+    for (char16_t chr : string) {
+        Glyph glyph;
+        glyph.id = chr;
+        glyph.metrics.width = 10;
+        glyph.metrics.height = 20;
+        glyph.metrics.advance = 12;
+        glyphs.emplace(chr, makeMutable<Glyph>(std::move(glyph)));
+    }
+    return glyphs;
+}
+
+Shaping shape(ShapingCache& cache, const std::u16string& string, BiDi& bidi, const Glyphs& glyphs,
+              float spacing = 0) {
+    return cache.getShaping(string, { "Test Regular" }, 240, 24, SymbolAnchorType::Center,
+                            TextJustifyType::Center, spacing, { 0, 0 }, 24,
+                            WritingModeType::Horizontal, bidi, glyphs);
+}
+
+} // namespace
+
+TEST(ShapingCache, MatchesShaping) {
+    ShapingCache cache;
+    BiDi bidi;
+    const Glyphs glyphs = makeGlyphs(u"Main Street");
+
+    const Shaping expected = getShaping(u"Main Street", 240, 24, SymbolAnchorType::Center,
+                                        TextJustifyType::Center, 0, { 0, 0 }, 24,
+                                        WritingModeType::Horizontal, bidi, glyphs);
+
+    for (int i = 0; i < 2; i++) {
+        const Shaping shaping = shape(cache, u"Main Street", bidi, glyphs);
+        ASSERT_EQ(expected.positionedGlyphs.size(), shaping.positionedGlyphs.size());
+        for (std::size_t j = 0; j < expected.positionedGlyphs.size(); j++) {
+            EXPECT_EQ(expected.positionedGlyphs[j].glyph, shaping.positionedGlyphs[j].glyph);
+            EXPECT_EQ(expected.positionedGlyphs[j].x, shaping.positionedGlyphs[j].x);
+            EXPECT_EQ(expected.positionedGlyphs[j].y, shaping.positionedGlyphs[j].y);
+        }
+        EXPECT_EQ(expected.top, shaping.top);
+        EXPECT_EQ(expected.bottom, shaping.bottom);
+        EXPECT_EQ(expected.left, shaping.left);
+        EXPECT_EQ(expected.right, shaping.right);
+    }
+
+    const auto stats = cache.getStats();
+    EXPECT_EQ(1u, stats.hits);
+    EXPECT_EQ(1u, stats.misses);
+    EXPECT_EQ(1u, stats.size);
+}
+
+TEST(ShapingCache, KeyedByLayoutAndGlyphs) {
+    ShapingCache cache;
+    BiDi bidi;
+    const Glyphs glyphs = makeGlyphs(u"Main Street");
+
+    shape(cache, u"Main Street", bidi, glyphs);
+    shape(cache, u"Main Street", bidi, glyphs, 2);
+    EXPECT_EQ(0u, cache.getStats().hits);
+
+    // Shaping skips missing glyphs, so the shaping without them is a different one.
+    const Glyphs withoutSpace = makeGlyphs(u"MainStreet");
+    EXPECT_EQ(10u, shape(cache, u"Main Street", bidi, withoutSpace).positionedGlyphs.size());
+    EXPECT_EQ(0u, cache.getStats().hits);
+    EXPECT_EQ(3u, cache.getStats().size);
+
+    EXPECT_EQ(11u, shape(cache, u"Main Street", bidi, glyphs).positionedGlyphs.size());
+    EXPECT_EQ(1u, cache.getStats().hits);
+}
+
+TEST(ShapingCache, EvictsLeastRecentlyUsed) {
+    ShapingCache cache(2);
+    BiDi bidi;
+    const Glyphs glyphs = makeGlyphs(u"ABC");
+
+    shape(cache, u"A", bidi, glyphs);
+    shape(cache, u"B", bidi, glyphs);
+    shape(cache, u"A", bidi, glyphs);
+    shape(cache, u"C", bidi, glyphs);
+    EXPECT_EQ(2u, cache.getStats().size);
+
+    shape(cache, u"A", bidi, glyphs);
+    EXPECT_EQ(2u, cache.getStats().hits);
+
+    shape(cache, u"B", bidi, glyphs);
+    EXPECT_EQ(2u, cache.getStats().hits);
+    EXPECT_EQ(4u, cache.getStats().misses);
+
+    cache.clear();
+    EXPECT_EQ(0u, cache.getStats().size);
+}
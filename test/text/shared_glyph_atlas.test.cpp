@@ -0,0 +1,127 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/text/glyph_manager.hpp>
+#include <mbgl/text/shared_glyph_atlas.hpp>
+#include <mbgl/renderer/backend_scope.hpp>
+#include <mbgl/gl/headless_backend.hpp>
+#include <mbgl/gl/context.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+class StubGlyphRequestor : public GlyphRequestor {
+public:
+    void onGlyphsAvailable(GlyphMap, optional<GlyphPositions>) override {}
+};
+
+const FontStack fontStack {{ "Test Stack" }};
+
+// Glyphs with a 10x10 bitmap, which take 12x12 pixels of the atlas with their padding.
+GlyphMap makeGlyphs(const std::u16string& ids) {
+    Glyphs glyphs;
+    for (char16_t id : ids) {
+        Glyph glyph;
+        glyph.id = id;
+        glyph.bitmap = AlphaImage({ 10, 10 });
+        glyph.bitmap.fill(static_cast<uint8_t>(id));
+        glyphs.emplace(id, makeMutable<Glyph>(std::move(glyph)));
+    }
+    return { { fontStack, std::move(glyphs) } };
+}
+
+} // namespace
+
+TEST(SharedGlyphAtlas, SharesGlyphs) {
+    SharedGlyphAtlas atlas;
+    StubGlyphRequestor first;
+    StubGlyphRequestor second;
+    const GlyphMap glyphs = makeGlyphs(u"AB");
+
+    optional<GlyphPositions> firstPositions = atlas.addGlyphs(first, glyphs);
+    optional<GlyphPositions> secondPositions = atlas.addGlyphs(second, glyphs);
+    ASSERT_TRUE(firstPositions);
+    ASSERT_TRUE(secondPositions);
+
+    const GlyphPositionMap& positions = firstPositions->at(fontStack);
+    ASSERT_EQ(2u, positions.size());
+    EXPECT_EQ(Rect<uint16_t>(0, 0, 12, 12), positions.at(u'A').rect);
+    EXPECT_EQ(Rect<uint16_t>(12, 0, 12, 12), positions.at(u'B').rect);
+    EXPECT_EQ(positions.at(u'A').rect, secondPositions->at(fontStack).at(u'A').rect);
+    EXPECT_EQ(positions.at(u'B').rect, secondPositions->at(fontStack).at(u'B').rect);
+
+    const AlphaImage& image = atlas.getAtlasImage();
+    EXPECT_EQ(Size(256, 256), image.size);
+    EXPECT_EQ(0, image.data[0]);
+    EXPECT_EQ(u'A', image.data[image.stride() + 1]);
+    EXPECT_EQ(u'B', image.data[image.stride() + 13]);
+}
+
+TEST(SharedGlyphAtlas, GrowsAndEvicts) {
+    SharedGlyphAtlas atlas({ 16, 16 }, { 32, 32 });
+    StubGlyphRequestor first;
+    StubGlyphRequestor second;
+    StubGlyphRequestor third;
+
+    // Four glyphs only fit once the atlas has grown to its maximum size.
+    optional<GlyphPositions> positions = atlas.addGlyphs(first, makeGlyphs(u"ABCD"));
+    ASSERT_TRUE(positions);
+    EXPECT_EQ(4u, positions->at(fontStack).size());
+    EXPECT_EQ(Size(32, 32), atlas.getPixelSize());
+    EXPECT_EQ(Size(32, 32), atlas.getAtlasImage().size);
+    EXPECT_EQ(Rect<uint16_t>(0, 0, 12, 12), positions->at(fontStack).at(u'A').rect);
+
+    // There is no room for a fifth one while the first requestor holds the others, and the second
+    // requestor no longer gets positions after that.
+    EXPECT_FALSE(atlas.addGlyphs(second, makeGlyphs(u"E")));
+    EXPECT_FALSE(atlas.addGlyphs(second, makeGlyphs(u"")));
+
+    // Once they're released, they are evicted to make room.
+    atlas.removeRequestor(first);
+    positions = atlas.addGlyphs(third, makeGlyphs(u"E"));
+    ASSERT_TRUE(positions);
+    const Rect<uint16_t> rect = positions->at(fontStack).at(u'E').rect;
+    EXPECT_EQ(Size(32, 32), atlas.getPixelSize());
+
+    const AlphaImage& image = atlas.getAtlasImage();
+    EXPECT_EQ(u'E', image.data[(rect.y + 1) * image.stride() + rect.x + 1]);
+    EXPECT_EQ(0, image.data[rect.y * image.stride() + rect.x]);
+
+    atlas.removeRequestor(second);
+    EXPECT_TRUE(atlas.addGlyphs(second, makeGlyphs(u"E")));
+}
+
+TEST(SharedGlyphAtlas, UploadsChangedRect) {
+    HeadlessBackend backend { { 256, 256 } };
+    BackendScope scope { backend };
+    gl::Context context;
+
+    SharedGlyphAtlas atlas({ 16, 16 }, { 32, 32 });
+    StubGlyphRequestor first;
+    StubGlyphRequestor second;
+
+    ASSERT_TRUE(atlas.addGlyphs(first, makeGlyphs(u"A")));
+    EXPECT_EQ(Rect<uint32_t>(0, 0, 12, 12), *atlas.getDirtyRect());
+    atlas.upload(context, 0);
+    EXPECT_FALSE(atlas.getDirtyRect());
+
+    // The atlas grows to fit the next glyph, so the whole texture is replaced.
+    ASSERT_TRUE(atlas.addGlyphs(first, makeGlyphs(u"B")));
+    EXPECT_EQ(Size(32, 32), atlas.getPixelSize());
+    atlas.upload(context, 0);
+    EXPECT_FALSE(atlas.getDirtyRect());
+
+    // Glyphs added to an atlas of the same size are uploaded as one rectangle covering them.
+    ASSERT_TRUE(atlas.addGlyphs(first, makeGlyphs(u"CD")));
+    EXPECT_EQ(Rect<uint32_t>(0, 12, 24, 12), *atlas.getDirtyRect());
+    atlas.upload(context, 0);
+    EXPECT_FALSE(atlas.getDirtyRect());
+
+    // Evicted glyphs are cleared, and so uploaded too.
+    atlas.removeRequestor(first);
+    optional<GlyphPositions> positions = atlas.addGlyphs(second, makeGlyphs(u"E"));
+    ASSERT_TRUE(positions);
+    EXPECT_EQ(Rect<uint32_t>(0, 0, 24, 24), *atlas.getDirtyRect());
+    atlas.upload(context, 0);
+    EXPECT_FALSE(atlas.getDirtyRect());
+}
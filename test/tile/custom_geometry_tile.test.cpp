@@ -7,6 +7,7 @@
 
 #include <mbgl/util/default_thread_pool.hpp>
 #include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/constants.hpp>
 #include <mbgl/map/transform.hpp>
 #include <mbgl/renderer/tile_parameters.hpp>
 #include <mbgl/style/style.hpp>
@@ -41,7 +42,8 @@ public:
         annotationManager,
         imageManager,
         glyphManager,
-        0
+        0,
+        util::DEFAULT_MAX_TILE_CACHE_SIZE
     };
 };
 
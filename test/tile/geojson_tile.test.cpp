@@ -2,19 +2,25 @@
 #include <mbgl/test/fake_file_source.hpp>
 #include <mbgl/test/stub_tile_observer.hpp>
 #include <mbgl/tile/geojson_tile.hpp>
+#include <mbgl/tile/geometry_tile_worker.hpp>
 #include <mbgl/tile/tile_loader_impl.hpp>
 
 #include <mbgl/util/default_thread_pool.hpp>
 #include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/constants.hpp>
 #include <mbgl/map/transform.hpp>
 #include <mbgl/renderer/tile_parameters.hpp>
 #include <mbgl/style/style.hpp>
 #include <mbgl/style/layers/circle_layer.hpp>
+#include <mbgl/style/conversion/json.hpp>
+#include <mbgl/style/conversion/filter.hpp>
+#include <mbgl/renderer/buckets/circle_bucket.hpp>
 #include <mbgl/annotation/annotation_manager.hpp>
 #include <mbgl/renderer/image_manager.hpp>
 #include <mbgl/text/glyph_manager.hpp>
 
 #include <memory>
+#include <thread>
 
 using namespace mbgl;
 using namespace mbgl::style;
@@ -41,7 +47,8 @@ public:
         annotationManager,
         imageManager,
         glyphManager,
-        0
+        0,
+        util::DEFAULT_MAX_TILE_CACHE_SIZE
     };
 };
 
@@ -113,3 +120,82 @@ TEST(GeoJSONTile, Issue9927) {
     ASSERT_TRUE(tile.isRenderable());
     ASSERT_NE(nullptr, tile.getBucket(*layer.baseImpl));
  }
+
+// A parse that starts once the tile has been cancelled is abandoned right away, and counted.
+TEST(GeoJSONTile, AbandonedParse) {
+    GeoJSONTileTest test;
+
+    CircleLayer layer("circle", "source");
+
+    mapbox::geometry::feature_collection<int16_t> features;
+    features.push_back(mapbox::geometry::feature<int16_t> {
+        mapbox::geometry::point<int16_t>(0, 0)
+    });
+
+    GeoJSONTile tile(OverscaledTileID(0, 0, 0), "source", test.tileParameters, features);
+
+    const uint64_t abandonedParses = GeometryTileWorker::getObsoleteWorkStats().abandonedParses;
+    tile.cancel();
+    tile.setLayers({{ layer.baseImpl }});
+
+    // An abandoned parse doesn't report back to the tile, so wait for the count to change.
+    const TimePoint deadline = Clock::now() + Seconds(10);
+    while (GeometryTileWorker::getObsoleteWorkStats().abandonedParses == abandonedParses &&
+           Clock::now() < deadline) {
+        std::this_thread::sleep_for(Milliseconds(1));
+    }
+
+    EXPECT_EQ(abandonedParses + 1, GeometryTileWorker::getObsoleteWorkStats().abandonedParses);
+    EXPECT_EQ(nullptr, tile.getBucket(*layer.baseImpl));
+}
+
+// Layers that use the same source layer are parsed together, and each still gets only the
+// features that pass its own filter, including groups of layers that share an equal filter.
+TEST(GeoJSONTile, SharedSourceLayer) {
+    GeoJSONTileTest test;
+
+    auto filter = [] (const char* json) {
+        conversion::Error error;
+        optional<Filter> result = conversion::convertJSON<Filter>(json, error);
+        EXPECT_TRUE(bool(result));
+        return *result;
+    };
+
+    CircleLayer a("a", "source");
+    a.setFilter(filter(R"(["==", "kind", "a"])"));
+    CircleLayer b("b", "source");
+    b.setFilter(filter(R"(["==", "kind", "b"])"));
+    // A different max zoom puts this layer in a group of its own, with a filter equal to b's.
+    CircleLayer sameFilter("sameFilter", "source");
+    sameFilter.setFilter(filter(R"(["==", "kind", "b"])"));
+    sameFilter.setMaxZoom(20);
+    CircleLayer none("none", "source");
+    none.setFilter(filter(R"(["==", "kind", "c"])"));
+    CircleLayer all("all", "source");
+
+    mapbox::geometry::feature_collection<int16_t> features;
+    for (const char* kind : { "a", "b", "b" }) {
+        mapbox::geometry::feature<int16_t> feature { mapbox::geometry::point<int16_t>(0, 0) };
+        feature.properties["kind"] = std::string(kind);
+        features.push_back(feature);
+    }
+
+    GeoJSONTile tile(OverscaledTileID(0, 0, 0), "source", test.tileParameters, features);
+    tile.setLayers({{ a.baseImpl, b.baseImpl, sameFilter.baseImpl, none.baseImpl, all.baseImpl }});
+
+    while (!tile.isComplete()) {
+        test.loop.runOnce();
+    }
+
+    auto vertexCount = [&] (const CircleLayer& layer) {
+        auto bucket = static_cast<CircleBucket*>(tile.getBucket(*layer.baseImpl));
+        return bucket ? bucket->vertices.vertexSize() : 0;
+    };
+
+    EXPECT_EQ(4u, vertexCount(a));
+    EXPECT_EQ(8u, vertexCount(b));
+    EXPECT_EQ(8u, vertexCount(sameFilter));
+    EXPECT_NE(tile.getBucket(*b.baseImpl), tile.getBucket(*sameFilter.baseImpl));
+    EXPECT_EQ(0u, vertexCount(none));
+    EXPECT_EQ(12u, vertexCount(all));
+}
@@ -6,6 +6,7 @@
 #include <mbgl/style/style.hpp>
 #include <mbgl/util/default_thread_pool.hpp>
 #include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/constants.hpp>
 #include <mbgl/map/transform.hpp>
 #include <mbgl/annotation/annotation_manager.hpp>
 #include <mbgl/renderer/tile_parameters.hpp>
@@ -37,7 +38,8 @@ public:
         annotationManager,
         imageManager,
         glyphManager,
-        0
+        0,
+        util::DEFAULT_MAX_TILE_CACHE_SIZE
     };
 };
 
@@ -0,0 +1,109 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/tile/tile_cache.hpp>
+#include <mbgl/tile/tile.hpp>
+
+#include <memory>
+
+using namespace mbgl;
+
+namespace {
+
+class FakeTile : public Tile {
+public:
+    FakeTile(const OverscaledTileID& id_, std::size_t bytes_)
+        : Tile(id_), bytes(bytes_) {
+        renderable = true;
+    }
+
+    void upload(gl::Context&) override {}
+    Bucket* getBucket(const style::Layer::Impl&) const override { return nullptr; }
+
+    MemoryUsage getMemoryUsage() const override {
+        return { bytes / 2, bytes - bytes / 2 };
+    }
+
+private:
+    const std::size_t bytes;
+};
+
+std::unique_ptr<Tile> makeTile(const OverscaledTileID& id, std::size_t bytes) {
+    return std::make_unique<FakeTile>(id, bytes);
+}
+
+} // namespace
+
+TEST(TileCache, EvictsByCount) {
+    TileCache cache(2);
+    const OverscaledTileID a { 1, 0, 0 }, b { 1, 0, 1 }, c { 1, 1, 0 };
+
+    cache.add(a, makeTile(a, 10));
+    cache.add(b, makeTile(b, 10));
+    cache.add(c, makeTile(c, 10));
+
+    EXPECT_FALSE(cache.has(a));
+    EXPECT_TRUE(cache.has(b));
+    EXPECT_TRUE(cache.has(c));
+    EXPECT_EQ(20u, cache.getBytes());
+}
+
+TEST(TileCache, EvictsByBytes) {
+    TileCache cache(10);
+    cache.setMaximumBytes(100);
+    const OverscaledTileID a { 1, 0, 0 }, b { 1, 0, 1 }, c { 1, 1, 0 };
+
+    cache.add(a, makeTile(a, 40));
+    cache.add(b, makeTile(b, 40));
+    EXPECT_EQ(80u, cache.getBytes());
+
+    // Pushes the total over the limit, so the least recently added tile goes.
+    cache.add(c, makeTile(c, 30));
+    EXPECT_FALSE(cache.has(a));
+    EXPECT_TRUE(cache.has(b));
+    EXPECT_TRUE(cache.has(c));
+    EXPECT_EQ(70u, cache.getBytes());
+
+    auto tile = cache.pop(b);
+    ASSERT_TRUE(bool(tile));
+    EXPECT_EQ(30u, cache.getBytes());
+
+    // Lowering the limit evicts right away.
+    cache.setMaximumBytes(20);
+    EXPECT_FALSE(cache.has(c));
+    EXPECT_EQ(0u, cache.getBytes());
+}
+
+TEST(TileCache, RejectsOversizedTiles) {
+    TileCache cache(10);
+    cache.setMaximumBytes(100);
+    const OverscaledTileID a { 1, 0, 0 }, b { 1, 0, 1 };
+
+    cache.add(a, makeTile(a, 50));
+    cache.add(b, makeTile(b, 101));
+
+    EXPECT_TRUE(cache.has(a));
+    EXPECT_FALSE(cache.has(b));
+    EXPECT_EQ(50u, cache.getBytes());
+
+    cache.clear();
+    EXPECT_EQ(0u, cache.getBytes());
+}
+
+TEST(TileCache, AddingExistingTileRefreshesIt) {
+    TileCache cache(2);
+    const OverscaledTileID a { 1, 0, 0 }, b { 1, 0, 1 }, c { 1, 1, 0 };
+
+    cache.add(a, makeTile(a, 10));
+    Tile* original = cache.get(a);
+    cache.add(b, makeTile(b, 10));
+
+    // The cached tile is kept, but is now the most recently used one.
+    cache.add(a, makeTile(a, 20));
+    EXPECT_EQ(original, cache.get(a));
+    EXPECT_EQ(20u, cache.getBytes());
+
+    cache.add(c, makeTile(c, 10));
+    EXPECT_TRUE(cache.has(a));
+    EXPECT_FALSE(cache.has(b));
+    EXPECT_TRUE(cache.has(c));
+}
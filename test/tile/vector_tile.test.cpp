@@ -1,12 +1,16 @@
 #include <mbgl/test/util.hpp>
 #include <mbgl/test/fake_file_source.hpp>
 #include <mbgl/tile/vector_tile.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
 #include <mbgl/tile/tile_loader_impl.hpp>
 
 #include <mbgl/util/default_thread_pool.hpp>
 #include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/io.hpp>
 #include <mbgl/map/transform.hpp>
 #include <mbgl/style/style.hpp>
+#include <mbgl/style/filter.hpp>
 #include <mbgl/style/layers/symbol_layer.hpp>
 #include <mbgl/renderer/tile_parameters.hpp>
 #include <mbgl/renderer/buckets/symbol_bucket.hpp>
@@ -42,7 +46,8 @@ public:
         annotationManager,
         imageManager,
         glyphManager,
-        0
+        0,
+        util::DEFAULT_MAX_TILE_CACHE_SIZE
     };
 };
 
@@ -73,3 +78,64 @@ TEST(VectorTile, Issue8542) {
     std::vector<Feature> result;
     tile.querySourceFeatures(result, { { {"layer"} }, {} });
 }
+
+TEST(VectorTile, FeatureProperties) {
+    VectorTileData data(std::make_shared<std::string>(
+        util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf")));
+    auto layer = data.getLayer("place_label");
+    ASSERT_TRUE(layer);
+
+    auto feature = layer->getFeature(0);
+    EXPECT_TRUE(Value(std::string("San Francisco")) == feature->getValue("name"));
+    EXPECT_TRUE(Value(int64_t(1)) == feature->getValue("scalerank"));
+    EXPECT_FALSE(feature->getValue("class"));
+
+    const PropertyMap properties = feature->getProperties();
+    EXPECT_EQ(11u, properties.size());
+    EXPECT_TRUE(properties.at("name_ru") == feature->getValue("name_ru"));
+
+    // Values are shared by features of the layer.
+    EXPECT_TRUE(Value(std::string("city")) == layer->getFeature(1)->getValue("type"));
+}
+
+TEST(VectorTile, FeatureIndices) {
+    VectorTileData data(std::make_shared<std::string>(
+        util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf")));
+    auto layer = data.getLayer("place_label");
+    ASSERT_TRUE(layer);
+
+    style::FilterPredicate predicate;
+    EXPECT_EQ(layer->featureCount(), layer->getFeatureIndices(predicate).size());
+
+    // The features that are left out are exactly those that don't meet the predicate.
+    predicate.types = std::vector<FeatureType> { FeatureType::Point };
+    predicate.key = std::string("type");
+    predicate.values = std::vector<style::expression::Value> { std::string("city") };
+    std::vector<std::size_t> expected;
+    for (std::size_t i = 0; i < layer->featureCount(); ++i) {
+        auto feature = layer->getFeature(i);
+        if (feature->getType() == FeatureType::Point &&
+            Value(std::string("city")) == feature->getValue("type")) {
+            expected.push_back(i);
+        }
+    }
+    EXPECT_FALSE(expected.empty());
+    EXPECT_LT(expected.size(), layer->featureCount());
+    EXPECT_EQ(expected, layer->getFeatureIndices(predicate));
+
+    predicate.key = std::string("missing");
+    EXPECT_TRUE(layer->getFeatureIndices(predicate).empty());
+}
+
+TEST(VectorTile, Clone) {
+    VectorTileData data(std::make_shared<std::string>(
+        util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf")));
+    std::unique_ptr<GeometryTileData> clone = data.clone();
+
+    auto layer = data.getLayer("place_label");
+    auto clonedLayer = clone->getLayer("place_label");
+    ASSERT_TRUE(layer);
+    ASSERT_TRUE(clonedLayer);
+    EXPECT_EQ(layer->featureCount(), clonedLayer->featureCount());
+    EXPECT_EQ(nullptr, clone->getLayer("missing"));
+}
@@ -0,0 +1,56 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/blob.hpp>
+
+using namespace mbgl;
+
+TEST(Blob, Null) {
+    Blob blob;
+    EXPECT_FALSE(blob);
+    EXPECT_EQ(nullptr, blob);
+    EXPECT_EQ(nullptr, blob.data());
+    EXPECT_EQ(0u, blob.size());
+    EXPECT_EQ(nullptr, blob.get());
+    EXPECT_EQ(nullptr, blob.string());
+}
+
+TEST(Blob, String) {
+    auto string = std::make_shared<const std::string>("foobar");
+    Blob blob = string;
+    EXPECT_TRUE(blob);
+    EXPECT_EQ(string->data(), blob.data());
+    EXPECT_EQ(6u, blob.size());
+
+    // The string is shared, not copied.
+    EXPECT_EQ(string, blob.string());
+    EXPECT_EQ(string.get(), blob.get());
+    EXPECT_EQ("foobar", *blob);
+}
+
+TEST(Blob, Owner) {
+    auto owner = std::make_shared<std::string>("foobar");
+    std::weak_ptr<std::string> weak = owner;
+
+    Blob blob(owner->data() + 3, 3, owner);
+    owner.reset();
+    EXPECT_FALSE(weak.expired());
+    EXPECT_EQ("bar", std::string(blob.data(), blob.size()));
+
+    // Materializes a copy once, which is then reused.
+    const std::string* string = blob.get();
+    EXPECT_EQ("bar", *string);
+    EXPECT_EQ(string, Blob(blob).get());
+    EXPECT_EQ(3u, blob->size());
+
+    blob = nullptr;
+    EXPECT_TRUE(weak.expired());
+}
+
+TEST(Blob, Identity) {
+    auto string = std::make_shared<const std::string>("foobar");
+    Blob a = string;
+    Blob b = a;
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, Blob(string));
+    EXPECT_NE(a, nullptr);
+}
@@ -0,0 +1,22 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/cancellation_token.hpp>
+
+using namespace mbgl;
+
+TEST(CancellationToken, Default) {
+    CancellationToken token;
+    EXPECT_FALSE(token.isCancelled());
+}
+
+TEST(CancellationToken, FollowsFlag) {
+    std::atomic<bool> flag { false };
+    CancellationToken token(flag);
+    const CancellationToken copy = token;
+    EXPECT_FALSE(token.isCancelled());
+    EXPECT_FALSE(copy.isCancelled());
+
+    flag = true;
+    EXPECT_TRUE(token.isCancelled());
+    EXPECT_TRUE(copy.isCancelled());
+}
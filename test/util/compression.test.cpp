@@ -0,0 +1,29 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/compression.hpp>
+
+using namespace mbgl;
+
+TEST(Compression, Decompressor) {
+    const std::string raw(100000, 'x');
+    const std::string compressed = util::compress(raw);
+
+    util::Decompressor decompressor;
+    EXPECT_EQ(raw, *decompressor.decompress(compressed));
+    EXPECT_EQ("foobar", *decompressor.decompress(util::compress("foobar")));
+    EXPECT_EQ(raw, *decompressor.decompress(compressed.data(), compressed.size()));
+    EXPECT_ANY_THROW(decompressor.decompress(compressed.substr(0, compressed.size() / 2)));
+    EXPECT_EQ(raw, *decompressor.decompress(compressed));
+    EXPECT_EQ("", *decompressor.decompress(util::compress("")));
+}
+
+TEST(Compression, DecompressorGzip) {
+    // "foobar", compressed with gzip, whose trailer gives the inflated size.
+    const std::string gzip {
+        "\x1f\x8b\x08\x00\x00\x00\x00\x00\x00\x03\x4b\xcb\xcf\x4f\x4a\x2c\x02\x00"
+        "\x95\x1f\xf6\x9e\x06\x00\x00\x00", 26 };
+
+    util::Decompressor decompressor;
+    EXPECT_EQ("foobar", *decompressor.decompress(gzip));
+    EXPECT_EQ("foobar", util::decompress(gzip));
+}
@@ -0,0 +1,45 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/interned_string.hpp>
+
+using namespace mbgl;
+
+TEST(InternedString, Equality) {
+    StringTable strings;
+    InternedString a = strings.intern("water");
+    InternedString b = strings.intern(std::string("wat") + "er");
+    InternedString c = strings.intern("waterway");
+
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(a.id(), b.id());
+    EXPECT_NE(a, c);
+    EXPECT_EQ(std::hash<InternedString>()(a), std::hash<InternedString>()(b));
+}
+
+TEST(InternedString, Get) {
+    StringTable strings;
+    InternedString a = strings.intern("road-label");
+    const std::string& string = strings.get(a);
+
+    // Interning more strings doesn't move the ones already interned.
+    for (int i = 0; i < 1000; ++i) {
+        strings.intern(std::to_string(i));
+    }
+
+    EXPECT_EQ(&string, &strings.get(a));
+    EXPECT_EQ("road-label", strings.get(a));
+    EXPECT_EQ("", strings.get(strings.intern("")));
+}
+
+TEST(InternedString, Tables) {
+    // Each table numbers its own strings.
+    StringTable first;
+    StringTable second;
+    first.intern("water");
+    InternedString road = second.intern("road");
+
+    EXPECT_EQ("road", second.get(road));
+    EXPECT_EQ(0u, road.id());
+    EXPECT_EQ(1u, first.intern("road").id());
+    EXPECT_EQ("road", first.get(first.intern("road")));
+}
@@ -0,0 +1,71 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/util/parallel_for.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace mbgl;
+
+TEST(ParallelFor, CoversRange) {
+    ThreadPool pool(4);
+
+    std::vector<std::atomic<int>> visits(1000);
+    util::parallelFor(&pool, visits.size(), 7, [&](std::size_t begin, std::size_t end) {
+        EXPECT_LT(begin, end);
+        EXPECT_LE(end - begin, 7u);
+        for (std::size_t i = begin; i < end; ++i) {
+            visits[i]++;
+        }
+    });
+
+    for (auto& count : visits) {
+        EXPECT_EQ(1, count);
+    }
+}
+
+TEST(ParallelFor, Empty) {
+    ThreadPool pool(1);
+    util::parallelFor(&pool, 0, 16, [&](std::size_t, std::size_t) {
+        FAIL();
+    });
+}
+
+TEST(ParallelFor, WithoutScheduler) {
+    const auto thread = std::this_thread::get_id();
+    std::size_t total = 0;
+    util::parallelFor(nullptr, 100, 10, [&](std::size_t begin, std::size_t end) {
+        EXPECT_EQ(thread, std::this_thread::get_id());
+        total += end - begin;
+    });
+    EXPECT_EQ(100u, total);
+}
+
+TEST(ParallelFor, BusyScheduler) {
+    // A pool whose only thread is blocked can't help, so all the work is done by the caller.
+    ThreadPool pool(1);
+    std::mutex mutex;
+
+    struct Blocker {
+        Blocker(ActorRef<Blocker>, std::mutex& mutex_) : mutex(mutex_) {}
+        void block() {
+            std::lock_guard<std::mutex> guard(mutex);
+        }
+        std::mutex& mutex;
+    };
+    Actor<Blocker> blocker(pool, std::ref(mutex));
+    std::unique_lock<std::mutex> lock(mutex);
+    blocker.self().invoke(&Blocker::block);
+
+    std::atomic<std::size_t> total { 0 };
+    util::parallelFor(&pool, 100, 10, [&](std::size_t begin, std::size_t end) {
+        total += end - begin;
+    });
+    EXPECT_EQ(100u, total);
+
+    lock.unlock();
+}